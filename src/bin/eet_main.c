@@ -269,6 +269,67 @@ do_eet_check(const char *file)
    eet_close(ef);
 }
 
+static void
+do_eet_scrub(const char *file)
+{
+   Eet_File *ef;
+   char **list;
+   int bad = 0;
+   int none = 0;
+   int i, num;
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   if (!ef)
+     {
+	ERR("cannot open for reading: %s\n", file);
+	exit(-1);
+     }
+
+   list = eet_list(ef, "*", &num);
+   if (list)
+     {
+	for (i = 0; i < num; i++)
+	  {
+	     switch (eet_checksum_check(ef, list[i]))
+	       {
+		case EET_ERROR_NONE:
+		   break;
+		case EET_ERROR_NOT_CHECKSUMMED:
+		   none++;
+		   break;
+		default:
+		   printf("%s: corrupted\n", list[i]);
+		   bad++;
+		   break;
+	       }
+	  }
+	free(list);
+     }
+
+   printf("%i entries, %i corrupted, %i without checksum\n", num, bad, none);
+
+   eet_close(ef);
+
+   if (bad) exit(-1);
+}
+
+static void
+do_eet_checksum(const char *file)
+{
+   Eet_File *ef;
+
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   if (!ef)
+     {
+	ERR("cannot open for read+write: %s.\n", file);
+	exit(-1);
+     }
+
+   eet_checksum_set(ef, EINA_TRUE);
+
+   eet_close(ef);
+}
+
 static void
 do_eet_sign(const char *file, const char *private_key, const char *public_key)
 {
@@ -322,6 +383,8 @@ main(int argc, char **argv)
 	       "  eet -r FILE.EET KEY                                remove KEY in FILE.EET\n"
 	       "  eet -c FILE.EET                                    report and check the signature information of an eet file\n"
 	       "  eet -s FILE.EET PRIVATE_KEY PUBLIC_KEY             sign FILE.EET with PRIVATE_KEY and attach PUBLIC_KEY as it's certificate\n"
+	       "  eet -t FILE.EET                                    verify the checksum of every entry in FILE.EET\n"
+	       "  eet -T FILE.EET                                    store a checksum of every entry in FILE.EET\n"
 	       );
 	eet_shutdown();
 	return -1;
@@ -374,6 +437,14 @@ main(int argc, char **argv)
      {
 	do_eet_sign(argv[2], argv[3], argv[4]);
      }
+   else if ((!strcmp(argv[1], "-t")) && (argc > 2))
+     {
+	do_eet_scrub(argv[2]);
+     }
+   else if ((!strcmp(argv[1], "-T")) && (argc > 2))
+     {
+	do_eet_checksum(argv[2]);
+     }
    else
      {
 	goto help;
@@ -109,7 +109,9 @@ extern "C" {
        EET_ERROR_NOT_IMPLEMENTED, /**< Function is not implemented */
        EET_ERROR_PRNG_NOT_SEEDED, /**< Could not introduce random seed */
        EET_ERROR_ENCRYPT_FAILED, /**< Could not encrypt contents */
-       EET_ERROR_DECRYPT_FAILED /**< Could not decrypt contents */
+       EET_ERROR_DECRYPT_FAILED, /**< Could not decrypt contents */
+       EET_ERROR_CHECKSUM_FAILED, /**< Contents do not match their checksum */
+       EET_ERROR_NOT_CHECKSUMMED /**< Contents have no checksum */
      } Eet_Error; /**< Eet error identifiers */
 
   /**
@@ -372,6 +374,65 @@ extern "C" {
     */
    EAPI void *eet_read(Eet_File *ef, const char *name, int *size_ret);
 
+   /**
+    * Callback used to get the memory an entry is read into.
+    *
+    * @param data The data pointer given along with the callback.
+    * @param size The number of bytes needed.
+    * @return A pointer to at least @p size bytes, or @c NULL to abort
+    *         the read.
+    *
+    * @see eet_read_alloc()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   typedef void *(*Eet_Read_Alloc_Callback)(void *data, int size);
+
+   /**
+    * Read a specified entry from an eet file into a caller supplied buffer
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param buffer Where to store the data, may be @c NULL.
+    * @param buffer_size The size in bytes of @p buffer.
+    * @return The number of bytes read, 0 for an empty entry, the number
+    *         of bytes needed if @p buffer is too small, or -1 on failure.
+    *
+    * This works like eet_read(), but the data is decompressed directly
+    * into @p buffer instead of a newly allocated block, so that a hot
+    * loop can reuse the same buffer. If the return value is bigger than
+    * @p buffer_size, nothing was read and the call should be done again
+    * with a buffer at least that big.
+    *
+    * @see eet_read()
+    * @see eet_read_cipher_into()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI int eet_read_into(Eet_File *ef, const char *name, void *buffer, int buffer_size);
+
+   /**
+    * Read a specified entry from an eet file using a custom allocator
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param size_ret Number of bytes read from entry and returned.
+    * @param alloc_cb Function called once to get the memory to read into.
+    * @param data Data pointer given to @p alloc_cb.
+    * @return The data stored in that entry in the eet file.
+    *
+    * This works like eet_read(), but the memory holding the returned data
+    * is provided by @p alloc_cb. It is never freed by eet, even on failure,
+    * so it is up to the allocator to reclaim it.
+    *
+    * @see eet_read()
+    * @see eet_read_cipher_alloc()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI void *eet_read_alloc(Eet_File *ef, const char *name, int *size_ret, Eet_Read_Alloc_Callback alloc_cb, void *data);
+
    /**
     * Read a specified entry from an eet file and return data
     * @param ef A valid eet file handle opened for reading.
@@ -487,6 +548,85 @@ extern "C" {
     */
    EAPI int eet_num_entries(Eet_File *ef);
 
+   /**
+    * @enum _Eet_Checksum_Verify
+    * When the checksum of an entry is verified on read.
+    *
+    * @see eet_checksum_verify_set()
+    */
+   typedef enum _Eet_Checksum_Verify
+     {
+       EET_CHECKSUM_VERIFY_OFF, /**< Never verify on read */
+       EET_CHECKSUM_VERIFY_FIRST_TOUCH, /**< Verify an entry the first time it is read from an open file */
+       EET_CHECKSUM_VERIFY_ALWAYS /**< Verify on every read */
+     } Eet_Checksum_Verify;
+
+   /**
+    * Store a CRC32C checksum of every entry when the file is written.
+    *
+    * The checksums cover the stored bytes (after compression and
+    * cipher) and live in a block that older versions of eet skip, so
+    * the file stays readable by them. A file opened in read/write mode
+    * keeps its checksums, if it had any, unless they are disabled
+    * here.
+    *
+    * @param ef A valid eet file handle opened for writing.
+    * @param enabled EINA_TRUE to store checksums, EINA_FALSE to drop them.
+    * @return #EET_ERROR_BAD_OBJECT if @p ef is invalid,
+    *         #EET_ERROR_NOT_WRITABLE if it is read only or
+    *         #EET_ERROR_NONE on success.
+    *
+    * @see eet_checksum_verify_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI Eet_Error eet_checksum_set(Eet_File *ef, Eina_Bool enabled);
+
+   /**
+    * Select when checksummed entries are verified on read.
+    *
+    * A read of an entry that does not match its checksum fails as if
+    * the entry did not exist. The default is
+    * #EET_CHECKSUM_VERIFY_FIRST_TOUCH, entries without a checksum are
+    * never verified.
+    *
+    * @param verify the verification policy, for the whole process.
+    *
+    * @see eet_checksum_check()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI void eet_checksum_verify_set(Eet_Checksum_Verify verify);
+
+   /**
+    * Get the current checksum verification policy.
+    * @return The policy set by eet_checksum_verify_set().
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI Eet_Checksum_Verify eet_checksum_verify_get(void);
+
+   /**
+    * Verify the checksum of an entry, whatever the current policy.
+    *
+    * This only reads the stored bytes, nothing is uncompressed or
+    * deciphered, which makes it cheap enough to scrub a whole file.
+    *
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @return #EET_ERROR_NONE if the entry matches its checksum,
+    *         #EET_ERROR_CHECKSUM_FAILED if it does not,
+    *         #EET_ERROR_NOT_CHECKSUMMED if it has no checksum or
+    *         #EET_ERROR_BAD_OBJECT if the file or entry is invalid.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Group
+    */
+   EAPI Eet_Error eet_checksum_check(Eet_File *ef, const char *name);
+
    /**
     * @defgroup Eet_File_Cipher_Group Eet File Ciphered Main Functions
     *
@@ -523,6 +663,47 @@ extern "C" {
     */
    EAPI void *eet_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key);
 
+   /**
+    * Read a specified entry from an eet file into a caller supplied buffer
+    * using a cipher.
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param buffer Where to store the data, may be @c NULL.
+    * @param buffer_size The size in bytes of @p buffer.
+    * @param cipher_key The key to use as cipher.
+    * @return The number of bytes read, 0 for an empty entry, the number
+    *         of bytes needed if @p buffer is too small, or -1 on failure.
+    *
+    * This works like eet_read_into(). The number of bytes needed is the
+    * size of the clear data, however the entry is stored.
+    *
+    * @see eet_read_into()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Cipher_Group
+    */
+   EAPI int eet_read_cipher_into(Eet_File *ef, const char *name, void *buffer, int buffer_size, const char *cipher_key);
+
+   /**
+    * Read a specified entry from an eet file using a custom allocator and
+    * a cipher.
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param size_ret Number of bytes read from entry and returned.
+    * @param cipher_key The key to use as cipher.
+    * @param alloc_cb Function called once to get the memory to read into.
+    * @param data Data pointer given to @p alloc_cb.
+    * @return The data stored in that entry in the eet file.
+    *
+    * This works like eet_read_alloc().
+    *
+    * @see eet_read_alloc()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Cipher_Group
+    */
+   EAPI void *eet_read_cipher_alloc(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key, Eet_Read_Alloc_Callback alloc_cb, void *data);
+
    /**
     * Write a specified entry to an eet file handle using a cipher.
     * @param ef A valid eet file handle opened for writing.
@@ -640,6 +821,34 @@ extern "C" {
     */
    EAPI void *eet_data_image_read(Eet_File *ef, const char *name, unsigned int *w, unsigned int *h, int *alpha, int *compress, int *quality, int *lossy);
 
+   /**
+    * Read image data from the named key in the eet file into a caller
+    * supplied buffer.
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param d Where to store the pixels, may be @c NULL.
+    * @param buffer_size The size in bytes of @p d.
+    * @param w A pointer to the unsigned int to hold the width in pixels.
+    * @param h A pointer to the unsigned int to hold the height in pixels.
+    * @param alpha A pointer to the int to hold the alpha flag.
+    * @param compress A pointer to the int to hold the compression amount.
+    * @param quality A pointer to the int to hold the quality amount.
+    * @param lossy A pointer to the int to hold the lossiness flag.
+    * @return The size in bytes of the decoded image, or 0 on failure.
+    *
+    * This works like eet_data_image_read(), but the pixels are decoded
+    * into @p d. If the returned size is bigger than @p buffer_size, only
+    * the image parameters are filled and the call should be done again
+    * with a buffer at least that big.
+    *
+    * @see eet_data_image_read()
+    * @see eet_data_image_read_cipher_into()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Image_Group
+    */
+   EAPI int eet_data_image_read_into(Eet_File *ef, const char *name, unsigned int *d, int buffer_size, unsigned int *w, unsigned int *h, int *alpha, int *compress, int *quality, int *lossy);
+
    /**
     * Read image data from the named key in the eet file.
     * @param ef A valid eet file handle opened for reading.
@@ -966,6 +1175,31 @@ extern "C" {
     */
    EAPI void *eet_data_image_read_cipher(Eet_File *ef, const char *name, const char *cipher_key, unsigned int *w, unsigned int *h, int *alpha, int *compress, int *quality, int *lossy);
 
+   /**
+    * Read image data from the named key in the eet file into a caller
+    * supplied buffer using a cipher.
+    * @param ef A valid eet file handle opened for reading.
+    * @param name Name of the entry. eg: "/base/file_i_want".
+    * @param cipher_key The key to use as cipher.
+    * @param d Where to store the pixels, may be @c NULL.
+    * @param buffer_size The size in bytes of @p d.
+    * @param w A pointer to the unsigned int to hold the width in pixels.
+    * @param h A pointer to the unsigned int to hold the height in pixels.
+    * @param alpha A pointer to the int to hold the alpha flag.
+    * @param compress A pointer to the int to hold the compression amount.
+    * @param quality A pointer to the int to hold the quality amount.
+    * @param lossy A pointer to the int to hold the lossiness flag.
+    * @return The size in bytes of the decoded image, or 0 on failure.
+    *
+    * This works like eet_data_image_read_into().
+    *
+    * @see eet_data_image_read_into()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_File_Image_Cipher_Group
+    */
+   EAPI int eet_data_image_read_cipher_into(Eet_File *ef, const char *name, const char *cipher_key, unsigned int *d, int buffer_size, unsigned int *w, unsigned int *h, int *alpha, int *compress, int *quality, int *lossy);
+
    /**
     * Read image data from the named key in the eet file using a cipher.
     * @param ef A valid eet file handle opened for reading.
@@ -1354,6 +1588,55 @@ extern "C" {
     */
    EAPI void eet_identity_certificate_print(const unsigned char *certificate, int der_length, FILE *out);
 
+   /**
+    * Enable or disable the cache of verified signatures.
+    *
+    * When enabled, each successful signature check done by eet_open()
+    * is remembered, keyed by the device, inode, modification time,
+    * change time and size of the file and by the SHA1 fingerprint of
+    * the certificate that signed it. Opening the same unchanged file
+    * again then skips the SHA1 of the whole file and the X.509
+    * verification. Any change to one of those keys invalidates the
+    * entry. On systems without sub-second timestamps, a file rewritten
+    * in place within the same second with the same size is not
+    * noticed, so this is meant for archives that are not rewritten in
+    * place.
+    *
+    * The cache is disabled by default and is flushed by eet_shutdown().
+    * Disabling it also flushes it.
+    *
+    * @param enabled EINA_TRUE to enable the cache, EINA_FALSE to disable it.
+    * @return EINA_TRUE on success, EINA_FALSE if signature support
+    *         was not compiled in.
+    *
+    * @see eet_identity_cache_file_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Cipher_Group
+    */
+   EAPI Eina_Bool eet_identity_cache_set(Eina_Bool enabled);
+
+   /**
+    * Store the cache of verified signatures on disk.
+    *
+    * Entries already present in @p path are loaded and every new
+    * successful verification is appended to it, so processes that
+    * restart often do not have to verify the same archives again.
+    * Anybody able to write @p path can make eet accept a tampered
+    * file, so it must be protected at least as well as the archives
+    * themselves. This implies eet_identity_cache_set(EINA_TRUE).
+    *
+    * @param path the file to use, or @c NULL to stop using it.
+    * @return EINA_TRUE on success, EINA_FALSE if @p path could not be
+    *         used or signature support was not compiled in.
+    *
+    * @see eet_identity_cache_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Cipher_Group
+    */
+   EAPI Eina_Bool eet_identity_cache_file_set(const char *path);
+
 
    /**
     * @defgroup Eet_Data_Group Eet Data Serialization
@@ -1382,6 +1665,10 @@ extern "C" {
     * quite cumbersome, so we provide lots of macros and convenience
     * functions to aid creating the types.
     *
+    * Decoding never modifies a descriptor, so once all its members are
+    * added and its flags set, one descriptor can decode data from any
+    * number of threads and files at the same time.
+    *
     * Example:
     *
     * @code
@@ -1782,6 +2069,188 @@ extern "C" {
     */
    EAPI void eet_data_descriptor_free(Eet_Data_Descriptor *edd);
 
+   /**
+    * Switch a data descriptor to the compact encoding.
+    * @param edd The data descriptor.
+    * @param compact EINA_TRUE to encode compactly, EINA_FALSE for the
+    *        default tagged encoding.
+    *
+    * By default every member is stored with its name, its type and its
+    * size, so it can be decoded by any version of the descriptor. With the
+    * compact encoding, basic members are stored one after the other with
+    * no name, integers as variable length numbers and floats as raw IEEE
+    * values, prefixed once by a hash of the descriptor members. Lists,
+    * hashes, arrays, unions, variants and sub structs are still stored
+    * tagged. This makes small numeric structs a lot smaller and faster to
+    * decode.
+    *
+    * Decoding accepts both encodings whatever this setting. Compact data
+    * can only be decoded by a descriptor with the same name and the same
+    * members, declared in the same order, or one the previous version was
+    * registered on with eet_data_descriptor_previous_add(): other
+    * descriptors refuse it rather than misread it, and so do
+    * eet_data_dump() and the Eet_Node functions, which have no descriptor.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_descriptor_compact_set(Eet_Data_Descriptor *edd, Eina_Bool compact);
+
+   /**
+    * Tell if a data descriptor uses the compact encoding.
+    * @param edd The data descriptor.
+    * @return EINA_TRUE if it does.
+    *
+    * @see eet_data_descriptor_compact_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_descriptor_compact_get(const Eet_Data_Descriptor *edd);
+
+   /**
+    * Store lists and arrays of the structs of a data descriptor by columns.
+    * @param edd The data descriptor of the list or array items.
+    * @param columnar EINA_TRUE to store them by columns, EINA_FALSE to
+    *        store each item as a tagged struct, the default.
+    *
+    * A list, variable array or fixed array of structs described by @p edd
+    * is then written as a single chunk holding one column per basic
+    * member: integers are delta or run length encoded, strings go through
+    * a dictionary of their distinct values and floats are stored as raw
+    * IEEE values. Members that aren't basic types are still written
+    * tagged, in one last column. Long lists of small records get a lot
+    * smaller, and a descriptor declaring only some of the members only
+    * decodes their columns, skipping the others whole.
+    *
+    * Columns are found by member name, so any descriptor with the same
+    * member names and compatible types can decode them. eet_data_dump()
+    * and the Eet_Node functions, which have no descriptor, refuse them.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_descriptor_columnar_set(Eet_Data_Descriptor *edd, Eina_Bool columnar);
+
+   /**
+    * Tell if lists and arrays of the structs of a data descriptor are
+    * stored by columns.
+    * @param edd The data descriptor.
+    * @return EINA_TRUE if they are.
+    *
+    * @see eet_data_descriptor_columnar_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_descriptor_columnar_get(const Eet_Data_Descriptor *edd);
+
+   /**
+    * Let a data descriptor read compact data written by an older version.
+    * @param edd The data descriptor of the current version.
+    * @param previous A descriptor built like the one the data was written
+    *        with. It must have the same name, its members the same names,
+    *        types and order, their offsets don't matter.
+    * @return EINA_TRUE on success, EINA_FALSE if @p previous has another
+    *         name or memory runs out.
+    *
+    * Compact data only records a fingerprint of the members of the
+    * descriptor that wrote it. Once the descriptor of a previous version is
+    * registered, @p edd maps its members to its own by name, and decodes
+    * data with that fingerprint through this table at the same speed as
+    * its own data. Members that were removed, or whose type changed in a
+    * way that loses information, are skipped. Integers are widened to a
+    * larger integer type of the same sign, or a larger signed one, and
+    * #EET_T_FLOAT to #EET_T_DOUBLE. Members that are new are left as the
+    * descriptor mem_alloc returned them, zeroed by default.
+    *
+    * The table is kept by @p edd, @p previous can be freed afterward. Like
+    * element adding, this must not be done while @p edd is used by another
+    * thread.
+    *
+    * Tagged data, written without eet_data_descriptor_compact_set(), needs
+    * no registration, the same widening applies to it.
+    *
+    * @see eet_data_descriptor_compact_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_descriptor_previous_add(Eet_Data_Descriptor *edd, const Eet_Data_Descriptor *previous);
+
+   /**
+    * Store the float and double members of a descriptor as IEEE 754 bits.
+    * @param edd The data descriptor to change.
+    * @param ieee EINA_TRUE to write the raw IEEE 754 value of #EET_T_FLOAT
+    *        and #EET_T_DOUBLE members, EINA_FALSE to write them as text
+    *        (the default).
+    *
+    * By default, floating point values are written as text, in the file
+    * dictionary when there is one, and parsed back when decoding. With
+    * this set, they take 4 or 8 bytes in little endian and decode without
+    * any conversion or lookup. Lists and hashes of floating point values
+    * added to @p edd follow the setting, descriptors used for sub
+    * structures keep their own.
+    *
+    * Decoding accepts both encodings whatever the setting, but eet versions
+    * prior to 1.4.0 can't read data written with it.
+    *
+    * @see eet_data_descriptor_float_ieee_get()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_descriptor_float_ieee_set(Eet_Data_Descriptor *edd, Eina_Bool ieee);
+
+   /**
+    * Tell if a descriptor stores floating point members as IEEE 754 bits.
+    * @param edd The data descriptor to query.
+    * @return EINA_TRUE if eet_data_descriptor_float_ieee_set() enabled it.
+    *
+    * @see eet_data_descriptor_float_ieee_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_descriptor_float_ieee_get(const Eet_Data_Descriptor *edd);
+
+   /**
+    * Make eet_data_read() return strings borrowed from the file.
+    * @param edd The data descriptor to change.
+    * @param borrow EINA_TRUE to borrow strings, EINA_FALSE to copy them
+    *        with the descriptor str_alloc callbacks (the default).
+    *
+    * When @p edd is given to eet_data_read() or eet_data_read_cipher() on a
+    * file opened with #EET_FILE_MODE_READ, every string of the decoded
+    * data, from the dictionary or inlined, and in sub structures too, is a
+    * const char pointer inside the file instead of a copy. None of them go
+    * through str_alloc, so they must not be released with str_free.
+    *
+    * To keep them valid, each successful read takes a reference on the
+    * file: call eet_close() once more when done with the returned data.
+    * Compressed or ciphered entries are kept in memory until then.
+    *
+    * eet_data_descriptor_decode() and other reads still copy strings.
+    *
+    * @see eet_data_descriptor_borrow_get()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_descriptor_borrow_set(Eet_Data_Descriptor *edd, Eina_Bool borrow);
+
+   /**
+    * Tell if eet_data_read() borrows strings for a descriptor.
+    * @param edd The data descriptor to query.
+    * @return EINA_TRUE if eet_data_descriptor_borrow_set() enabled it.
+    *
+    * @see eet_data_descriptor_borrow_set()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_descriptor_borrow_get(const Eet_Data_Descriptor *edd);
+
    /**
     * This function is an internal used by macros.
     *
@@ -1805,6 +2274,10 @@ extern "C" {
     * @param counter_name variable that defines the name of number of elements.
     * @param subtype If contains a subtype, then its data descriptor.
     *
+    * Arrays (#EET_G_ARRAY or #EET_G_VAR_ARRAY) of char, short, int, long
+    * long, float or double, signed or not, are stored as one packed block
+    * of values since 1.4.0. Arrays written by older versions still decode.
+    *
     * @since 1.0.0
     * @ingroup Eet_Data_Group
     */
@@ -1875,6 +2348,10 @@ extern "C" {
     * dumpdata as a parameter as well as a string with new text to be
     * appended.
     *
+    * Unions and variants can't be dumped. When one is met this function
+    * returns 0, but the text generated up to that point has already been
+    * passed to @p dumpfunc, so the caller should discard it.
+    *
     * Example:
     *
     * @code
@@ -1921,6 +2398,9 @@ extern "C" {
     * in-memory data struct and encodes into a binary blob. @p text is a normal
     * C string.
     *
+    * Text that doesn't parse makes it return NULL, the line and column of
+    * the first error are logged.
+    *
     * @see eet_data_text_undump_cipher()
     *
     * @since 1.0.0
@@ -1977,6 +2457,57 @@ extern "C" {
     */
    EAPI int eet_data_undump(Eet_File *ef, const char *name, const char *text, int textlen, int compress);
 
+   /**
+    * Dump an eet encoded data structure into json text
+    * @param data_in The pointer to the data to decode into a struct.
+    * @param size_in The size of the data pointed to in bytes.
+    * @param dumpfunc The function to call passed a string when new
+    *        data is converted to text
+    * @param dumpdata The data to pass to the @p dumpfunc callback.
+    * @return 1 on success, 0 on failure
+    *
+    * Like eet_data_text_dump(), but the text is json. Every value is an
+    * object naming its type the way the text dump does, so it keeps all
+    * that is needed to encode it back with eet_data_json_undump():
+    *
+    * @code
+    * {"struct": {"Example": {
+    *     "name": {"string": "foo"},
+    *     "values": {"array": [{"int": 1}, {"null": null}, {"int": 3}]},
+    *     "props": {"hash": {"key": {"double": 0.5}}}
+    * }}}
+    * @endcode
+    *
+    * Floats and doubles that aren't finite are written as the strings
+    * "nan", "inf" and "-inf".
+    *
+    * @see eet_data_json_dump_cipher()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI int eet_data_json_dump(const void *data_in, int size_in, void (*dumpfunc) (void *data, const char *str), void *dumpdata);
+
+   /**
+    * Take a json encoding from eet_data_json_dump() and re-encode in binary.
+    * @param text The pointer to the string data to parse and encode.
+    * @param textlen The size of the string in bytes (not including 0
+    *        byte terminator).
+    * @param size_ret This gets filled in with the encoded data blob
+    *        size in bytes.
+    * @return The encoded data on success, NULL on failure.
+    *
+    * Like eet_data_text_undump(), the data is encoded while the text is
+    * read. Text that doesn't parse makes it return NULL, the line and
+    * column of the first error are logged.
+    *
+    * @see eet_data_json_undump_cipher()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void *eet_data_json_undump(const char *text, int textlen, int *size_ret);
+
    /**
     * Decode a data structure from an arbitary location in memory.
     * @param edd The data  descriptor to use when decoding.
@@ -2037,6 +2568,390 @@ extern "C" {
     */
    EAPI void *eet_data_descriptor_encode(Eet_Data_Descriptor *edd, const void *data_in, int *size_ret);
 
+   /**
+    * @typedef Eet_Data_Stream
+    * Opaque growable buffer that encoded data can be appended to.
+    *
+    * Reusing one stream across many eet_data_descriptor_encode_stream()
+    * calls avoids allocating and growing a buffer for every encode.
+    *
+    * @see eet_data_stream_new()
+    * @see eet_data_descriptor_encode_stream()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   typedef struct _Eet_Data_Stream Eet_Data_Stream;
+
+   /**
+    * Create an empty stream to encode data in.
+    * @return A new stream, to be freed with eet_data_stream_free().
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Stream *eet_data_stream_new(void);
+
+   /**
+    * Free a stream and its content.
+    * @param ds The stream to free.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_stream_free(Eet_Data_Stream *ds);
+
+   /**
+    * Empty a stream, keeping its memory for the next encodes.
+    * @param ds The stream to empty.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_stream_reset(Eet_Data_Stream *ds);
+
+   /**
+    * Get the content of a stream.
+    * @param ds The stream.
+    * @param size_ret Where to store the size in bytes of the content.
+    * @return The content, owned by the stream and only valid until its
+    *         next modification.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI const void *eet_data_stream_data_get(const Eet_Data_Stream *ds, int *size_ret);
+
+   /**
+    * Encode a data struct at the end of a stream.
+    * @param edd The data descriptor to use when encoding.
+    * @param data_in The pointer to the struct to encode into data.
+    * @param ds The stream to append the encoded data to.
+    * @return The number of bytes appended, 0 on failure.
+    *
+    * The appended bytes are exactly what eet_data_descriptor_encode()
+    * would return, without the allocation. Several structs can be
+    * encoded one after the other and the stream emptied with
+    * eet_data_stream_reset() once its content has been used.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI int eet_data_descriptor_encode_stream(Eet_Data_Descriptor *edd, const void *data_in, Eet_Data_Stream *ds);
+
+   /**
+    * @typedef Eet_Data_Arena
+    * Opaque memory pool that whole decoded data structures are allocated
+    * from.
+    *
+    * Decoding through an arena bypasses the descriptor mem_alloc, str_alloc
+    * and str_direct_alloc callbacks: every struct, array and string is
+    * carved out of a few large blocks owned by the arena, and strings point
+    * into the file whenever they can. Lists and hashes are still built with
+    * the descriptor list_append and hash_add callbacks and are given back to
+    * list_free and hash_free when the arena goes away. Everything decoded
+    * into an arena is released at once by eet_data_arena_free(), nothing of
+    * it must be freed on its own, and the descriptors used must stay valid
+    * until then.
+    *
+    * An arena is not thread safe.
+    *
+    * @see eet_data_read_arena()
+    * @see eet_data_descriptor_decode_arena()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   typedef struct _Eet_Data_Arena Eet_Data_Arena;
+
+   /**
+    * Create an empty arena to decode data in.
+    * @return A new arena, to be freed with eet_data_arena_free().
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Arena *eet_data_arena_new(void);
+
+   /**
+    * Free an arena and every data structure decoded in it.
+    * @param arena The arena to free.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_arena_free(Eet_Data_Arena *arena);
+
+   /**
+    * Read a data structure from an eet file into an arena.
+    * @param ef The eet file handle to read from.
+    * @param edd The data descriptor handle to use when decoding.
+    * @param name The key the data is stored under in the eet file.
+    * @param arena The arena to allocate the data structure from.
+    * @return A pointer to the decoded data structure.
+    *
+    * This works like eet_data_read(), except that the result is owned by
+    * @p arena. Strings may point straight into @p ef, which must then stay
+    * open, and @p name left unchanged, until the arena is freed.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void *eet_data_read_arena(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, Eet_Data_Arena *arena);
+
+   /**
+    * Decode a data structure from an arbitrary location in memory into an
+    * arena.
+    * @param edd The data descriptor to use when decoding.
+    * @param data_in The pointer to the data to decode into a struct.
+    * @param size_in The size of the data pointed to in bytes.
+    * @param arena The arena to allocate the data structure from.
+    * @return NULL on failure, or a valid decoded struct pointer on success.
+    *
+    * This works like eet_data_descriptor_decode(), except that the result
+    * is owned by @p arena. Strings are copied, @p data_in can be released
+    * as soon as this returns.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void *eet_data_descriptor_decode_arena(Eet_Data_Descriptor *edd, const void *data_in, int size_in, Eet_Data_Arena *arena);
+
+   /**
+    * @typedef Eet_Data_Lazy
+    * Handle on a data structure decoded without its containers.
+    *
+    * A lazy decode only fills the simple members of the outer structure.
+    * Its lists, hashes, variable arrays and sub structures are left NULL
+    * and only the location of their encoded data is remembered, so that
+    * reading a few fields of a large structure costs little more than
+    * finding them. Each one is decoded on request with
+    * eet_data_lazy_member_decode(), in place in the structure.
+    *
+    * The structure and everything decoded in it belong to the caller, as
+    * with eet_data_read(), and survive eet_data_lazy_free(). The
+    * descriptors used must stay valid as long as the handle.
+    *
+    * @see eet_data_read_lazy()
+    * @see eet_data_descriptor_decode_lazy()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   typedef struct _Eet_Data_Lazy Eet_Data_Lazy;
+
+   /**
+    * Read a data structure from an eet file, leaving its containers out.
+    * @param ef The eet file handle to read from.
+    * @param edd The data descriptor handle to use when decoding.
+    * @param name The key the data is stored under in the eet file.
+    * @return A handle on the structure, or NULL on failure.
+    *
+    * The handle keeps a reference on @p ef, dropped by
+    * eet_data_lazy_free().
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Lazy *eet_data_read_lazy(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name);
+
+   /**
+    * Decode a data structure from memory, leaving its containers out.
+    * @param edd The data descriptor to use when decoding.
+    * @param data_in The pointer to the data to decode into a struct.
+    * @param size_in The size of the data pointed to in bytes.
+    * @return A handle on the structure, or NULL on failure.
+    *
+    * @p data_in is not copied, it must stay valid until the handle is
+    * freed.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Lazy *eet_data_descriptor_decode_lazy(Eet_Data_Descriptor *edd, const void *data_in, int size_in);
+
+   /**
+    * Get the structure a lazy handle decodes into.
+    * @param lazy The lazy handle.
+    * @return The decoded structure.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void *eet_data_lazy_data_get(const Eet_Data_Lazy *lazy);
+
+   /**
+    * Decode a member left out by a lazy decode.
+    * @param lazy The lazy handle.
+    * @param member The name the member was added to the descriptor with.
+    * @return EINA_TRUE once the member is decoded, EINA_FALSE on error.
+    *
+    * The member is decoded completely and stored in the structure, it is
+    * then up to the caller. Asking again for it, or for a member that was
+    * decoded from the start, does nothing. After a failure, the member is
+    * left empty.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_lazy_member_decode(Eet_Data_Lazy *lazy, const char *member);
+
+   /**
+    * Free a lazy handle.
+    * @param lazy The lazy handle.
+    *
+    * The decoded structure is not freed, members that were never decoded
+    * stay empty.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_lazy_free(Eet_Data_Lazy *lazy);
+
+   /**
+    * @typedef Eet_Data_Block
+    * Many structs of one descriptor kept in a single entry.
+    *
+    * Storing many small records, a log for instance, with one
+    * eet_data_write() each gives every one of them its own entry, name
+    * and compression. A record block encodes them one after the other
+    * in one entry, with an index of where each record is. The entry is
+    * compressed as a whole, so what the records have in common is only
+    * paid for once, and any record can be decoded on its own once it is
+    * read.
+    *
+    * A block is either created empty with eet_data_block_new() to be
+    * filled and written, or read from a file with eet_data_block_read().
+    * Either way it keeps a reference on its file, dropped by
+    * eet_data_block_free(), and the descriptor must stay valid as long as
+    * the block.
+    *
+    * @see eet_data_block_new()
+    * @see eet_data_block_read()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   typedef struct _Eet_Data_Block Eet_Data_Block;
+
+   /**
+    * @typedef Eet_Data_Block_Cb
+    * Called by eet_data_block_foreach() with each record, decoded in
+    * @p data that then belongs to the callback. Returning EINA_FALSE
+    * stops the iteration.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   typedef Eina_Bool Eet_Data_Block_Cb(const Eet_Data_Block *block, int index, void *data, void *fdata);
+
+   /**
+    * Create an empty record block to write in an eet file.
+    * @param ef The eet file handle, open for writing.
+    * @param edd The data descriptor of the records.
+    * @return A new block, to be freed with eet_data_block_free().
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Block *eet_data_block_new(Eet_File *ef, Eet_Data_Descriptor *edd);
+
+   /**
+    * Encode a struct at the end of a record block.
+    * @param block A block made by eet_data_block_new().
+    * @param data The struct to encode.
+    * @return EINA_TRUE if the record was added, EINA_FALSE on failure.
+    *
+    * The struct is encoded right away, it can be changed or freed once
+    * this returns.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_block_append(Eet_Data_Block *block, const void *data);
+
+   /**
+    * Store the records of a block in its eet file.
+    * @param block A block made by eet_data_block_new().
+    * @param name The key to store the records under in the eet file.
+    * @param compress Compression flags for storage.
+    * @return bytes written on successful write, 0 on failure.
+    *
+    * The block keeps its records, more can be appended and the block
+    * written again.
+    *
+    * @see eet_data_block_write_cipher()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI int eet_data_block_write(Eet_Data_Block *block, const char *name, int compress);
+
+   /**
+    * Read a record block from an eet file.
+    * @param ef The eet file handle to read from.
+    * @param edd The data descriptor of the records.
+    * @param name The key the records are stored under in the eet file.
+    * @return A block, to be freed with eet_data_block_free(), or NULL if
+    *         the entry is not a record block.
+    *
+    * Only the index is decoded, records are decoded on request with
+    * eet_data_block_record_get() or eet_data_block_foreach(). Records can
+    * not be appended to a block that was read.
+    *
+    * @see eet_data_block_read_cipher()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eet_Data_Block *eet_data_block_read(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name);
+
+   /**
+    * Get the number of records in a block.
+    * @param block The block.
+    * @return The number of records.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI int eet_data_block_count_get(const Eet_Data_Block *block);
+
+   /**
+    * Decode one record of a block.
+    * @param block The block.
+    * @param index The position of the record, from 0.
+    * @return The decoded struct, that belongs to the caller as with
+    *         eet_data_read(), or NULL on failure.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void *eet_data_block_record_get(const Eet_Data_Block *block, int index);
+
+   /**
+    * Decode the records of a block in order.
+    * @param block The block.
+    * @param func The function given each decoded record.
+    * @param fdata The data to pass to @p func.
+    * @return EINA_FALSE if a record could not be decoded, EINA_TRUE
+    *         otherwise.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI Eina_Bool eet_data_block_foreach(const Eet_Data_Block *block, Eet_Data_Block_Cb *func, void *fdata);
+
+   /**
+    * Free a record block.
+    * @param block The block to free.
+    *
+    * Records already decoded from it are not freed.
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Group
+    */
+   EAPI void eet_data_block_free(Eet_Data_Block *block);
+
    /**
     * Add a basic data element to a data descriptor.
     * @param edd The data descriptor to add the type to.
@@ -2338,6 +3253,37 @@ extern "C" {
     */
    EAPI int eet_data_write_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key, const void *data, int compress);
 
+   /**
+    * Store the records of a block in its eet file using a cipher.
+    * @param block A block made by eet_data_block_new().
+    * @param name The key to store the records under in the eet file.
+    * @param cipher_key The key to use as cipher.
+    * @param compress Compression flags for storage.
+    * @return bytes written on successful write, 0 on failure.
+    *
+    * @see eet_data_block_write()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Cipher_Group
+    */
+   EAPI int eet_data_block_write_cipher(Eet_Data_Block *block, const char *name, const char *cipher_key, int compress);
+
+   /**
+    * Read a record block from an eet file using a cipher.
+    * @param ef The eet file handle to read from.
+    * @param edd The data descriptor of the records.
+    * @param name The key the records are stored under in the eet file.
+    * @param cipher_key The key to use as cipher.
+    * @return A block, to be freed with eet_data_block_free(), or NULL if
+    *         the entry is not a record block.
+    *
+    * @see eet_data_block_read()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Cipher_Group
+    */
+   EAPI Eet_Data_Block *eet_data_block_read_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key);
+
    /**
     * Dump an eet encoded data structure into ascii text using a cipher.
     * @param data_in The pointer to the data to decode into a struct.
@@ -2356,6 +3302,10 @@ extern "C" {
     * dumpdata as a parameter as well as a string with new text to be
     * appended.
     *
+    * Unions and variants can't be dumped. When one is met this function
+    * returns 0, but the text generated up to that point has already been
+    * passed to @p dumpfunc, so the caller should discard it.
+    *
     * Example:
     *
     * @code
@@ -2411,6 +3361,41 @@ extern "C" {
     */
    EAPI void *eet_data_text_undump_cipher(const char *text, const char *cipher_key, int textlen, int *size_ret);
 
+   /**
+    * Dump an eet encoded data structure into json text using a cipher.
+    * @param data_in The pointer to the data to decode into a struct.
+    * @param cipher_key The key to use as cipher.
+    * @param size_in The size of the data pointed to in bytes.
+    * @param dumpfunc The function to call passed a string when new
+    *        data is converted to text
+    * @param dumpdata The data to pass to the @p dumpfunc callback.
+    * @return 1 on success, 0 on failure
+    *
+    * @see eet_data_json_dump()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Cipher_Group
+    */
+   EAPI int eet_data_json_dump_cipher(const void *data_in, const char *cipher_key, int size_in, void (*dumpfunc) (void *data, const char *str), void *dumpdata);
+
+   /**
+    * Take a json encoding from eet_data_json_dump() and re-encode
+    * in binary using a cipher.
+    * @param text The pointer to the string data to parse and encode.
+    * @param cipher_key The key to use as cipher.
+    * @param textlen The size of the string in bytes (not including 0
+    *        byte terminator).
+    * @param size_ret This gets filled in with the encoded data blob
+    *        size in bytes.
+    * @return The encoded data on success, NULL on failure.
+    *
+    * @see eet_data_json_undump()
+    *
+    * @since 1.4.0
+    * @ingroup Eet_Data_Cipher_Group
+    */
+   EAPI void *eet_data_json_undump_cipher(const char *text, const char *cipher_key, int textlen, int *size_ret);
+
    /**
     * Dump an eet encoded data structure from an eet file into ascii
     * text using a cipher.
@@ -2770,6 +3755,81 @@ extern "C" {
 
    EAPI void *eet_node_walk(void *parent, const char *name, Eet_Node *root, Eet_Node_Walk *cb, void *user_data);
 
+  /**
+   * @typedef Eet_Data_Walk
+   * Callbacks called while walking encoded data.
+   */
+   typedef struct _Eet_Data_Walk             Eet_Data_Walk;
+
+  /**
+   * @struct _Eet_Data_Walk
+   * Callbacks called while walking encoded data, see
+   * eet_data_walk_decode_cipher(). Any of them can be NULL, and returning
+   * EINA_FALSE from one stops the walk.
+   *
+   * @p name is the member name, NULL for the outer structure. @p
+   * group_type is #EET_G_UNKNOWN for a plain member, or the group the
+   * value or structure is an item of. @p key is the key of hash items, the
+   * type name of unions and variants, NULL otherwise. @p type is the name
+   * of the descriptor a structure was encoded with, NULL for a variant
+   * holding a group.
+   *
+   * Simple values come with their #EET_T_CHAR to #EET_T_NULL type, fixed
+   * point ones as #EET_T_DOUBLE. Strings point in the data or in the file
+   * dictionary and are only valid during the call.
+   */
+   struct _Eet_Data_Walk
+   {
+      Eina_Bool (*struct_begin)(const char *name, int group_type, const char *key, const char *type, void *user_data);
+      Eina_Bool (*struct_end)(const char *name, void *user_data);
+      Eina_Bool (*array_begin)(Eina_Bool variable, const char *name, int count, void *user_data);
+      Eina_Bool (*array_end)(const char *name, void *user_data);
+      Eina_Bool (*simple)(const char *name, int group_type, const char *key, int type, Eet_Node_Data *data, void *user_data);
+   };
+
+  /**
+   * Walk encoded data without decoding it.
+   * @param data_in The encoded data.
+   * @param cipher_key The key to decipher it with, or NULL.
+   * @param size_in The size of @p data_in.
+   * @param cb The callbacks to call.
+   * @param user_data Passed to the callbacks.
+   * @return EINA_TRUE if all the data was walked, EINA_FALSE if it is
+   *         invalid or a callback stopped the walk.
+   *
+   * The chunks are reported in the order they are stored, as they are
+   * read: no structure, #Eet_Node or string is allocated, so the walk
+   * is bounded by the size of the data. Members of a structure are
+   * reported between its struct_begin and struct_end, list and hash items
+   * one by one with the group they belong to, array items between
+   * array_begin and array_end. Data written with
+   * eet_data_descriptor_compact_set() or eet_data_descriptor_columnar_set()
+   * can't be walked.
+   *
+   * @see eet_data_walk_read_cipher()
+   *
+   * @since 1.4.0
+   * @ingroup Eet_Node_Group
+   */
+   EAPI Eina_Bool eet_data_walk_decode_cipher(const void *data_in, const char *cipher_key, int size_in, Eet_Data_Walk *cb, void *user_data);
+
+  /**
+   * Walk data stored in a file without decoding it.
+   * @param ef The file to read from.
+   * @param name The name of the entry.
+   * @param cipher_key The key to decipher it with, or NULL.
+   * @param cb The callbacks to call.
+   * @param user_data Passed to the callbacks.
+   * @return EINA_TRUE if all the data was walked, EINA_FALSE otherwise.
+   *
+   * Like eet_data_walk_decode_cipher(), uncompressed and unciphered
+   * entries are walked right in the mapped file.
+   *
+   * @since 1.4.0
+   * @ingroup Eet_Node_Group
+   */
+   EAPI Eina_Bool eet_data_walk_read_cipher(Eet_File *ef, const char *name, const char *cipher_key, Eet_Data_Walk *cb, void *user_data);
+
   /*******/
 
   /**
@@ -109,21 +109,67 @@ Eina_Bool        eet_dictionary_string_get_double(const Eet_Dictionary *ed, int
 Eina_Bool        eet_dictionary_string_get_fp(const Eet_Dictionary *ed, int index, Eina_F32p32 *result);
 int              eet_dictionary_string_get_hash(const Eet_Dictionary *ed, int index);
 
+/* Take a reference on ef for data borrowing from it, the file keeps buffer
+ * (if any) alive until that reference is released with eet_close(). */
+void  eet_file_borrow(Eet_File *ef, void *buffer);
+
 int   _eet_hash_gen(const char *key, int hash_size);
 
+#ifdef HAVE_BUILTIN_BSWAP
+# define EET_BSWAP32(x) __builtin_bswap32(x)
+# define EET_BSWAP64(x) __builtin_bswap64(x)
+#else
+# define EET_BSWAP32(x) \
+   ((((unsigned int)(x) & 0x000000ffU) << 24) | \
+    (((unsigned int)(x) & 0x0000ff00U) << 8) | \
+    (((unsigned int)(x) & 0x00ff0000U) >> 8) | \
+    (((unsigned int)(x) & 0xff000000U) >> 24))
+# define EET_BSWAP64(x) \
+   ((((unsigned long long)EET_BSWAP32((unsigned int)(x))) << 32) | \
+    ((unsigned long long)EET_BSWAP32((unsigned int)((unsigned long long)(x) >> 32))))
+#endif
+#define EET_BSWAP16(x) \
+   ((unsigned short)((((unsigned short)(x) & 0x00ff) << 8) | \
+		     (((unsigned short)(x) & 0xff00) >> 8)))
+
+/* byte swap count values from src to dst, which may be the same buffer */
+void  eet_swap16(void *dst, const void *src, unsigned int count);
+void  eet_swap32(void *dst, const void *src, unsigned int count);
+void  eet_swap64(void *dst, const void *src, unsigned int count);
+void  eet_crc32c_init(void);
+unsigned int eet_crc32c(const void *data, unsigned int length);
+
 const void* eet_identity_check(const void *data_base, unsigned int data_length,
 			       void **sha1, int *sha1_length,
 			       const void *signature_base, unsigned int signature_length,
 			       const void **raw_signature_base, unsigned int *raw_signature_length,
 			       int *x509_length);
+const void* eet_identity_parse(const void *signature_base, unsigned int signature_length,
+			       const void **raw_signature_base, unsigned int *raw_signature_length,
+			       int *x509_length);
 void *eet_identity_compute_sha1(const void *data_base, unsigned int data_length,
 				int *sha1_length);
+/* the SHA1 of a file whose signature starts after signed_length bytes, as
+ * eet_identity_check() computes it */
+void *eet_identity_file_sha1(const void *data_base, unsigned int data_length,
+			     unsigned int signed_length, int *sha1_length);
 Eet_Error eet_cipher(const void *data, unsigned int size, const char *key, unsigned int length, void **result, unsigned int *result_length);
 Eet_Error eet_decipher(const void *data, unsigned int size, const char *key, unsigned int length, void **result, unsigned int *result_length);
+
+/* Called with each slice of clear data, total is the full clear data length. */
+typedef Eina_Bool (*Eet_Decipher_Cb)(void *data, const void *clear, unsigned int clear_length, unsigned int total);
+Eet_Error eet_decipher_stream(const void *data, unsigned int size, const char *key, unsigned int length, Eet_Decipher_Cb cb, void *cb_data);
+void eet_cipher_context_init(void);
+void eet_cipher_context_shutdown(void);
 Eet_Error eet_identity_sign(FILE *fp, Eet_Key *key);
 void eet_identity_unref(Eet_Key *key);
 void eet_identity_ref(Eet_Key *key);
 
+/* group and value type names written by eet_node_dump(), and by the
+ * data dump that streams the same text */
+extern const char *_eet_node_dump_g_name[6];
+extern const char *_eet_node_dump_t_name[14][2];
+
 void eet_node_shutdown(void);
 int eet_node_init(void);
 Eet_Node *eet_node_new(void);
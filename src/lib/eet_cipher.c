@@ -65,11 +65,18 @@ void *alloca (size_t);
 # endif
 #endif
 
+#ifdef EFL_HAVE_PTHREAD
+# include <pthread.h>
+#endif
+
 #include "Eet.h"
 #include "Eet_private.h"
 
 #define EET_MAGIC_SIGN 0x1ee74271
 
+/* Clear data is handed out by slices of that size, a multiple of 32 */
+#define EET_DECIPHER_WINDOW 16384
+
 #ifdef HAVE_GNUTLS
 # define MAX_KEY_LEN 32
 # define MAX_IV_LEN 16
@@ -79,10 +86,48 @@ void *alloca (size_t);
 #endif
 
 #ifdef HAVE_CIPHER
+typedef struct _Eet_Cipher_Context Eet_Cipher_Context;
+
+/* Per thread state reused by all cipher operations of that thread. The HMAC
+   stays keyed with the last used key, which is kept to detect a change. The
+   scratch buffer is wiped after each operation. */
+struct _Eet_Cipher_Context
+{
+   /* all the contexts, so eet_shutdown() can wipe those of other threads */
+   Eet_Cipher_Context   *next;
+   Eet_Cipher_Context   *prev;
+
+   char                 *key;
+   unsigned int          key_length;
+
+   unsigned char        *buffer;
+   unsigned int          buffer_size;
+
 # ifdef HAVE_GNUTLS
-static Eet_Error eet_hmac_sha1(const void *key, size_t key_len, const void *data, size_t data_len, unsigned char *res);
+   gcry_cipher_hd_t      cipher;
+   gcry_md_hd_t          hmac;
+# else
+   EVP_CIPHER_CTX        cipher;
+   HMAC_CTX              hmac;
+# endif
+};
+
+static Eet_Cipher_Context *eet_cipher_context_get(const char *key, unsigned int length);
+static void eet_cipher_context_free(void *data);
+static void eet_cipher_context_destroy(Eet_Cipher_Context *ctx);
+static unsigned char *eet_cipher_context_buffer_get(Eet_Cipher_Context *ctx, unsigned int size);
+static void eet_cipher_context_buffer_wipe(Eet_Cipher_Context *ctx, unsigned int used);
+static void eet_hmac_sha1(Eet_Cipher_Context *ctx, const void *data, size_t data_len, unsigned char *res);
+static Eet_Error eet_pbkdf2_sha1(Eet_Cipher_Context *ctx, const unsigned char *salt, unsigned int salt_len, int iter, unsigned char *res, int res_len);
+
+# ifdef EFL_HAVE_PTHREAD
+static pthread_key_t eet_cipher_context_key;
+static Eina_Bool eet_cipher_context_key_created = EINA_FALSE;
+static pthread_mutex_t eet_cipher_context_lock = PTHREAD_MUTEX_INITIALIZER;
+static Eet_Cipher_Context *eet_cipher_contexts = NULL;
+# else
+static Eet_Cipher_Context *eet_cipher_context = NULL;
 # endif
-static Eet_Error eet_pbkdf2_sha1(const char *key, int key_len, const unsigned char *salt, unsigned int salt_len, int iter, unsigned char *res, int res_len);
 #endif
 
 struct _Eet_Key
@@ -390,6 +435,20 @@ eet_identity_compute_sha1(const void *data_base, unsigned int data_length,
    return result;
 }
 
+void *
+eet_identity_file_sha1(const void *data_base, unsigned int data_length,
+		       unsigned int signed_length, int *sha1_length)
+{
+#if defined(HAVE_SIGNATURE) && defined(HAVE_GNUTLS) && EET_USE_NEW_GNUTLS_API
+   /* eet_identity_check() keeps the hash it verified the signature with */
+   (void) data_length;
+   return eet_identity_compute_sha1(data_base, signed_length, sha1_length);
+#else
+   (void) signed_length;
+   return eet_identity_compute_sha1(data_base, data_length, sha1_length);
+#endif
+}
+
 Eet_Error
 eet_identity_sign(FILE *fp, Eet_Key *key)
 {
@@ -526,16 +585,13 @@ eet_identity_sign(FILE *fp, Eet_Key *key)
 }
 
 const void*
-eet_identity_check(const void *data_base, unsigned int data_length,
-		   void **sha1, int *sha1_length,
-		   const void *signature_base, unsigned int signature_length,
+eet_identity_parse(const void *signature_base, unsigned int signature_length,
 		   const void **raw_signature_base, unsigned int *raw_signature_length,
 		   int *x509_length)
 {
 #ifdef HAVE_SIGNATURE
    const int *header = signature_base;
    const unsigned char *sign;
-   const unsigned char *cert_der;
    int sign_len;
    int cert_len;
    int magic;
@@ -550,11 +606,39 @@ eet_identity_check(const void *data_base, unsigned int data_length,
 
    /* Verify the header */
    if (magic != EET_MAGIC_SIGN) return NULL;
+   if (sign_len < 0 || cert_len < 0) return NULL;
    if (sign_len + cert_len + sizeof(int) * 3 > signature_length) return NULL;
 
    /* Update the signature and certificate pointer */
    sign = (unsigned char *)signature_base + sizeof(int) * 3;
-   cert_der = sign + sign_len;
+
+   if (x509_length) *x509_length = cert_len;
+   if (raw_signature_base) *raw_signature_base = sign;
+   if (raw_signature_length) *raw_signature_length = sign_len;
+   return sign + sign_len;
+#else
+   return NULL;
+#endif
+}
+
+const void*
+eet_identity_check(const void *data_base, unsigned int data_length,
+		   void **sha1, int *sha1_length,
+		   const void *signature_base, unsigned int signature_length,
+		   const void **raw_signature_base, unsigned int *raw_signature_length,
+		   int *x509_length)
+{
+#ifdef HAVE_SIGNATURE
+   const void *sign_base;
+   const unsigned char *sign;
+   const unsigned char *cert_der;
+   unsigned int sign_len;
+   int cert_len;
+
+   cert_der = eet_identity_parse(signature_base, signature_length,
+				 &sign_base, &sign_len, &cert_len);
+   if (!cert_der) return NULL;
+   sign = sign_base;
 
 # ifdef HAVE_GNUTLS
    gnutls_x509_crt_t cert;
@@ -736,6 +820,7 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
 {
 #ifdef HAVE_CIPHER
   /* Cipher declarations */
+   Eet_Cipher_Context *ctx;
    unsigned int *ret = NULL;
    unsigned char iv[MAX_IV_LEN];
    unsigned char ik[MAX_KEY_LEN];
@@ -743,18 +828,18 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
    unsigned int salt;
    unsigned int tmp = 0;
    int crypted_length;
-   int opened = 0;
 # ifdef HAVE_GNUTLS
    /* Gcrypt declarations */
    gcry_error_t err = 0;
-   gcry_cipher_hd_t cipher;
 # else
    /* Openssl declarations*/
-   EVP_CIPHER_CTX ctx;
    unsigned int *buffer;
    int tmp_len;
 # endif
 
+   ctx = eet_cipher_context_get(key, length);
+   if (!ctx) return EET_ERROR_ENCRYPT_FAILED;
+
 # ifdef HAVE_GNUTLS
    /* Gcrypt salt generation */
    gcry_create_nonce((unsigned char *)&salt, sizeof(salt));
@@ -764,7 +849,7 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
      return EET_ERROR_PRNG_NOT_SEEDED;
 #endif
 
-   eet_pbkdf2_sha1(key, length, (unsigned char *)&salt, sizeof(unsigned int), 2048, key_material, MAX_KEY_LEN + MAX_IV_LEN);
+   eet_pbkdf2_sha1(ctx, (unsigned char *)&salt, sizeof(unsigned int), 2048, key_material, MAX_KEY_LEN + MAX_IV_LEN);
 
    memcpy(iv, key_material, MAX_IV_LEN);
    memcpy(ik, key_material + MAX_IV_LEN, MAX_KEY_LEN);
@@ -788,48 +873,42 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
    *(ret + 1) = tmp;
    memcpy(ret + 2, data, size);
 
-   /* Gcrypt create the corresponding cipher
+   /* Gcrypt reuse the thread cipher
       AES with a 256 bit key, Cipher Block Chaining mode */
-   err = gcry_cipher_open(&cipher, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0);
-   if (err) goto on_error;
-   opened = 1;
-   err = gcry_cipher_setiv(cipher, iv, MAX_IV_LEN);
+   err = gcry_cipher_setiv(ctx->cipher, iv, MAX_IV_LEN);
    if (err) goto on_error;
-   err = gcry_cipher_setkey(cipher, ik, MAX_KEY_LEN);
+   err = gcry_cipher_setkey(ctx->cipher, ik, MAX_KEY_LEN);
    if (err) goto on_error;
 
    memset(iv, 0, sizeof (iv));
    memset(ik, 0, sizeof (ik));
 
    /* Gcrypt encrypt */
-   err = gcry_cipher_encrypt(cipher, (unsigned char *)(ret + 1), crypted_length, NULL, 0);
+   err = gcry_cipher_encrypt(ctx->cipher, (unsigned char *)(ret + 1), crypted_length, NULL, 0);
    if (err) goto on_error;
-
-   /* Gcrypt close the cipher */
-   gcry_cipher_close(cipher);
 # else
-   buffer = alloca(crypted_length);
+   buffer = (unsigned int *) eet_cipher_context_buffer_get(ctx, crypted_length);
+   if (!buffer) goto on_error;
    *buffer = tmp;
 
    memcpy(buffer + 1, data, size);
 
-   /* Openssl create the corresponding cipher
+   /* Openssl reuse the thread cipher
       AES with a 256 bit key, Cipher Block Chaining mode */
-   EVP_CIPHER_CTX_init(&ctx);
-   if (!EVP_EncryptInit_ex(&ctx, EVP_aes_256_cbc(), NULL, ik, iv)) goto on_error;
-   opened = 1;
+   if (!EVP_EncryptInit_ex(&ctx->cipher, EVP_aes_256_cbc(), NULL, ik, iv)) goto on_error;
 
    memset(iv, 0, sizeof (iv));
    memset(ik, 0, sizeof (ik));
 
    /* Openssl encrypt */
-   if (!EVP_EncryptUpdate(&ctx, (unsigned char*)(ret + 1), &tmp_len, (unsigned char*) buffer, size + sizeof (unsigned int)))
+   if (!EVP_EncryptUpdate(&ctx->cipher, (unsigned char*)(ret + 1), &tmp_len, (unsigned char*) buffer, size + sizeof (unsigned int)))
      goto on_error;
 
    /* Openssl close the cipher */
-   if (!EVP_EncryptFinal_ex(&ctx, ((unsigned char*)(ret + 1)) + tmp_len, &tmp_len))
+   if (!EVP_EncryptFinal_ex(&ctx->cipher, ((unsigned char*)(ret + 1)) + tmp_len, &tmp_len))
      goto on_error;
-   EVP_CIPHER_CTX_cleanup(&ctx);
+
+   eet_cipher_context_buffer_wipe(ctx, crypted_length);
 # endif
 
    /* Set return values */
@@ -842,14 +921,10 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
  on_error:
    memset(iv, 0, sizeof (iv));
    memset(ik, 0, sizeof (ik));
-
-# ifdef HAVE_GNUTLS
-   /* Gcrypt error */
-   if (opened) gcry_cipher_close(cipher);
-# else
-   /* Openssl error */
-   if (opened) EVP_CIPHER_CTX_cleanup(&ctx);
+# ifndef HAVE_GNUTLS
+   eet_cipher_context_buffer_wipe(ctx, crypted_length);
 # endif
+
    /* General error */
    if (ret) free(ret);
    if (result) *result = NULL;
@@ -869,26 +944,33 @@ eet_cipher(const void *data, unsigned int size, const char *key, unsigned int le
 }
 
 Eet_Error
-eet_decipher(const void *data, unsigned int size, const char *key, unsigned int length, void **result, unsigned int *result_length)
+eet_decipher_stream(const void *data, unsigned int size, const char *key, unsigned int length, Eet_Decipher_Cb cb, void *cb_data)
 {
 #ifdef HAVE_CIPHER
-   const unsigned int *over = data;
-   unsigned int *ret = NULL;
+   const unsigned char *over = data;
+   Eet_Cipher_Context *ctx;
    unsigned char ik[MAX_KEY_LEN];
    unsigned char iv[MAX_IV_LEN];
    unsigned char key_material[MAX_KEY_LEN + MAX_IV_LEN];
+   unsigned char *window;
    unsigned int salt;
-   int tmp_len;
-   int tmp = 0;
+   unsigned int total = 0;
+   unsigned int remaining = 0;
+   unsigned int offset;
+   unsigned int tmp_len;
+   unsigned int used = 0;
 
    /* At least the salt and an AES block */
    if (size < sizeof(unsigned int) + 16) return EET_ERROR_BAD_OBJECT;
 
+   ctx = eet_cipher_context_get(key, length);
+   if (!ctx) return EET_ERROR_DECRYPT_FAILED;
+
    /* Get the salt */
-   salt = *over;
+   memcpy(&salt, over, sizeof (unsigned int));
 
    /* Generate the iv and the key with the salt */
-   eet_pbkdf2_sha1(key, length, (unsigned char *)&salt, sizeof(unsigned int), 2048, key_material, MAX_KEY_LEN + MAX_IV_LEN);
+   eet_pbkdf2_sha1(ctx, (unsigned char *)&salt, sizeof(unsigned int), 2048, key_material, MAX_KEY_LEN + MAX_IV_LEN);
 
    memcpy(iv, key_material, MAX_IV_LEN);
    memcpy(ik, key_material + MAX_IV_LEN, MAX_KEY_LEN);
@@ -900,85 +982,148 @@ eet_decipher(const void *data, unsigned int size, const char *key, unsigned int
    tmp_len = size - sizeof (unsigned int);
    if ((tmp_len & 0x1F) != 0) goto on_error;
 
-   ret = malloc(tmp_len);
-   if (!ret) goto on_error;
+   window = eet_cipher_context_buffer_get(ctx, EET_DECIPHER_WINDOW);
+   if (!window) goto on_error;
 
 # ifdef HAVE_GNUTLS
-   gcry_error_t err = 0;
-   gcry_cipher_hd_t cipher;
-
-   /* Gcrypt create the corresponding cipher */
-   err = gcry_cipher_open(&cipher, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0);
-   if (err) return EET_ERROR_DECRYPT_FAILED;
-   err = gcry_cipher_setiv(cipher, iv, MAX_IV_LEN);
-   if (err) goto on_error;
-   err = gcry_cipher_setkey(cipher, ik, MAX_KEY_LEN);
-   if (err) goto on_error;
+   /* Gcrypt reuse the thread cipher, CBC state is kept between calls */
+   if (gcry_cipher_setiv(ctx->cipher, iv, MAX_IV_LEN)) goto on_error;
+   if (gcry_cipher_setkey(ctx->cipher, ik, MAX_KEY_LEN)) goto on_error;
+# else
+   /* Openssl reuse the thread cipher, we strip the padding ourself */
+   if (!EVP_DecryptInit_ex(&ctx->cipher, EVP_aes_256_cbc(), NULL, ik, iv))
+     goto on_error;
+   EVP_CIPHER_CTX_set_padding(&ctx->cipher, 0);
+# endif
 
    memset(iv, 0, sizeof (iv));
    memset(ik, 0, sizeof (ik));
 
-   /* Gcrypt decrypt */
-   err = gcry_cipher_decrypt(cipher, ret, tmp_len, ((unsigned int *)data) + 1, tmp_len);
-   if (err) goto on_error;
+   /* Decrypt one window at a time, the first one start with the clear size */
+   for (offset = 0; offset < tmp_len; )
+     {
+	const unsigned char *clear = window;
+	unsigned int chunk;
+	unsigned int avail;
 
-   /* Gcrypt close the cipher */
-   gcry_cipher_close(cipher);
+	chunk = tmp_len - offset;
+	if (chunk > EET_DECIPHER_WINDOW) chunk = EET_DECIPHER_WINDOW;
+	if (chunk > used) used = chunk;
 
+# ifdef HAVE_GNUTLS
+	if (gcry_cipher_decrypt(ctx->cipher, window, chunk,
+				over + sizeof (unsigned int) + offset, chunk))
+	  goto on_error;
 # else
-   EVP_CIPHER_CTX ctx;
-   int opened = 0;
+	{
+	   int out_len;
 
-   /* Openssl create the corresponding cipher */
-   EVP_CIPHER_CTX_init(&ctx);
-   opened = 1;
+	   if (!EVP_DecryptUpdate(&ctx->cipher, window, &out_len,
+				  over + sizeof (unsigned int) + offset, chunk))
+	     goto on_error;
+	}
+# endif
 
-   if (!EVP_DecryptInit_ex(&ctx, EVP_aes_256_cbc(), NULL, ik, iv))
-     goto on_error;
+	if (offset == 0)
+	  {
+	     unsigned int tmp;
 
-   memset(iv, 0, sizeof (iv));
-   memset(ik, 0, sizeof (ik));
+	     /* Get the decrypted data size */
+	     memcpy(&tmp, window, sizeof (unsigned int));
+	     total = ntohl(tmp);
+	     if (total > tmp_len - sizeof (unsigned int))
+	       goto on_error;
 
-   /* Openssl decrypt */
-   if (!EVP_DecryptUpdate(&ctx, (unsigned char *) ret, &tmp,
-			  (unsigned char *) (over + 1), tmp_len))
-     goto on_error;
+	     remaining = total;
+	     clear += sizeof (unsigned int);
+	     avail = chunk - sizeof (unsigned int);
+	  }
+	else
+	  avail = chunk;
+	offset += chunk;
 
-   /* Openssl close the cipher*/
-   EVP_CIPHER_CTX_cleanup(&ctx);
-# endif
-   /* Get the decrypted data size */
-   tmp = *ret;
-   tmp = ntohl(tmp);
-   if (tmp > tmp_len) goto on_error;
+	if (avail > remaining) avail = remaining;
+	if (!cb(cb_data, clear, avail, total))
+	  goto on_error;
 
-   /* Update the return values */
-   if (result_length) *result_length = tmp;
-   if (result)
-     {
-       *result = NULL;
-       *result = malloc(tmp);
-       if (!*result)
-	 goto on_error;
-       memcpy(*result, ret + 1, tmp);
+	remaining -= avail;
+	if (!remaining) break;
      }
-   free(ret);
 
+   eet_cipher_context_buffer_wipe(ctx, used);
    return EET_ERROR_NONE;
 
  on_error:
    memset(iv, 0, sizeof (iv));
    memset(ik, 0, sizeof (ik));
-
-# ifdef HAVE_GNUTLS
-# else
-   if (opened) EVP_CIPHER_CTX_cleanup(&ctx);
-# endif
-   if (result) *result = NULL;
-   if (result_length) *result_length = 0;
-   if (ret) free(ret);
+   eet_cipher_context_buffer_wipe(ctx, used);
 
    return EET_ERROR_DECRYPT_FAILED;
+#else
+   (void) data;
+   (void) size;
+   (void) key;
+   (void) length;
+   (void) cb;
+   (void) cb_data;
+   return EET_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+#ifdef HAVE_CIPHER
+typedef struct _Eet_Decipher_Buffer Eet_Decipher_Buffer;
+struct _Eet_Decipher_Buffer
+{
+   unsigned char *result;
+   unsigned int   length;
+   Eina_Bool      want_result : 1;
+};
+
+static Eina_Bool
+_eet_decipher_buffer_cb(void *data, const void *clear, unsigned int clear_length, unsigned int total)
+{
+   Eet_Decipher_Buffer *buf = data;
+
+   buf->length += clear_length;
+   if (!buf->want_result) return EINA_TRUE;
+
+   if (!buf->result)
+     {
+	buf->result = malloc(total ? total : 1);
+	if (!buf->result) return EINA_FALSE;
+     }
+   memcpy(buf->result + buf->length - clear_length, clear, clear_length);
+
+   return EINA_TRUE;
+}
+#endif
+
+Eet_Error
+eet_decipher(const void *data, unsigned int size, const char *key, unsigned int length, void **result, unsigned int *result_length)
+{
+#ifdef HAVE_CIPHER
+   Eet_Decipher_Buffer buf;
+   Eet_Error err;
+
+   buf.result = NULL;
+   buf.length = 0;
+   buf.want_result = !!result;
+
+   err = eet_decipher_stream(data, size, key, length, _eet_decipher_buffer_cb, &buf);
+   if (err != EET_ERROR_NONE)
+     {
+	if (buf.result) free(buf.result);
+	if (result) *result = NULL;
+	if (result_length) *result_length = 0;
+
+	return err == EET_ERROR_BAD_OBJECT ? err : EET_ERROR_DECRYPT_FAILED;
+     }
+
+   /* Update the return values */
+   if (result_length) *result_length = buf.length;
+   if (result) *result = buf.result;
+
+   return EET_ERROR_NONE;
 #else
    (void) data;
    (void) size;
@@ -991,47 +1136,182 @@ eet_decipher(const void *data, unsigned int size, const char *key, unsigned int
 }
 
 #ifdef HAVE_CIPHER
+static Eet_Cipher_Context *
+eet_cipher_context_get(const char *key, unsigned int length)
+{
+   Eet_Cipher_Context *ctx;
+
+# ifdef EFL_HAVE_PTHREAD
+   if (!eet_cipher_context_key_created) return NULL;
+   ctx = pthread_getspecific(eet_cipher_context_key);
+# else
+   ctx = eet_cipher_context;
+# endif
+
+   if (!ctx)
+     {
+	ctx = calloc(1, sizeof (Eet_Cipher_Context));
+	if (!ctx) return NULL;
+
 # ifdef HAVE_GNUTLS
-static Eet_Error
-eet_hmac_sha1(const void *key, size_t key_len,
-              const void *data, size_t data_len, unsigned char *res)
+	if (gcry_cipher_open(&ctx->cipher, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0))
+	  {
+	     free(ctx);
+	     return NULL;
+	  }
+	if (gcry_md_open(&ctx->hmac, GCRY_MD_SHA1, GCRY_MD_FLAG_HMAC))
+	  {
+	     gcry_cipher_close(ctx->cipher);
+	     free(ctx);
+	     return NULL;
+	  }
+# else
+	EVP_CIPHER_CTX_init(&ctx->cipher);
+	HMAC_CTX_init(&ctx->hmac);
+# endif
+
+# ifdef EFL_HAVE_PTHREAD
+	pthread_mutex_lock(&eet_cipher_context_lock);
+	ctx->next = eet_cipher_contexts;
+	if (eet_cipher_contexts) eet_cipher_contexts->prev = ctx;
+	eet_cipher_contexts = ctx;
+	pthread_mutex_unlock(&eet_cipher_context_lock);
+
+	pthread_setspecific(eet_cipher_context_key, ctx);
+# else
+	eet_cipher_context = ctx;
+# endif
+     }
+
+   if (ctx->key
+       && ctx->key_length == length
+       && !memcmp(ctx->key, key, length))
+     return ctx;
+
+   /* A different key, nothing from the previous one must survive. */
+   if (ctx->key)
+     {
+	memset(ctx->key, 0, ctx->key_length);
+	free(ctx->key);
+	ctx->key = NULL;
+	ctx->key_length = 0;
+     }
+   if (ctx->buffer)
+     memset(ctx->buffer, 0, ctx->buffer_size);
+
+   ctx->key = malloc(length + 1);
+   if (!ctx->key) return NULL;
+   memcpy(ctx->key, key, length);
+   ctx->key_length = length;
+
+# ifdef HAVE_GNUTLS
+   if (gcry_md_setkey(ctx->hmac, key, length) != GPG_ERR_NO_ERROR)
+     {
+	memset(ctx->key, 0, length);
+	free(ctx->key);
+	ctx->key = NULL;
+	ctx->key_length = 0;
+	return NULL;
+     }
+# else
+   HMAC_Init_ex(&ctx->hmac, key, length, EVP_sha1(), NULL);
+# endif
+
+   return ctx;
+}
+
+/* called when a thread exits */
+static void
+eet_cipher_context_free(void *data)
 {
-  size_t hlen = gcry_md_get_algo_dlen (GCRY_MD_SHA1);
-  gcry_md_hd_t mdh;
-  unsigned char *hash;
-  gpg_error_t err;
+   Eet_Cipher_Context *ctx = data;
 
-  err = gcry_md_open(&mdh, GCRY_MD_SHA1, GCRY_MD_FLAG_HMAC);
-  if (err != GPG_ERR_NO_ERROR)
-    return 1;
+   if (!ctx) return ;
 
-  err = gcry_md_setkey(mdh, key, key_len);
-  if (err != GPG_ERR_NO_ERROR)
-    {
-      gcry_md_close(mdh);
-      return 1;
-    }
+# ifdef EFL_HAVE_PTHREAD
+   pthread_mutex_lock(&eet_cipher_context_lock);
+   if (ctx->prev) ctx->prev->next = ctx->next;
+   else eet_cipher_contexts = ctx->next;
+   if (ctx->next) ctx->next->prev = ctx->prev;
+   pthread_mutex_unlock(&eet_cipher_context_lock);
+# endif
 
-  gcry_md_write(mdh, data, data_len);
+   eet_cipher_context_destroy(ctx);
+}
 
-  hash = gcry_md_read(mdh, GCRY_MD_SHA1);
-  if (hash == NULL)
-    {
-      gcry_md_close(mdh);
-      return 1;
-    }
+static void
+eet_cipher_context_destroy(Eet_Cipher_Context *ctx)
+{
+   if (ctx->key)
+     {
+	memset(ctx->key, 0, ctx->key_length);
+	free(ctx->key);
+     }
+   if (ctx->buffer)
+     {
+	memset(ctx->buffer, 0, ctx->buffer_size);
+	free(ctx->buffer);
+     }
 
-  memcpy(res, hash, hlen);
+# ifdef HAVE_GNUTLS
+   gcry_cipher_close(ctx->cipher);
+   gcry_md_close(ctx->hmac);
+# else
+   EVP_CIPHER_CTX_cleanup(&ctx->cipher);
+   HMAC_CTX_cleanup(&ctx->hmac);
+# endif
 
-  gcry_md_close(mdh);
+   free(ctx);
+}
 
-  return 0;
+static unsigned char *
+eet_cipher_context_buffer_get(Eet_Cipher_Context *ctx, unsigned int size)
+{
+   unsigned char *tmp;
+
+   if (size <= ctx->buffer_size) return ctx->buffer;
+
+   tmp = malloc(size);
+   if (!tmp) return NULL;
+
+   if (ctx->buffer)
+     {
+	memset(ctx->buffer, 0, ctx->buffer_size);
+	free(ctx->buffer);
+     }
+
+   ctx->buffer = tmp;
+   ctx->buffer_size = size;
+   return tmp;
 }
+
+/* no clear data or key stream stays in the buffer between operations */
+static void
+eet_cipher_context_buffer_wipe(Eet_Cipher_Context *ctx, unsigned int used)
+{
+   if (!ctx->buffer) return ;
+   if (used > ctx->buffer_size) used = ctx->buffer_size;
+   memset(ctx->buffer, 0, used);
+}
+
+static void
+eet_hmac_sha1(Eet_Cipher_Context *ctx, const void *data, size_t data_len, unsigned char *res)
+{
+# ifdef HAVE_GNUTLS
+  /* reset keep the key, so the HMAC pads are not recomputed */
+  gcry_md_reset(ctx->hmac);
+  gcry_md_write(ctx->hmac, data, data_len);
+  memcpy(res, gcry_md_read(ctx->hmac, GCRY_MD_SHA1), 20);
+# else
+  /* a NULL key reuse the one given to the last HMAC_Init_ex */
+  HMAC_Init_ex(&ctx->hmac, NULL, 0, NULL, NULL);
+  HMAC_Update(&ctx->hmac, data, data_len);
+  HMAC_Final(&ctx->hmac, res, NULL);
 # endif
+}
 
 static Eet_Error
-eet_pbkdf2_sha1(const char          *key,
-		int                  key_len,
+eet_pbkdf2_sha1(Eet_Cipher_Context *ctx,
 		const unsigned char *salt,
 		unsigned int         salt_len,
 		int                  iter,
@@ -1047,10 +1327,6 @@ eet_pbkdf2_sha1(const char          *key,
   int                   len = res_len;
   int                   tmp_len;
   int                   j, k;
-# ifdef HAVE_GNUTLS
-# else
-  HMAC_CTX              hctx;
-# endif
 
   buf = alloca(salt_len + 4);
   if (!buf) return 1;
@@ -1065,34 +1341,60 @@ eet_pbkdf2_sha1(const char          *key,
       tab[2] = (unsigned char)(i & 0x0000ff00) >> 8;
       tab[3] = (unsigned char)(i & 0x000000ff) >> 0;
 
-# ifdef HAVE_GNUTLS
       memcpy(buf, salt, salt_len);
       memcpy(buf + salt_len, tab, 4);
-      eet_hmac_sha1(key, key_len, buf, salt_len + 4, digest);
-# else
-      HMAC_Init(&hctx, key, key_len, EVP_sha1());
-      HMAC_Update(&hctx, salt, salt_len);
-      HMAC_Update(&hctx, tab, 4);
-      HMAC_Final(&hctx, digest, NULL);
-# endif
+      eet_hmac_sha1(ctx, buf, salt_len + 4, digest);
       memcpy(p, digest, tmp_len);
 
       for (j = 1; j < iter; j++)
 	{
-# ifdef HAVE_GNUTLS
-	  eet_hmac_sha1(key, key_len, digest, 20, digest);
-# else
-	  HMAC(EVP_sha1(), key, key_len, digest, 20, digest, NULL);
-# endif
+	  eet_hmac_sha1(ctx, digest, 20, digest);
 	  for (k = 0; k < tmp_len; k++)
 	    p[k] ^= digest[k];
 	}
     }
 
-# ifdef HAVE_GNUTLS
-# else
-  HMAC_cleanup(&hctx);
-# endif
+  memset(digest, 0, sizeof (digest));
   return 0;
 }
 #endif
+
+void
+eet_cipher_context_init(void)
+{
+#ifdef HAVE_CIPHER
+# ifdef EFL_HAVE_PTHREAD
+   if (eet_cipher_context_key_created) return ;
+   if (!pthread_key_create(&eet_cipher_context_key, eet_cipher_context_free))
+     eet_cipher_context_key_created = EINA_TRUE;
+# endif
+#endif
+}
+
+void
+eet_cipher_context_shutdown(void)
+{
+#ifdef HAVE_CIPHER
+# ifdef EFL_HAVE_PTHREAD
+   if (!eet_cipher_context_key_created) return ;
+
+   /* the other threads are not ciphering anymore, wipe their contexts too */
+   pthread_mutex_lock(&eet_cipher_context_lock);
+   while (eet_cipher_contexts)
+     {
+	Eet_Cipher_Context *ctx = eet_cipher_contexts;
+
+	eet_cipher_contexts = ctx->next;
+	eet_cipher_context_destroy(ctx);
+     }
+   pthread_mutex_unlock(&eet_cipher_context_lock);
+
+   pthread_setspecific(eet_cipher_context_key, NULL);
+   pthread_key_delete(eet_cipher_context_key);
+   eet_cipher_context_key_created = EINA_FALSE;
+# else
+   if (eet_cipher_context) eet_cipher_context_destroy(eet_cipher_context);
+   eet_cipher_context = NULL;
+# endif
+#endif
+}
@@ -20,6 +20,10 @@
 # include <winsock2.h>
 #endif
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include <Eina.h>
 
 #include "Eet.h"
@@ -69,12 +73,23 @@ typedef struct _Eet_Data_Element            Eet_Data_Element;
 typedef struct _Eet_Data_Basic_Type_Codec   Eet_Data_Basic_Type_Codec;
 typedef struct _Eet_Data_Group_Type_Codec   Eet_Data_Group_Type_Codec;
 typedef struct _Eet_Data_Chunk              Eet_Data_Chunk;
-typedef struct _Eet_Data_Stream             Eet_Data_Stream;
 typedef struct _Eet_Data_Descriptor_Hash    Eet_Data_Descriptor_Hash;
 typedef struct _Eet_Data_Encode_Hash_Info   Eet_Data_Encode_Hash_Info;
 typedef struct _Eet_Free		    Eet_Free;
 typedef struct _Eet_Free_Context	    Eet_Free_Context;
 typedef struct _Eet_Variant_Unknow	    Eet_Variant_Unknow;
+typedef struct _Eet_Data_Arena_Block	    Eet_Data_Arena_Block;
+typedef struct _Eet_Data_Arena_Container    Eet_Data_Arena_Container;
+typedef struct _Eet_Data_Decode_Step	    Eet_Data_Decode_Step;
+typedef struct _Eet_Data_Decode_Plan	    Eet_Data_Decode_Plan;
+typedef struct _Eet_Data_Translation_Step    Eet_Data_Translation_Step;
+typedef struct _Eet_Data_Translation	    Eet_Data_Translation;
+typedef struct _Eet_Data_Lazy_Member	    Eet_Data_Lazy_Member;
+typedef struct _Eet_Data_Text_Dump_Level    Eet_Data_Text_Dump_Level;
+typedef struct _Eet_Data_Text_Dump	    Eet_Data_Text_Dump;
+typedef struct _Eet_Data_Undump		    Eet_Data_Undump;
+typedef struct _Eet_Data_Undump_Token	    Eet_Data_Undump_Token;
+typedef struct _Eet_Data_Undump_Group	    Eet_Data_Undump_Group;
 
 /*---*/
 
@@ -87,7 +102,7 @@ struct _Eet_Data_Basic_Type_Codec
    int         size;
    const char *name;
    int       (*get) (const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-   void     *(*put) (Eet_Dictionary *ed, const void *src, int *size_ret);
+   int       (*put) (Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 };
 
 struct _Eet_Data_Group_Type_Codec
@@ -105,6 +120,7 @@ struct _Eet_Data_Chunk
    void          *data;
    unsigned char  type;
    unsigned char  group_type;
+   Eina_Bool      ieee : 1;
 };
 
 struct _Eet_Data_Stream
@@ -114,16 +130,18 @@ struct _Eet_Data_Stream
    int   pos;
 };
 
+/* One slot of the open addressed element table, hash and len let most
+ * misses skip the name comparison. */
 struct _Eet_Data_Descriptor_Hash
 {
    Eet_Data_Element         *element;
-   Eet_Data_Descriptor_Hash *next;
+   unsigned int              hash; /* FNV-1a of the name, with its nul */
+   int                       len;  /* length of the name, with its nul */
 };
 
 struct _Eet_Data_Descriptor
 {
    const char           *name;
-   const Eet_Dictionary *ed;
    int                   size;
    struct {
       void *(*mem_alloc) (size_t size);
@@ -151,7 +169,20 @@ struct _Eet_Data_Descriptor
       } hash;
    } elements;
 
+   /* derived from the elements by _eet_data_descriptor_update(), never
+    * written while decoding */
+   Eet_Data_Decode_Plan *plan;
+   unsigned int          schema_hash;
+
+   /* Eet_Data_Translation of the previous versions of the descriptor */
+   Eina_List            *translations;
+
    Eina_Bool unified_type : 1;
+   Eina_Bool implicit : 1;
+   Eina_Bool compact : 1;
+   Eina_Bool columnar : 1;
+   Eina_Bool float_ieee : 1;
+   Eina_Bool borrow : 1;
 //   char *strings;
 //   int   strings_len;
 };
@@ -160,7 +191,6 @@ struct _Eet_Data_Element
 {
    const char          *name;
    const char          *counter_name;
-   const char          *directory_name_ptr;
    Eet_Data_Descriptor *subtype;
    int                  offset;         /* offset in bytes from the base element */
    int                  count;          /* number of elements for a fixed array */
@@ -169,6 +199,122 @@ struct _Eet_Data_Element
    unsigned char        group_type;     /* EET_G_XXX */
 };
 
+/* One step per element, in the order the encoder writes them. */
+struct _Eet_Data_Decode_Step
+{
+   Eet_Data_Element *ede;
+   int               name_len;   /* chunk len of the name */
+   int               chunk_type; /* chunk type byte written for ede, -1 if none */
+   unsigned char     type;
+   unsigned char     group_type;
+   Eina_Bool         ieee : 1;
+};
+
+struct _Eet_Data_Decode_Plan
+{
+   int                  num;
+   Eet_Data_Decode_Step steps[1];
+};
+
+/* One step per element of a previous version of a descriptor, in the
+ * order compact data written by that version stores them. */
+struct _Eet_Data_Translation_Step
+{
+   const char   *name;       /* stringshared */
+   int           index;      /* element the value goes to, -1 to skip it */
+   unsigned char type;       /* as written */
+   unsigned char group_type;
+};
+
+struct _Eet_Data_Translation
+{
+   unsigned int              schema_hash; /* of the previous version */
+   int                       num;
+   Eet_Data_Translation_Step steps[1];
+};
+
+/* One per structure or array being dumped. */
+struct _Eet_Data_Text_Dump_Level
+{
+   int         group_type; /* of the item the structure is, EET_G_LAST at the top */
+   const char *list;       /* left open around it */
+   int         list_type;
+};
+
+#define EET_DATA_TEXT_DUMP_BUFFER 16384
+
+struct _Eet_Data_Text_Dump
+{
+   void                    (*dumpfunc) (void *data, const char *str);
+   void                     *dumpdata;
+
+   Eet_Data_Text_Dump_Level *levels;
+   int                       depth;
+   int                       size;
+
+   const char               *list;   /* name of the list group open */
+   int                       list_type; /* EET_G_LIST, or EET_G_HASH in json */
+   int                       indent;
+   Eina_Bool                 comma : 1; /* json, an item was written at this level */
+
+   int                       len;
+   char                      buf[EET_DATA_TEXT_DUMP_BUFFER];
+};
+
+/* A token of the text to undump, it points in the text. */
+struct _Eet_Data_Undump_Token
+{
+   const char *s;
+   int         len;
+   Eina_Bool   quoted : 1;
+};
+
+struct _Eet_Data_Undump
+{
+   Eet_Dictionary  *ed;
+   Eet_Data_Stream *ds;
+
+   const char      *src;
+   const char      *p;
+   const char      *end;
+
+   /* unescaped names and strings, reused for the whole text */
+   char            *str[2];
+   int              str_size[2];
+
+   /* values of the array being packed, there is only one at a time */
+   char            *packed;
+   int              packed_size;
+
+   Eina_Bool        error : 1;
+};
+
+#define EET_DATA_UNDUMP_ARRAY_NONE   0 /* no value yet */
+#define EET_DATA_UNDUMP_ARRAY_PACKED 1
+#define EET_DATA_UNDUMP_ARRAY_CHUNKS 2
+
+/* One per group open. */
+struct _Eet_Data_Undump_Group
+{
+   const char *name;
+   int         type;
+   int         start;      /* of the chunk of a structure */
+
+   int         count;      /* of an array, then the items it still misses */
+   int         mode;       /* of an array, EET_DATA_UNDUMP_ARRAY_* */
+   int         child_type; /* first value of an array that isn't null */
+   int         items;      /* values packed so far */
+
+   /* an array whose count is known once its items are read, its nulls
+    * are kept in place */
+   int         total;
+   int         count_end;  /* of the count chunk, to patch it */
+
+   Eina_Bool   key : 1;
+   Eina_Bool   children : 1;
+   Eina_Bool   grow : 1;
+};
+
 struct _Eet_Data_Encode_Hash_Info
 {
   Eet_Data_Stream       *ds;
@@ -176,12 +322,14 @@ struct _Eet_Data_Encode_Hash_Info
   Eet_Dictionary        *ed;
 };
 
+/* Undo log of what a decode allocated, released in reverse order if it
+ * fails. Callers only log a pointer once. */
 struct _Eet_Free
 {
   int     ref;
-  int     len[256];
-  int     num[256];
-  void  **list[256];
+  int     len;
+  int     num;
+  void  **list;
 };
 
 struct _Eet_Free_Context
@@ -191,6 +339,82 @@ struct _Eet_Free_Context
    Eet_Free freelist_hash;
    Eet_Free freelist_str;
    Eet_Free freelist_direct_str;
+
+   /* When set, everything is allocated from the arena and the freelists
+    * stay empty. borrow tells that the encoded data outlives the arena,
+    * so strings can point straight into it. */
+   Eet_Data_Arena *arena;
+   Eina_Bool borrow : 1;
+
+   /* Top level containers and sub structures are not decoded but
+    * remembered there, see eet_data_read_lazy(). */
+   Eet_Data_Lazy *lazy;
+
+   /* Set when the descriptor given to eet_data_read() asks for it on a
+    * read only Eet_File, all strings then point in the file. */
+   Eina_Bool file : 1;
+};
+
+struct _Eet_Data_Arena_Block
+{
+   Eet_Data_Arena_Block *next;
+   size_t                size;
+   size_t                used;
+};
+
+struct _Eet_Data_Arena_Container
+{
+   void  **ptr;
+   void *(*list_free) (void *l);
+   void  (*hash_free) (void *h);
+};
+
+struct _Eet_Data_Arena
+{
+   Eet_Data_Arena_Block     *blocks;
+   size_t                    next_size;
+
+   Eet_Data_Arena_Container *containers;
+   int                       containers_num;
+   int                       containers_size;
+};
+
+struct _Eet_Data_Lazy_Member
+{
+   Eet_Data_Element *ede;
+   /* all chunks of the member are in there */
+   const char       *start;
+   const char       *end;
+};
+
+struct _Eet_Data_Lazy
+{
+   Eet_Data_Descriptor  *edd;
+   const Eet_Dictionary *ed;
+   void                 *data;
+
+   /* the encoded data, mapped by ef or in buffer */
+   Eet_File             *ef;
+   void                 *buffer;
+
+   Eina_List            *members;
+};
+
+struct _Eet_Data_Block
+{
+   Eet_Data_Descriptor  *edd;
+   Eet_File             *ef;
+
+   /* the records, in ds while they are appended, once read mapped by ef
+    * or in buffer */
+   Eet_Data_Stream      *ds;
+   const char           *records;
+   void                 *buffer;
+
+   /* where each record ends, from the start of the first one */
+   int                  *ends;
+   int                   count;
+   int                   size;
 };
 
 struct _Eet_Variant_Unknow
@@ -204,32 +428,32 @@ struct _Eet_Variant_Unknow
 /*---*/
 
 static int   eet_data_get_char(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_char(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_char(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_short(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_short(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_short(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static inline int   eet_data_get_int(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_int(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_int(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_long_long(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_long_long(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_long_long(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_float(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_float(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_float(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_double(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_double(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_double(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_f32p32(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_f32p32(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_f32p32(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_f16p16(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_f16p16(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_f16p16(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_f8p24(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_f8p24(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_f8p24(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static inline int   eet_data_get_string(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_string(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_string(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_istring(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_istring(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_istring(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 static int   eet_data_get_null(const Eet_Dictionary *ed, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_null(Eet_Dictionary *ed, const void *src, int *size_ret);
+static int   eet_data_put_null(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds);
 
 static int   eet_data_get_type(const Eet_Dictionary *ed, int type, const void *src, const void *src_end, void *dest);
-static void *eet_data_put_type(Eet_Dictionary *ed, int type, const void *src, int *size_ret);
+static int   eet_data_put_type(Eet_Dictionary *ed, int type, const void *src, Eet_Data_Stream *ds);
 
 static Eet_Node *eet_data_node_simple_type(int type, const char *name, void *dd);
 
@@ -237,6 +461,10 @@ static int  eet_data_get_unknown(Eet_Free_Context *context, const Eet_Dictionary
 static void eet_data_put_unknown(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in);
 static void eet_data_put_array(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in);
 static int  eet_data_get_array(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk, int type, int group_type, void *data, char **p, int *size);
+static int  eet_data_packed_type(const Eet_Data_Element *ede);
+static void eet_data_packed_copy(void *dst, const void *src, int count, int width);
+static void eet_data_put_packed_array(Eet_Dictionary *ed, Eet_Data_Stream *ds, const char *name, int type, int group_type, const void *src, int count);
+static int  eet_data_get_packed_array(Eet_Free_Context *context, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk, int count, int group_type, void *data);
 static int  eet_data_get_list(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk, int type, int group_type, void *data_in, char **p, int *size);
 static void eet_data_put_list(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in);
 static void eet_data_put_hash(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in);
@@ -247,22 +475,46 @@ static void eet_data_put_variant(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, E
 static int  eet_data_get_variant(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk, int type, int group_type, void *data, char **p, int *size);
 
 static void            eet_data_chunk_get(const Eet_Dictionary *ed, Eet_Data_Chunk *chnk, const void *src, int size);
-static Eet_Data_Chunk *eet_data_chunk_new(void *data, int size, const char *name, int type, int group_type);
-static void            eet_data_chunk_free(Eet_Data_Chunk *chnk);
+static int             eet_data_chunk_type_encode(int type, int group_type);
+static Eina_Bool       eet_data_chunk_type_decode(unsigned char chunk_type, Eet_Data_Chunk *chnk);
 
-static Eet_Data_Stream *eet_data_stream_new(void);
 static void             eet_data_stream_write(Eet_Data_Stream *ds, const void *data, int size);
-static void             eet_data_stream_free(Eet_Data_Stream *ds);
 
-static void             eet_data_chunk_put(Eet_Dictionary *ed, Eet_Data_Chunk *chnk, Eet_Data_Stream *ds);
+static int              eet_data_chunk_open(Eet_Dictionary *ed, Eet_Data_Stream *ds, const char *name, int type, int group_type);
+static int              eet_data_chunk_code_open(Eet_Dictionary *ed, Eet_Data_Stream *ds, const char *name, int chunk_type);
+static int              eet_data_element_chunk_type(const Eet_Data_Descriptor *edd, const Eet_Data_Element *ede);
+static int              eet_data_chunk_value_get(const Eet_Dictionary *ed, const Eet_Data_Chunk *chnk, int type, void *dest);
+static Eina_Bool        eet_data_encode_ieee(Eet_Dictionary *ed, Eet_Data_Stream *ds, int type, const void *src, const char *name);
+static void             eet_data_chunk_close(Eet_Data_Stream *ds, int start);
 
 static int       eet_data_descriptor_encode_hash_cb(void *hash, const char *key, void *hdata, void *fdata);
 static void     *_eet_data_descriptor_encode(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const void *data_in, int *size_ret);
+static Eina_Bool _eet_data_descriptor_encode_stream(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const void *data_in, Eet_Data_Stream *ds);
 static void     *_eet_data_descriptor_decode(Eet_Free_Context *context,
 					     const Eet_Dictionary *ed,
                                              Eet_Data_Descriptor *edd,
                                              const void *data_in,
                                              int size_in);
+static void      _eet_data_descriptor_update(Eet_Data_Descriptor *edd);
+static Eet_Data_Decode_Plan *_eet_data_decode_plan_new(Eet_Data_Descriptor *edd);
+static Eet_Data_Element *_eet_data_decode_plan_match(Eet_Data_Decode_Plan *plan, int *cursor, const Eet_Dictionary *ed, Eet_Data_Chunk *chnk, const char *src, int size);
+static unsigned int _eet_data_descriptor_schema_hash(const Eet_Data_Descriptor *edd);
+static unsigned int _eet_data_schema_hash_add(unsigned int hash, const void *data, int length);
+static void      _eet_data_translation_resolve(Eet_Data_Descriptor *edd, Eet_Data_Translation *tr);
+static Eina_Bool _eet_data_compact_encode(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const void *data_in, Eet_Data_Stream *ds);
+static Eina_Bool _eet_data_compact_decode(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, void *data, char *p, int size);
+static void     *_eet_data_read(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key, Eet_Data_Arena *arena);
+static Eet_Data_Lazy *_eet_data_lazy_new(const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const void *data_in, int size_in);
+static Eina_Bool _eet_data_lazy_defer(Eet_Data_Lazy *lazy, Eet_Data_Element *ede, const char *start, const char *end);
+static Eina_Bool _eet_data_walk(const Eet_Dictionary *ed, char *data, int size, Eet_Data_Walk *cb, void *user_data);
+static Eina_Bool _eet_data_walk_chunks(const Eet_Dictionary *ed, char *p, int size, Eet_Data_Walk *cb, void *user_data);
+static Eina_Bool _eet_data_undump_group(Eet_Data_Undump *u, const char *name, int type);
+static Eina_Bool _eet_data_json_value(Eet_Data_Undump *u, Eet_Data_Undump_Group *parent, const char *name);
+
+static void     *_eet_data_arena_alloc(Eet_Data_Arena *arena, size_t size, size_t align);
+static Eina_Bool _eet_data_arena_container_add(Eet_Data_Arena *arena, void **ptr, void *(*list_free) (void *l), void (*hash_free) (void *h));
+static void     *_eet_data_mem_alloc(Eet_Free_Context *context, Eet_Data_Descriptor *edd, size_t size);
+static char     *_eet_data_str_alloc(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const char *str, Eina_Bool direct);
 
 /*---*/
 
@@ -301,23 +553,9 @@ static int _eet_data_words_bigendian = -1;
 
 /*---*/
 
-#define SWAP64(x) (x) = \
-   ((((unsigned long long)(x) & 0x00000000000000ffULL ) << 56) |\
-       (((unsigned long long)(x) & 0x000000000000ff00ULL ) << 40) |\
-       (((unsigned long long)(x) & 0x0000000000ff0000ULL ) << 24) |\
-       (((unsigned long long)(x) & 0x00000000ff000000ULL ) << 8) |\
-       (((unsigned long long)(x) & 0x000000ff00000000ULL ) >> 8) |\
-       (((unsigned long long)(x) & 0x0000ff0000000000ULL ) >> 24) |\
-       (((unsigned long long)(x) & 0x00ff000000000000ULL ) >> 40) |\
-       (((unsigned long long)(x) & 0xff00000000000000ULL ) >> 56))
-#define SWAP32(x) (x) = \
-   ((((int)(x) & 0x000000ff ) << 24) |\
-       (((int)(x) & 0x0000ff00 ) << 8) |\
-       (((int)(x) & 0x00ff0000 ) >> 8) |\
-       (((int)(x) & 0xff000000 ) >> 24))
-#define SWAP16(x) (x) = \
-   ((((short)(x) & 0x00ff ) << 8) |\
-       (((short)(x) & 0xff00 ) >> 8))
+#define SWAP64(x) (x) = EET_BSWAP64(x)
+#define SWAP32(x) (x) = EET_BSWAP32(x)
+#define SWAP16(x) (x) = EET_BSWAP16(x)
 
 #ifdef CONV8
 # undef CONV8
@@ -339,6 +577,7 @@ static int _eet_data_words_bigendian = -1;
 
 #define IS_SIMPLE_TYPE(Type)    (Type > EET_T_UNKNOW && Type < EET_T_LAST)
 #define IS_POINTER_TYPE(Type)    (Type >= EET_T_STRING && Type <= EET_T_NULL)
+#define IS_PACKED_TYPE(Type)    (Type > EET_T_UNKNOW && Type < EET_T_STRING)
 
 #define POINTER_TYPE_DECODE(Context, Ed, Edd, Ede, Echnk, Type, Data, P, Size, Label) \
   {							\
@@ -364,6 +603,11 @@ static int _eet_data_words_bigendian = -1;
 #define EET_I_INLINED_STRING	2 << 4
 #define EET_I_NULL		3 << 4
 
+/* float and double written as their IEEE bits, in little endian, see
+ * eet_data_descriptor_float_ieee_set() */
+#define EET_I_FLOAT_IEEE	(EET_I_LIMIT + (4 << 4))
+#define EET_I_DOUBLE_IEEE	(EET_I_LIMIT + (5 << 4))
+
 #define EET_MAGIC_VARIANT 0xF1234BC
 /*---*/
 
@@ -381,18 +625,15 @@ eet_data_get_char(const Eet_Dictionary *ed __UNUSED__, const void *src, const vo
    return sizeof(char);
 }
 
-static void *
-eet_data_put_char(Eet_Dictionary *ed __UNUSED__, const void *src, int *size_ret)
+static int
+eet_data_put_char(Eet_Dictionary *ed __UNUSED__, const void *src, Eet_Data_Stream *ds)
 {
-   char *s, *d;
+   char d;
 
-   d = (char *)malloc(sizeof(char));
-   if (!d) return NULL;
-   s = (char *)src;
-   *d = *s;
-   CONV8(*d);
-   *size_ret = sizeof(char);
-   return d;
+   d = *(const char *)src;
+   CONV8(d);
+   eet_data_stream_write(ds, &d, sizeof(char));
+   return sizeof(char);
 }
 
 /* SHORT TYPE */
@@ -408,18 +649,15 @@ eet_data_get_short(const Eet_Dictionary *ed __UNUSED__, const void *src, const v
    return sizeof(short);
 }
 
-static void *
-eet_data_put_short(Eet_Dictionary *ed __UNUSED__, const void *src, int *size_ret)
+static int
+eet_data_put_short(Eet_Dictionary *ed __UNUSED__, const void *src, Eet_Data_Stream *ds)
 {
-   short *s, *d;
+   short d;
 
-   d = (short *)malloc(sizeof(short));
-   if (!d) return NULL;
-   s = (short *)src;
-   *d = *s;
-   CONV16(*d);
-   *size_ret = sizeof(short);
-   return d;
+   memcpy(&d, src, sizeof(short));
+   CONV16(d);
+   eet_data_stream_write(ds, &d, sizeof(short));
+   return sizeof(short);
 }
 
 /* INT TYPE */
@@ -435,18 +673,15 @@ eet_data_get_int(const Eet_Dictionary *ed __UNUSED__, const void *src, const voi
    return sizeof(int);
 }
 
-static void *
-eet_data_put_int(Eet_Dictionary *ed __UNUSED__, const void *src, int *size_ret)
+static int
+eet_data_put_int(Eet_Dictionary *ed __UNUSED__, const void *src, Eet_Data_Stream *ds)
 {
-   int *s, *d;
+   int d;
 
-   d = (int *)malloc(sizeof(int));
-   if (!d) return NULL;
-   s = (int *)src;
-   *d = *s;
-   CONV32(*d);
-   *size_ret = sizeof(int);
-   return d;
+   memcpy(&d, src, sizeof(int));
+   CONV32(d);
+   eet_data_stream_write(ds, &d, sizeof(int));
+   return sizeof(int);
 }
 
 /* LONG LONG TYPE */
@@ -462,18 +697,15 @@ eet_data_get_long_long(const Eet_Dictionary *ed __UNUSED__, const void *src, con
    return sizeof(unsigned long long);
 }
 
-static void *
-eet_data_put_long_long(Eet_Dictionary *ed __UNUSED__, const void *src, int *size_ret)
+static int
+eet_data_put_long_long(Eet_Dictionary *ed __UNUSED__, const void *src, Eet_Data_Stream *ds)
 {
-   unsigned long long *s, *d;
+   unsigned long long d;
 
-   d = (unsigned long long *)malloc(sizeof(unsigned long long));
-   if (!d) return NULL;
-   s = (unsigned long long *)src;
-   *d = *s;
-   CONV64(*d);
-   *size_ret = sizeof(unsigned long long);
-   return d;
+   memcpy(&d, src, sizeof(unsigned long long));
+   CONV64(d);
+   eet_data_stream_write(ds, &d, sizeof(unsigned long long));
+   return sizeof(unsigned long long);
 }
 
 /* STRING TYPE */
@@ -525,34 +757,28 @@ eet_data_get_string(const Eet_Dictionary *ed, const void *src, const void *src_e
    return strlen(s) + 1;
 }
 
-static void *
-eet_data_put_string(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_string(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
-   char *s, *d;
+   const char *s;
    int len;
 
+   s = *((const char **) src);
+   if (!s) return -1;
+
    if (ed)
      {
-        const char      *str;
         int              idx;
 
-        str = *((const char **) src);
-        if (!str) return NULL;
-
-        idx = eet_dictionary_string_add(ed, str);
-        if (idx == -1) return NULL;
+        idx = eet_dictionary_string_add(ed, s);
+        if (idx == -1) return -1;
 
-        return eet_data_put_int(ed, &idx, size_ret);
+        return eet_data_put_int(ed, &idx, ds);
      }
 
-   s = (char *)(*((char **)src));
-   if (!s) return NULL;
-   len = strlen(s);
-   d = malloc(len + 1);
-   if (!d) return NULL;
-   memcpy(d, s, len + 1);
-   *size_ret = len + 1;
-   return d;
+   len = strlen(s) + 1;
+   eet_data_stream_write(ds, s, len);
+   return len;
 }
 
 /* ALWAYS INLINED STRING TYPE */
@@ -562,10 +788,10 @@ eet_data_get_istring(const Eet_Dictionary *ed __UNUSED__, const void *src, const
    return eet_data_get_string(NULL, src, src_end, dst);
 }
 
-static void *
-eet_data_put_istring(Eet_Dictionary *ed __UNUSED__, const void *src, int *size_ret)
+static int
+eet_data_put_istring(Eet_Dictionary *ed __UNUSED__, const void *src, Eet_Data_Stream *ds)
 {
-   return eet_data_put_string(NULL, src, size_ret);
+   return eet_data_put_string(NULL, src, ds);
 }
 
 /* ALWAYS NULL TYPE */
@@ -580,11 +806,10 @@ eet_data_get_null(const Eet_Dictionary *ed __UNUSED__, const void *src __UNUSED_
    return 1;
 }
 
-static void *
-eet_data_put_null(Eet_Dictionary *ed __UNUSED__, const void *src __UNUSED__, int *size_ret)
+static int
+eet_data_put_null(Eet_Dictionary *ed __UNUSED__, const void *src __UNUSED__, Eet_Data_Stream *ds __UNUSED__)
 {
-   *size_ret = 0;
-   return NULL;
+   return -1;
 }
 
 /**
@@ -662,8 +887,8 @@ eet_data_get_float(const Eet_Dictionary *ed, const void *src, const void *src_en
    return 1;
 }
 
-static void *
-eet_data_put_float(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_float(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
    char  buf[128];
    int   idx;
@@ -672,21 +897,17 @@ eet_data_put_float(Eet_Dictionary *ed, const void *src, int *size_ret)
 
    if (!ed)
      {
-        char    *d;
         int      len;
 
-        len = strlen(buf);
-        d = malloc(len + 1);
-        if (!d) return NULL;
-	memcpy(d, buf, len + 1);
-        *size_ret = len + 1;
-        return d;
+        len = strlen(buf) + 1;
+        eet_data_stream_write(ds, buf, len);
+        return len;
      }
 
    idx = eet_dictionary_string_add(ed, buf);
-   if (idx == -1) return NULL;
+   if (idx == -1) return -1;
 
-   return eet_data_put_int(ed, &idx, size_ret);
+   return eet_data_put_int(ed, &idx, ds);
 }
 
 /* DOUBLE TYPE */
@@ -725,8 +946,8 @@ eet_data_get_double(const Eet_Dictionary *ed, const void *src, const void *src_e
    return 1;
 }
 
-static void *
-eet_data_put_double(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_double(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
    char  buf[128];
    int   idx;
@@ -735,22 +956,17 @@ eet_data_put_double(Eet_Dictionary *ed, const void *src, int *size_ret)
 
    if (!ed)
      {
-        char   *d;
-        int     len;
-
-        len = strlen(buf);
-        d = malloc(len + 1);
-        if (!d) return NULL;
-	memcpy(d, buf, len + 1);
-        *size_ret = len + 1;
+        int      len;
 
-        return d;
+        len = strlen(buf) + 1;
+        eet_data_stream_write(ds, buf, len);
+        return len;
      }
 
    idx = eet_dictionary_string_add(ed, buf);
-   if (idx == -1) return NULL;
+   if (idx == -1) return -1;
 
-   return eet_data_put_int(ed, &idx, size_ret);
+   return eet_data_put_int(ed, &idx, ds);
 }
 
 static int
@@ -783,8 +999,8 @@ eet_data_get_f32p32(const Eet_Dictionary *ed, const void *src, const void *src_e
    return 1;
 }
 
-static void *
-eet_data_put_f32p32(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_f32p32(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
    char  buf[128];
    int   idx;
@@ -793,22 +1009,17 @@ eet_data_put_f32p32(Eet_Dictionary *ed, const void *src, int *size_ret)
 
    if (!ed)
      {
-	char *d;
-	int len;
-
-	len = strlen(buf);
-	d = malloc(len + 1);
-	if (!d) return NULL;
-	memcpy(d, buf, len + 1);
-	*size_ret = len + 1;
+        int      len;
 
-	return d;
+        len = strlen(buf) + 1;
+        eet_data_stream_write(ds, buf, len);
+        return len;
      }
 
    idx = eet_dictionary_string_add(ed, buf);
-   if (idx == -1) return NULL;
+   if (idx == -1) return -1;
 
-   return eet_data_put_int(ed, &idx, size_ret);
+   return eet_data_put_int(ed, &idx, ds);
 }
 
 static int
@@ -825,13 +1036,13 @@ eet_data_get_f16p16(const Eet_Dictionary *ed, const void *src, const void *src_e
    return 1;
 }
 
-static void *
-eet_data_put_f16p16(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_f16p16(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
    Eina_F32p32 tmp;
 
    tmp = eina_f16p16_to_f32p32((Eina_F16p16)(*(Eina_F16p16 *)src));
-   return eet_data_put_f32p32(ed, &tmp, size_ret);
+   return eet_data_put_f32p32(ed, &tmp, ds);
 }
 
 static int
@@ -848,13 +1059,13 @@ eet_data_get_f8p24(const Eet_Dictionary *ed, const void *src, const void *src_en
    return 1;
 }
 
-static void *
-eet_data_put_f8p24(Eet_Dictionary *ed, const void *src, int *size_ret)
+static int
+eet_data_put_f8p24(Eet_Dictionary *ed, const void *src, Eet_Data_Stream *ds)
 {
    Eina_F32p32 tmp;
 
    tmp = eina_f8p24_to_f32p32((Eina_F8p24)(*(Eina_F8p24 *)src));
-   return eet_data_put_f32p32(ed, &tmp, size_ret);
+   return eet_data_put_f32p32(ed, &tmp, ds);
 }
 
 static inline int
@@ -866,12 +1077,13 @@ eet_data_get_type(const Eet_Dictionary *ed, int type, const void *src, const voi
    return ret;
 }
 
-static inline void *
-eet_data_put_type(Eet_Dictionary *ed, int type, const void *src, int *size_ret)
+/* write a simple type straight in the stream, -1 if there is nothing to write */
+static inline int
+eet_data_put_type(Eet_Dictionary *ed, int type, const void *src, Eet_Data_Stream *ds)
 {
-   void *ret;
+   int ret;
 
-   ret = eet_basic_codec[type - 1].put(ed, src, size_ret);
+   ret = eet_basic_codec[type - 1].put(ed, src, ds);
    return ret;
 }
 
@@ -908,6 +1120,70 @@ eet_data_type_match(int type1, int type2)
    return EINA_FALSE;
 }
 
+/* integers as their size in bytes, negated when they are signed */
+static inline int
+eet_data_type_int_width(int type)
+{
+   switch (type)
+     {
+      case EET_T_CHAR: return -1;
+      case EET_T_SHORT: return -2;
+      case EET_T_INT: return -4;
+      case EET_T_LONG_LONG: return -8;
+      case EET_T_UCHAR: return 1;
+      case EET_T_USHORT: return 2;
+      case EET_T_UINT: return 4;
+      case EET_T_ULONG_LONG: return 8;
+      default: return 0;
+     }
+}
+
+/* a value of type from always fits a member of the larger type to */
+static inline Eina_Bool
+eet_data_type_widen_match(int from, int to)
+{
+   int wfrom, wto;
+
+   if (from == EET_T_FLOAT && to == EET_T_DOUBLE) return EINA_TRUE;
+
+   wfrom = eet_data_type_int_width(from);
+   wto = eet_data_type_int_width(to);
+   if (!wfrom || !wto) return EINA_FALSE;
+
+   if (wto > 0) return wfrom > 0 && wto > wfrom;
+   if (wfrom < 0) wfrom = -wfrom;
+   return -wto > wfrom;
+}
+
+static void
+eet_data_type_widen(int from, const void *src, int to, void *dst)
+{
+   long long v;
+
+   switch (from)
+     {
+      case EET_T_FLOAT: *(double *)dst = *(const float *)src; return;
+      case EET_T_CHAR: v = *(const signed char *)src; break;
+      case EET_T_SHORT: v = *(const short *)src; break;
+      case EET_T_INT: v = *(const int *)src; break;
+      case EET_T_UCHAR: v = *(const unsigned char *)src; break;
+      case EET_T_USHORT: v = *(const unsigned short *)src; break;
+      case EET_T_UINT: v = *(const unsigned int *)src; break;
+      default: return;
+     }
+
+   switch (to)
+     {
+      case EET_T_SHORT: *(short *)dst = v; break;
+      case EET_T_INT: *(int *)dst = v; break;
+      case EET_T_LONG_LONG: *(long long *)dst = v; break;
+      case EET_T_USHORT: *(unsigned short *)dst = v; break;
+      case EET_T_UINT: *(unsigned int *)dst = v; break;
+      case EET_T_ULONG_LONG: *(unsigned long long *)dst = v; break;
+      default: break;
+     }
+}
+
 /* chunk format...
  *
  * char[4] = "CHnK"; // untyped data ... or
@@ -921,6 +1197,91 @@ eet_data_type_match(int type1, int type2)
  *
  */
 
+/* the type byte following "CHK" in a chunk head, -1 if it can't be encoded */
+static int
+eet_data_chunk_type_encode(int type, int group_type)
+{
+   /* Note: Another security, so older eet library could read file
+    saved with fixed point value. */
+   if (type == EET_T_F32P32
+       || type == EET_T_F16P16
+       || type == EET_T_F8P24)
+     type = EET_T_DOUBLE;
+
+   if (type != EET_T_UNKNOW)
+     {
+	if (group_type != EET_G_UNKNOWN)
+	  {
+	     int t = EET_I_LIMIT + group_type - EET_G_UNKNOWN;
+
+	     switch (type)
+	       {
+		  /* Only make sense with pointer type. */
+#define EET_MATCH_TYPE(Type) \
+		  case EET_T_##Type: t += EET_I_##Type; break;
+
+		  EET_MATCH_TYPE(STRING);
+		  EET_MATCH_TYPE(INLINED_STRING);
+		  EET_MATCH_TYPE(NULL);
+		default:
+		   return -1;
+	       }
+
+	     return t;
+	  }
+	return type;
+     }
+   return group_type;
+}
+
+static Eina_Bool
+eet_data_chunk_type_decode(unsigned char chunk_type, Eet_Data_Chunk *chnk)
+{
+   chnk->ieee = 0;
+   switch (chunk_type)
+     {
+      case EET_I_FLOAT_IEEE:
+      case EET_I_DOUBLE_IEEE:
+	 chnk->type = chunk_type == EET_I_FLOAT_IEEE ? EET_T_FLOAT : EET_T_DOUBLE;
+	 chnk->group_type = EET_G_UNKNOWN;
+	 chnk->ieee = 1;
+	 return EINA_TRUE;
+      default:
+	 break;
+     }
+
+   chnk->type = chunk_type;
+   if (chnk->type >= EET_I_LIMIT)
+     {
+	chnk->group_type = ((chnk->type - EET_I_LIMIT) & 0xF) + EET_G_UNKNOWN;
+	switch ((chnk->type - EET_I_LIMIT) & 0xF0)
+	  {
+#define EET_UNMATCH_TYPE(Type) \
+	     case EET_I_##Type: chnk->type = EET_T_##Type; break;
+
+	     EET_UNMATCH_TYPE(STRING);
+	     EET_UNMATCH_TYPE(INLINED_STRING);
+	     EET_UNMATCH_TYPE(NULL);
+	   default:
+	      return EINA_FALSE;
+	  }
+     }
+   else if (chnk->type > EET_T_LAST)
+     {
+	chnk->group_type = chnk->type;
+	chnk->type = EET_T_UNKNOW;
+     }
+   else
+     chnk->group_type = EET_G_UNKNOWN;
+   if ((chnk->type >= EET_T_LAST) ||
+       (chnk->group_type >= EET_G_LAST))
+     {
+	chnk->type = 0;
+	chnk->group_type = 0;
+     }
+   return EINA_TRUE;
+}
+
 static inline void
 eet_data_chunk_get(const Eet_Dictionary *ed, Eet_Data_Chunk *chnk,
 		   const void *src, int size)
@@ -938,35 +1299,8 @@ eet_data_chunk_get(const Eet_Dictionary *ed, Eet_Data_Chunk *chnk,
 	if ((s[0] != 'C') || (s[1] != 'H') || (s[2] != 'K'))
 	  return;
 
-	chnk->type = (unsigned char)(s[3]);
-	if (chnk->type >= EET_I_LIMIT)
-	  {
-	     chnk->group_type = ((chnk->type - EET_I_LIMIT) & 0xF) + EET_G_UNKNOWN;
-	     switch ((chnk->type - EET_I_LIMIT) & 0xF0)
-	       {
-#define EET_UNMATCH_TYPE(Type) \
-		  case EET_I_##Type: chnk->type = EET_T_##Type; break;
-
-		  EET_UNMATCH_TYPE(STRING);
-		  EET_UNMATCH_TYPE(INLINED_STRING);
-		  EET_UNMATCH_TYPE(NULL);
-		default:
-		   return;
-	       }
-	  }
-	else if (chnk->type > EET_T_LAST)
-	  {
-	     chnk->group_type = chnk->type;
-	     chnk->type = EET_T_UNKNOW;
-	  }
-	else
-	  chnk->group_type = EET_G_UNKNOWN;
-	if ((chnk->type >= EET_T_LAST) ||
-	    (chnk->group_type >= EET_G_LAST))
-	  {
-	     chnk->type = 0;
-	     chnk->group_type = 0;
-	  }
+	if (!eet_data_chunk_type_decode((unsigned char)(s[3]), chnk))
+	  return;
      }
    else
      {
@@ -976,10 +1310,17 @@ eet_data_chunk_get(const Eet_Dictionary *ed, Eet_Data_Chunk *chnk,
    ret1 = eet_data_get_type(ed, EET_T_INT, (s + 4), (s + size), &(chnk->size));
 
    if (ret1 <= 0) return;
-   if ((chnk->size < 0) || ((chnk->size + 8) > size)) return;
+   /* size - 8 can't overflow as chnk->size + 8 would */
+   if ((chnk->size < 0) || (chnk->size > size - 8)) return;
    ret2 = eet_data_get_type(ed, EET_T_STRING, (s + 8), (s + size), &(chnk->name));
 
    if (ret2 <= 0) return;
+   /* the name is part of the chunk */
+   if (chnk->size < (ed ? (int) sizeof(int) : ret2))
+     {
+	chnk->name = NULL;
+	return;
+     }
 
    chnk->len = ret2;
 
@@ -1000,39 +1341,7 @@ eet_data_chunk_get(const Eet_Dictionary *ed, Eet_Data_Chunk *chnk,
    return;
 }
 
-static inline Eet_Data_Chunk *
-eet_data_chunk_new(void *data, int size, const char *name, int type, int group_type)
-{
-   Eet_Data_Chunk *chnk;
-
-   if (!name) return NULL;
-   chnk = calloc(1, sizeof(Eet_Data_Chunk));
-   if (!chnk) return NULL;
-
-   /* Note: Another security, so older eet library could read file
-    saved with fixed point value. */
-   if (type == EET_T_F32P32
-       || type == EET_T_F16P16
-       || type == EET_T_F8P24)
-     type = EET_T_DOUBLE;
-
-   chnk->name = strdup(name);
-   chnk->len = strlen(name) + 1;
-   chnk->size = size;
-   chnk->data = data;
-   chnk->type = type;
-   chnk->group_type = group_type;
-   return chnk;
-}
-
-static inline void
-eet_data_chunk_free(Eet_Data_Chunk *chnk)
-{
-   if (chnk->name) free(chnk->name);
-   free(chnk);
-}
-
-static inline Eet_Data_Stream *
+EAPI Eet_Data_Stream *
 eet_data_stream_new(void)
 {
    Eet_Data_Stream *ds;
@@ -1042,13 +1351,34 @@ eet_data_stream_new(void)
    return ds;
 }
 
-static inline void
+EAPI void
 eet_data_stream_free(Eet_Data_Stream *ds)
 {
+   if (!ds) return;
    if (ds->data) free(ds->data);
    free(ds);
 }
 
+EAPI void
+eet_data_stream_reset(Eet_Data_Stream *ds)
+{
+   if (!ds) return;
+   ds->pos = 0;
+}
+
+EAPI const void *
+eet_data_stream_data_get(const Eet_Data_Stream *ds, int *size_ret)
+{
+   if (!ds)
+     {
+	if (size_ret) *size_ret = 0;
+	return NULL;
+     }
+
+   if (size_ret) *size_ret = ds->pos;
+   return ds->data;
+}
+
 static inline void
 eet_data_stream_flush(Eet_Data_Stream *ds)
 {
@@ -1062,29 +1392,36 @@ eet_data_stream_write(Eet_Data_Stream *ds, const void *data, int size)
 
    if ((ds->pos + size) > ds->size)
      {
-	ds->data = realloc(ds->data, ds->size + size + 512);
-	if (!ds->data)
+	int new_size;
+
+	/* double it, so encoding a large structure doesn't copy it over and over */
+	new_size = ds->size * 2;
+	if (new_size < ds->pos + size + 512)
+	  new_size = ds->pos + size + 512;
+
+	p = realloc(ds->data, new_size);
+	if (!p)
 	  {
+	     free(ds->data);
+	     ds->data = NULL;
 	     ds->pos = 0;
 	     ds->size = 0;
 	     return;
 	  }
-	ds->size = ds->size + size + 512;
+	ds->data = p;
+	ds->size = new_size;
      }
    p = ds->data;
    memcpy(p + ds->pos, data, size);
    ds->pos += size;
 }
 
-static void
-eet_data_chunk_put(Eet_Dictionary *ed, Eet_Data_Chunk *chnk, Eet_Data_Stream *ds)
+/* open a chunk in place, its size is patched by eet_data_chunk_close().
+ * return the position of the chunk in the stream or -1 if nothing was written */
+static int
+eet_data_chunk_open(Eet_Dictionary *ed, Eet_Data_Stream *ds, const char *name, int type, int group_type)
 {
-   int  *size;
-   void *string;
-   int   s;
-   int   size_ret = 0;
-   int   string_ret = 0;
-   unsigned char buf[4] = "CHK";
+   int chunk_type;
 
    /* disable this check - it will allow empty chunks to be written. this is
     * right for corner-cases when y have a struct with empty fields (empty
@@ -1093,142 +1430,402 @@ eet_data_chunk_put(Eet_Dictionary *ed, Eet_Data_Chunk *chnk, Eet_Data_Stream *ds
    /* chunk head */
 
 /*   eet_data_stream_write(ds, "CHnK", 4);*/
-   if (chnk->type != EET_T_UNKNOW)
-     {
-	if (chnk->group_type != EET_G_UNKNOWN)
-	  {
-	     int type = EET_I_LIMIT + chnk->group_type - EET_G_UNKNOWN;
+   chunk_type = eet_data_chunk_type_encode(type, group_type);
+   if (chunk_type < 0) return -1;
 
-	     switch (chnk->type)
-	       {
-		  /* Only make sense with pointer type. */
-#define EET_MATCH_TYPE(Type) \
-		  case EET_T_##Type: type += EET_I_##Type; break;
+   return eet_data_chunk_code_open(ed, ds, name, chunk_type);
+}
 
-		  EET_MATCH_TYPE(STRING);
-		  EET_MATCH_TYPE(INLINED_STRING);
-		  EET_MATCH_TYPE(NULL);
-		default:
-		   return ;
-	       }
+/* same as eet_data_chunk_open, with the type byte already encoded */
+static int
+eet_data_chunk_code_open(Eet_Dictionary *ed, Eet_Data_Stream *ds, const char *name, int chunk_type)
+{
+   unsigned char buf[8] = "CHK";
+   int start;
 
-	     buf[3] = type;
-	  }
-	else
-	  buf[3] = chnk->type;
+   if (!name) return -1;
+
+   buf[3] = chunk_type;
+
+   /* magic and room for the chunk length */
+   start = ds->pos;
+   eet_data_stream_write(ds, buf, 8);
+
+   /* write chunk name */
+   if (eet_data_put_string(ed, &name, ds) < 0)
+     {
+	ds->pos = start;
+	return -1;
      }
-   else buf[3] = chnk->group_type;
 
-   string = eet_data_put_string(ed, &chnk->name, &string_ret);
-   if (!string)
-     return ;
+   return start;
+}
+
+/* write the length of the chunk opened at start, now that its payload is in */
+static void
+eet_data_chunk_close(Eet_Data_Stream *ds, int start)
+{
+   int size;
+
+   if (!ds->data || ds->pos < start + 8) return;
 
    /* size of chunk payload data + name */
-   s = chnk->size + string_ret;
-   size = eet_data_put_int(ed, &s, &size_ret);
+   size = ds->pos - start - 8;
+   CONV32(size);
+   memcpy(((char *)ds->data) + start + 4, &size, sizeof(int));
+}
 
-   /* FIXME: If something goes wrong the resulting file will be corrupted. */
-   if (!size)
-     goto on_error;
+static void
+eet_data_encode(Eet_Dictionary *ed, Eet_Data_Stream *ds, const void *data, const char *name, int size, int type, int group_type)
+{
+   int start;
+
+   if (!data) type = EET_T_NULL;
 
-   eet_data_stream_write(ds, buf, 4);
+   if (group_type != EET_G_UNKNOWN)
+     if (type >= EET_T_LAST)
+       type = EET_T_UNKNOW;
 
-   /* write chunk length */
-   eet_data_stream_write(ds, size, size_ret);
+   start = eet_data_chunk_open(ed, ds, name, type, group_type);
+   if (start < 0) return;
 
-   /* write chunk name */
-   eet_data_stream_write(ds, string, string_ret);
+   if (data) eet_data_stream_write(ds, data, size);
+   eet_data_chunk_close(ds, start);
+}
 
-   /* write payload */
-   if (chnk->data)
-     eet_data_stream_write(ds, chnk->data, chnk->size);
+/* same as eet_data_encode, but the payload is a simple type of put_type put
+ * straight in the stream. return EINA_FALSE if nothing was written */
+static Eina_Bool
+eet_data_encode_type(Eet_Dictionary *ed, Eet_Data_Stream *ds, int put_type, const void *src, const char *name, int type, int group_type)
+{
+   int start;
 
-   free(string);
- on_error:
-   free(size);
+   /* nothing to write, don't even name the chunk */
+   if (put_type == EET_T_NULL) return EINA_FALSE;
+   if (IS_POINTER_TYPE(put_type) && !*((const char * const *)src)) return EINA_FALSE;
+
+   if (group_type != EET_G_UNKNOWN)
+     if (type >= EET_T_LAST)
+       type = EET_T_UNKNOW;
+
+   start = eet_data_chunk_open(ed, ds, name, type, group_type);
+   if (start < 0) return EINA_FALSE;
+
+   if (eet_data_put_type(ed, put_type, src, ds) < 0)
+     {
+	ds->pos = start;
+	return EINA_FALSE;
+     }
+
+   eet_data_chunk_close(ds, start);
+   return EINA_TRUE;
+}
+
+/* the type byte of the chunk written for a member described by ede */
+static int
+eet_data_element_chunk_type(const Eet_Data_Descriptor *edd, const Eet_Data_Element *ede)
+{
+   if (edd->float_ieee && ede->group_type == EET_G_UNKNOWN)
+     {
+	if (ede->type == EET_T_FLOAT) return EET_I_FLOAT_IEEE;
+	if (ede->type == EET_T_DOUBLE) return EET_I_DOUBLE_IEEE;
+     }
+
+   return eet_data_chunk_type_encode(ede->type, ede->group_type);
+}
+
+/* a float or double chunk holding the IEEE bits of the value */
+static Eina_Bool
+eet_data_encode_ieee(Eet_Dictionary *ed, Eet_Data_Stream *ds, int type, const void *src, const char *name)
+{
+   int start;
+
+   if (type == EET_T_FLOAT)
+     {
+	unsigned int v;
+
+	start = eet_data_chunk_code_open(ed, ds, name, EET_I_FLOAT_IEEE);
+	if (start < 0) return EINA_FALSE;
+
+	memcpy(&v, src, sizeof (v));
+	CONV32(v);
+	eet_data_stream_write(ds, &v, sizeof (v));
+     }
+   else
+     {
+	unsigned long long v;
+
+	start = eet_data_chunk_code_open(ed, ds, name, EET_I_DOUBLE_IEEE);
+	if (start < 0) return EINA_FALSE;
+
+	memcpy(&v, src, sizeof (v));
+	CONV64(v);
+	eet_data_stream_write(ds, &v, sizeof (v));
+     }
+
+   eet_data_chunk_close(ds, start);
+   return EINA_TRUE;
+}
+
+/* read the simple value held by chnk as type, text and dictionary encoded
+ * floating points are parsed, IEEE ones are only converted */
+static int
+eet_data_chunk_value_get(const Eet_Dictionary *ed, const Eet_Data_Chunk *chnk, int type, void *dest)
+{
+   double d;
+
+   if (!chnk->ieee)
+     return eet_data_get_type(ed, type, chnk->data, ((char *)chnk->data) + chnk->size, dest);
+
+   if (chnk->type == EET_T_FLOAT)
+     {
+	unsigned int v;
+	float f;
+
+	if (chnk->size < (int) sizeof (v)) return -1;
+	memcpy(&v, chnk->data, sizeof (v));
+	CONV32(v);
+	memcpy(&f, &v, sizeof (f));
+	d = f;
+     }
+   else
+     {
+	unsigned long long v;
+
+	if (chnk->size < (int) sizeof (v)) return -1;
+	memcpy(&v, chnk->data, sizeof (v));
+	CONV64(v);
+	memcpy(&d, &v, sizeof (d));
+     }
+
+   switch (type)
+     {
+      case EET_T_FLOAT:
+	 *(float *)dest = (float) d;
+	 break;
+      case EET_T_DOUBLE:
+	 *(double *)dest = d;
+	 break;
+      case EET_T_F32P32:
+	 *(Eina_F32p32 *)dest = eina_f32p32_double_from(d);
+	 break;
+      case EET_T_F16P16:
+	 *(Eina_F16p16 *)dest = eina_f32p32_to_f16p16(eina_f32p32_double_from(d));
+	 break;
+      case EET_T_F8P24:
+	 *(Eina_F8p24 *)dest = eina_f32p32_to_f8p24(eina_f32p32_double_from(d));
+	 break;
+      default:
+	 return -1;
+     }
+
+   return 1;
+}
+
+/* same as eet_data_encode, but the payload is the struct chunk of edd
+ * encoded straight in the stream. return EINA_FALSE if nothing was written */
+static Eina_Bool
+eet_data_encode_struct(Eet_Dictionary *ed, Eet_Data_Stream *ds, Eet_Data_Descriptor *edd, const void *data_in, const char *name, int type, int group_type)
+{
+   int start;
+
+   if (group_type != EET_G_UNKNOWN)
+     if (type >= EET_T_LAST)
+       type = EET_T_UNKNOW;
+
+   start = eet_data_chunk_open(ed, ds, name, type, group_type);
+   if (start < 0) return EINA_FALSE;
+
+   if (!_eet_data_descriptor_encode_stream(ed, edd, data_in, ds))
+     {
+	ds->pos = start;
+	return EINA_FALSE;
+     }
+
+   eet_data_chunk_close(ds, start);
+   return EINA_TRUE;
 }
 
 /*---*/
 
+/* The table is at most half full, so probing always ends on an empty
+ * slot. The 8 bits hash dictionary strings come with spreads the similar
+ * names of large descriptors too poorly, names are hashed again. */
 static void
 _eet_descriptor_hash_new(Eet_Data_Descriptor *edd)
 {
+   int mask;
    int i;
 
    edd->elements.hash.size = 1 << 6;
-   edd->elements.hash.buckets = calloc(1, sizeof(Eet_Data_Descriptor_Hash) * edd->elements.hash.size);
+   while (edd->elements.hash.size < edd->elements.num * 2)
+     edd->elements.hash.size <<= 1;
+   edd->elements.hash.buckets = calloc(edd->elements.hash.size, sizeof(Eet_Data_Descriptor_Hash));
+   if (!edd->elements.hash.buckets) return ;
+
+   mask = edd->elements.hash.size - 1;
    for (i = 0; i < edd->elements.num; i++)
      {
 	Eet_Data_Element *ede;
-	int hash;
+	unsigned int hash;
+	int len;
+	int j;
 
 	ede = &(edd->elements.set[i]);
-	hash = _eet_hash_gen((char *) ede->name, 6);
-	if (!edd->elements.hash.buckets[hash].element)
-	  edd->elements.hash.buckets[hash].element = ede;
-	else
-	  {
-	     Eet_Data_Descriptor_Hash *bucket;
-
-	     bucket = calloc(1, sizeof(Eet_Data_Descriptor_Hash));
-	     bucket->element = ede;
-	     bucket->next = edd->elements.hash.buckets[hash].next;
-	     edd->elements.hash.buckets[hash].next = bucket;
-	  }
+	len = strlen(ede->name) + 1;
+	hash = _eet_data_schema_hash_add(2166136261U, ede->name, len);
+	for (j = hash & mask; edd->elements.hash.buckets[j].element; j = (j + 1) & mask)
+	  ;
+	edd->elements.hash.buckets[j].element = ede;
+	edd->elements.hash.buckets[j].hash = hash;
+	edd->elements.hash.buckets[j].len = len;
      }
 }
 
 static void
 _eet_descriptor_hash_free(Eet_Data_Descriptor *edd)
 {
+   if (edd->elements.hash.buckets) free(edd->elements.hash.buckets);
+   edd->elements.hash.buckets = NULL;
+   edd->elements.hash.size = 0;
+}
+
+/* len is the chunk len of name, with its nul */
+static Eet_Data_Element *
+_eet_descriptor_hash_find(Eet_Data_Descriptor *edd, const char *name, int len)
+{
+   Eet_Data_Descriptor_Hash *bucket;
+   unsigned int hash;
+   int mask;
    int i;
 
-   for (i = 0; i < edd->elements.hash.size; i++)
+   if (!edd->elements.hash.buckets) return NULL;
+   mask = edd->elements.hash.size - 1;
+   hash = _eet_data_schema_hash_add(2166136261U, name, len);
+
+   for (i = hash & mask; edd->elements.hash.buckets[i].element; i = (i + 1) & mask)
      {
-	Eet_Data_Descriptor_Hash *bucket, *pbucket;
+	bucket = edd->elements.hash.buckets + i;
+	if (bucket->hash == hash
+	    && bucket->len == len
+	    && !memcmp(bucket->element->name, name, len))
+	  return bucket->element;
+     }
+   return NULL;
+}
 
-	bucket = edd->elements.hash.buckets[i].next;
-	while (bucket)
-	  {
-	     pbucket = bucket;
-	     bucket = bucket->next;
-	     free(pbucket);
-	  }
+/*
+ * Decode plans: the encoder always writes the elements of a descriptor in
+ * the same order, so instead of hashing every chunk name, the decoder
+ * walks the element set along with the stream. A chunk whose type byte and
+ * name match the current step, or one of the few next ones when elements
+ * were skipped, is decoded straight away. Anything else goes through
+ * _eet_descriptor_hash_find, which is cheaper than walking a large
+ * descriptor to the end. Names are compared by content, the plan does
+ * not depend on the dictionary.
+ */
+#define EET_DATA_DECODE_PLAN_SKIP 8
+
+static Eet_Data_Decode_Plan *
+_eet_data_decode_plan_new(Eet_Data_Descriptor *edd)
+{
+   Eet_Data_Decode_Plan *plan;
+   int i;
+
+   if (edd->elements.num <= 0) return NULL;
+
+   plan = malloc(sizeof (Eet_Data_Decode_Plan) + sizeof (Eet_Data_Decode_Step) * (edd->elements.num - 1));
+   if (!plan) return NULL;
+
+   plan->num = edd->elements.num;
+   for (i = 0; i < plan->num; i++)
+     {
+	Eet_Data_Decode_Step *step = plan->steps + i;
+	Eet_Data_Chunk chnk;
+
+	memset(&chnk, 0, sizeof (Eet_Data_Chunk));
+	step->ede = &(edd->elements.set[i]);
+	step->name_len = strlen(step->ede->name) + 1;
+	step->chunk_type = eet_data_element_chunk_type(edd, step->ede);
+	if (step->chunk_type < 0
+	    || !eet_data_chunk_type_decode(step->chunk_type, &chnk))
+	  step->chunk_type = -1;
+	step->type = chnk.type;
+	step->group_type = chnk.group_type;
+	step->ieee = chnk.ieee;
      }
-   if (edd->elements.hash.buckets) free(edd->elements.hash.buckets);
+
+   return plan;
 }
 
 static Eet_Data_Element *
-_eet_descriptor_hash_find(Eet_Data_Descriptor *edd, char *name, int hash)
+_eet_data_decode_plan_match(Eet_Data_Decode_Plan *plan, int *cursor,
+			    const Eet_Dictionary *ed, Eet_Data_Chunk *chnk,
+			    const char *src, int size)
 {
-   Eet_Data_Descriptor_Hash *bucket;
+   Eet_Data_Decode_Step *step;
+   const char *name = NULL;
+   int name_len = 0;
+   int end;
+   int i;
 
-   if (hash < 0) hash = _eet_hash_gen(name, 6);
-   else hash &= 0x3f;
-   if (!edd->elements.hash.buckets[hash].element) return NULL;
-   /*
-     When we use the dictionnary as a source for chunk name, we will always
-     have the same pointer in name. It's a good idea to just compare pointer
-     instead of running strcmp on both string.
-   */
-   if (edd->elements.hash.buckets[hash].element->directory_name_ptr == name)
-     return edd->elements.hash.buckets[hash].element;
-   if (!strcmp(edd->elements.hash.buckets[hash].element->name, name))
+   if (size <= 8) return NULL;
+   if ((src[0] != 'C') || (src[1] != 'H') || (src[2] != 'K')) return NULL;
+   if (eet_data_get_int(ed, src + 4, src + size, &chnk->size) <= 0) return NULL;
+   if ((chnk->size < 0) || (chnk->size > size - 8)) return NULL;
+   if (ed)
      {
-	edd->elements.hash.buckets[hash].element->directory_name_ptr = name;
-	return edd->elements.hash.buckets[hash].element;
+	int name_id;
+
+	if (chnk->size < (int) sizeof(int)) return NULL;
+	if (eet_data_get_int(ed, src + 8, src + size, &name_id) <= 0) return NULL;
+	name = eet_dictionary_string_get_char(ed, name_id);
+	if (!name) return NULL;
+	name_len = eet_dictionary_string_get_size(ed, name_id);
      }
-   bucket = edd->elements.hash.buckets[hash].next;
-   while (bucket)
+
+   end = *cursor + EET_DATA_DECODE_PLAN_SKIP;
+   if (end > plan->num) end = plan->num;
+   for (i = *cursor; i < end; i++)
      {
-	if (bucket->element->directory_name_ptr == name) return bucket->element;
-	if (!strcmp(bucket->element->name, name))
+	step = plan->steps + i;
+
+	if (step->chunk_type != (unsigned char)src[3]) continue;
+	if (ed)
+	  {
+	     if (step->name_len != name_len
+		 || memcmp(name, step->ede->name, name_len) != 0)
+	       continue;
+	  }
+	else
+	  {
+	     if (step->name_len > chnk->size
+		 || memcmp(src + 8, step->ede->name, step->name_len) != 0)
+	       continue;
+	  }
+
+	*cursor = i;
+	chnk->type = step->type;
+	chnk->group_type = step->group_type;
+	chnk->ieee = step->ieee;
+	chnk->hash = -1;
+	if (ed)
 	  {
-	     bucket->element->directory_name_ptr = name;
-	     return bucket->element;
+	     chnk->name = (char *)name;
+	     chnk->len = name_len;
+	     chnk->data = (char *)src + 8 + sizeof(int);
+	     chnk->size -= sizeof(int);
 	  }
-	bucket = bucket->next;
+	else
+	  {
+	     chnk->name = (char *)src + 8;
+	     chnk->len = step->name_len;
+	     chnk->data = (char *)src + 8 + chnk->len;
+	     chnk->size -= chnk->len;
+	  }
+	return step->ede;
      }
+
    return NULL;
 }
 
@@ -1350,7 +1947,6 @@ _eet_data_descriptor_new(const Eet_Data_Descriptor_Class *eddc, int version)
    if (!edd) return NULL;
 
    edd->name = eddc->name;
-   edd->ed = NULL;
    edd->size = eddc->size;
    edd->func.mem_alloc = _eet_mem_alloc;
    edd->func.mem_free = _eet_mem_free;
@@ -1445,12 +2041,124 @@ eet_data_descriptor_file_new(const Eet_Data_Descriptor_Class *eddc)
 EAPI void
 eet_data_descriptor_free(Eet_Data_Descriptor *edd)
 {
+   Eet_Data_Translation *tr;
+   int i;
+
    if (!edd) return ;
    _eet_descriptor_hash_free(edd);
+   free(edd->plan);
+   EINA_LIST_FREE(edd->translations, tr)
+     {
+	for (i = 0; i < tr->num; i++)
+	  eina_stringshare_del(tr->steps[i].name);
+	free(tr);
+     }
    if (edd->elements.set) free(edd->elements.set);
    free(edd);
 }
 
+EAPI void
+eet_data_descriptor_compact_set(Eet_Data_Descriptor *edd, Eina_Bool compact)
+{
+   if (!edd) return ;
+   edd->compact = !!compact;
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_compact_get(const Eet_Data_Descriptor *edd)
+{
+   if (!edd) return EINA_FALSE;
+   return edd->compact;
+}
+
+EAPI void
+eet_data_descriptor_columnar_set(Eet_Data_Descriptor *edd, Eina_Bool columnar)
+{
+   if (!edd) return ;
+   edd->columnar = !!columnar;
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_columnar_get(const Eet_Data_Descriptor *edd)
+{
+   if (!edd) return EINA_FALSE;
+   return edd->columnar;
+}
+
+EAPI void
+eet_data_descriptor_float_ieee_set(Eet_Data_Descriptor *edd, Eina_Bool ieee)
+{
+   int i;
+
+   if (!edd) return ;
+   edd->float_ieee = !!ieee;
+
+   /* lists and hashes of floats go through an implicit structure */
+   for (i = 0; i < edd->elements.num; i++)
+     if (edd->elements.set[i].subtype
+	 && edd->elements.set[i].subtype->implicit)
+       eet_data_descriptor_float_ieee_set(edd->elements.set[i].subtype, ieee);
+
+   /* the plan expects the chunk type byte written so far */
+   _eet_data_descriptor_update(edd);
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_previous_add(Eet_Data_Descriptor *edd, const Eet_Data_Descriptor *previous)
+{
+   Eet_Data_Translation *tr;
+   Eina_List *l;
+   int num;
+   int i;
+
+   if (!edd || !previous) return EINA_FALSE;
+   if (strcmp(edd->name, previous->name)) return EINA_FALSE;
+   if (previous->schema_hash == edd->schema_hash) return EINA_TRUE;
+   EINA_LIST_FOREACH(edd->translations, l, tr)
+     if (tr->schema_hash == previous->schema_hash)
+       return EINA_TRUE;
+
+   num = previous->elements.num;
+   tr = malloc(sizeof (Eet_Data_Translation) + sizeof (Eet_Data_Translation_Step) * (num > 0 ? num - 1 : 0));
+   if (!tr) return EINA_FALSE;
+
+   tr->schema_hash = previous->schema_hash;
+   tr->num = num;
+   for (i = 0; i < num; i++)
+     {
+	Eet_Data_Element *ede = &(previous->elements.set[i]);
+
+	tr->steps[i].name = eina_stringshare_add(ede->name);
+	tr->steps[i].type = ede->type;
+	tr->steps[i].group_type = ede->group_type;
+     }
+   _eet_data_translation_resolve(edd, tr);
+
+   edd->translations = eina_list_append(edd->translations, tr);
+   return EINA_TRUE;
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_float_ieee_get(const Eet_Data_Descriptor *edd)
+{
+   if (!edd) return EINA_FALSE;
+   return edd->float_ieee;
+}
+
+EAPI void
+eet_data_descriptor_borrow_set(Eet_Data_Descriptor *edd, Eina_Bool borrow)
+{
+   if (!edd) return ;
+   edd->borrow = !!borrow;
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_borrow_get(const Eet_Data_Descriptor *edd)
+{
+   if (!edd) return EINA_FALSE;
+   return edd->borrow;
+}
+
 EAPI void
 eet_data_descriptor_element_add(Eet_Data_Descriptor *edd,
 				const char *name,
@@ -1499,9 +2207,9 @@ eet_data_descriptor_element_add(Eet_Data_Descriptor *edd,
    tmp = realloc(edd->elements.set, edd->elements.num * sizeof(Eet_Data_Element));
    if (!tmp) return ;
    edd->elements.set = tmp;
+
    ede = &(edd->elements.set[edd->elements.num - 1]);
    ede->name = name;
-   ede->directory_name_ptr = NULL;
 
    /*
     * We do a special case when we do list,hash or whatever group of simple type.
@@ -1518,6 +2226,8 @@ eet_data_descriptor_element_add(Eet_Data_Descriptor *edd,
 	if (!subtype) return ;
 	subtype->name = "implicit";
 	subtype->size = eet_basic_codec[type - 1].size;
+	subtype->implicit = 1;
+	subtype->float_ieee = edd->float_ieee;
 	memcpy(&subtype->func, &edd->func, sizeof(subtype->func));
 
 	eet_data_descriptor_element_add(subtype, eet_basic_codec[type - 1].name, type,
@@ -1535,10 +2245,59 @@ eet_data_descriptor_element_add(Eet_Data_Descriptor *edd,
    ede->counter_name = counter_name;
 
    ede->subtype = subtype;
+
+   /* the hash and the plan point into the element set */
+   _eet_data_descriptor_update(edd);
 }
 
-EAPI void *
-eet_data_read_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key)
+/* Everything decoding looks up is derived here from the elements and
+ * flags, once they change, so that decoding only ever reads a descriptor
+ * and any number of threads can share it. */
+static void
+_eet_data_descriptor_update(Eet_Data_Descriptor *edd)
+{
+   Eet_Data_Translation *tr;
+   Eina_List *l;
+
+   _eet_descriptor_hash_free(edd);
+   _eet_descriptor_hash_new(edd);
+
+   free(edd->plan);
+   edd->plan = _eet_data_decode_plan_new(edd);
+
+   edd->schema_hash = _eet_data_descriptor_schema_hash(edd);
+
+   EINA_LIST_FOREACH(edd->translations, l, tr)
+     _eet_data_translation_resolve(edd, tr);
+}
+
+/* Map the elements of a previous version to the ones they are read into
+ * now, by name. Values whose type changed and can't be widened are
+ * dropped like the ones of removed elements. */
+static void
+_eet_data_translation_resolve(Eet_Data_Descriptor *edd, Eet_Data_Translation *tr)
+{
+   int i;
+
+   for (i = 0; i < tr->num; i++)
+     {
+	Eet_Data_Translation_Step *step = tr->steps + i;
+	Eet_Data_Element *ede;
+
+	step->index = -1;
+	ede = _eet_descriptor_hash_find(edd, step->name, strlen(step->name) + 1);
+	if (!ede || ede->group_type != step->group_type) continue;
+	if (ede->type != step->type
+	    && !(step->group_type == EET_G_UNKNOWN
+		 && eet_data_type_widen_match(step->type, ede->type)))
+	  continue;
+
+	step->index = ede - edd->elements.set;
+     }
+}
+
+static void *
+_eet_data_read(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key, Eet_Data_Arena *arena)
 {
    const Eet_Dictionary *ed = NULL;
    const void           *data = NULL;
@@ -1559,13 +2318,36 @@ eet_data_read_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, c
      }
 
    memset(&context, 0, sizeof (context));
+   context.arena = arena;
+   context.borrow = !required_free;
+   context.file = !arena && edd && edd->borrow
+     && eet_mode_get(ef) == EET_FILE_MODE_READ;
    data_dec = _eet_data_descriptor_decode(&context, ed, edd, data, size);
+   if (data_dec && context.file)
+     {
+	/* strings point in the file, or in the buffer it now keeps */
+	eet_file_borrow(ef, required_free ? (void*) data : NULL);
+	required_free = 0;
+     }
    if (required_free)
      free((void*)data);
 
    return data_dec;
 }
 
+EAPI void *
+eet_data_read_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key)
+{
+   return _eet_data_read(ef, edd, name, cipher_key, NULL);
+}
+
+EAPI void *
+eet_data_read_arena(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, Eet_Data_Arena *arena)
+{
+   if (!edd || !arena) return NULL;
+   return _eet_data_read(ef, edd, name, NULL, arena);
+}
+
 EAPI Eet_Node *
 eet_data_node_read_cipher(Eet_File *ef, const char *name, const char *cipher_key)
 {
@@ -1624,64 +2406,31 @@ eet_data_write(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const v
    return eet_data_write_cipher(ef, edd, name, NULL, data, compress);
 }
 
-static int
-_eet_free_hash(void *data)
+static void
+_eet_free_add(Eet_Free *ef, void *data)
 {
-   unsigned long ptr = (unsigned long)(data);
-   int hash;
-
-   hash = ptr;
-   hash ^= ptr >> 8;
-   hash ^= ptr >> 16;
-   hash ^= ptr >> 24;
+   if (ef->num == ef->len)
+     {
+        void    **tmp;
+	int       len;
 
-#if LONG_BIT != 32
-   hash ^= ptr >> 32;
-   hash ^= ptr >> 40;
-   hash ^= ptr >> 48;
-   hash ^= ptr >> 56;
-#endif
+	len = ef->len ? ef->len * 2 : 64;
+        tmp = realloc(ef->list, len * sizeof(void*));
+        if (!tmp) return ;
 
-   return hash & 0xFF;
-}
-
-static void
-_eet_free_add(Eet_Free *ef, void *data)
-{
-   int hash;
-   int i;
-
-   hash = _eet_free_hash(data);
-
-   for (i = 0; i < ef->num[hash]; ++i)
-     if (ef->list[hash][i] == data) return;
-
-   ef->num[hash]++;
-   if (ef->num[hash] > ef->len[hash])
-     {
-        void    **tmp;
-
-        tmp = realloc(ef->list[hash], (ef->len[hash] + 16) * sizeof(void*));
-        if (!tmp) return ;
-
-        ef->len[hash] += 16;
-        ef->list[hash] = tmp;
-     }
-   ef->list[hash][ef->num[hash] - 1] = data;
+        ef->len = len;
+        ef->list = tmp;
+     }
+   ef->list[ef->num++] = data;
 }
 static void
 _eet_free_reset(Eet_Free *ef)
 {
-   int i;
-
    if (ef->ref > 0) return ;
-   for (i = 0; i < 256; ++i)
-     {
-	ef->len[i] = 0;
-	ef->num[i] = 0;
-	if (ef->list[i]) free(ef->list[i]);
-	ef->list[i] = NULL;
-     }
+   ef->len = 0;
+   ef->num = 0;
+   if (ef->list) free(ef->list);
+   ef->list = NULL;
 }
 static void
 _eet_free_ref(Eet_Free *ef)
@@ -1694,7 +2443,7 @@ _eet_free_unref(Eet_Free *ef)
    ef->ref--;
 }
 
-#define _eet_freelist_add(Ctx, Data)	_eet_free_add(&Ctx->freelist, Data);
+#define _eet_freelist_add(Ctx, Data)	do { if (!Ctx->arena) _eet_free_add(&Ctx->freelist, Data); } while (0)
 #define _eet_freelist_reset(Ctx)	_eet_free_reset(&Ctx->freelist);
 #define _eet_freelist_ref(Ctx)		_eet_free_ref(&Ctx->freelist);
 #define _eet_freelist_unref(Ctx)	_eet_free_unref(&Ctx->freelist);
@@ -1702,22 +2451,20 @@ _eet_free_unref(Eet_Free *ef)
 static void
 _eet_freelist_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 {
-   int j;
    int i;
 
    if (context->freelist.ref > 0) return;
-   for (j = 0; j < 256; ++j)
-     for (i = 0; i < context->freelist.num[j]; ++i)
+   for (i = context->freelist.num - 1; i >= 0; --i)
        {
 	  if (edd)
-	    edd->func.mem_free(context->freelist.list[j][i]);
+	    edd->func.mem_free(context->freelist.list[i]);
 	  else
-	    free(context->freelist.list[j][i]);
+	    free(context->freelist.list[i]);
        }
    _eet_free_reset(&context->freelist);
 }
 
-#define _eet_freelist_list_add(Ctx, Data)  _eet_free_add(&Ctx->freelist_list, Data);
+#define _eet_freelist_list_add(Ctx, Data)  do { if (!Ctx->arena) _eet_free_add(&Ctx->freelist_list, Data); } while (0)
 #define _eet_freelist_list_reset(Ctx)      _eet_free_reset(&Ctx->freelist_list);
 #define _eet_freelist_list_ref(Ctx)        _eet_free_ref(&Ctx->freelist_list);
 #define _eet_freelist_list_unref(Ctx)      _eet_free_unref(&Ctx->freelist_list);
@@ -1725,20 +2472,18 @@ _eet_freelist_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 static void
 _eet_freelist_list_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 {
-   int j;
    int i;
 
    if (context->freelist_list.ref > 0) return;
-   for (j = 0; j < 256; ++j)
-     for (i = 0; i < context->freelist_list.num[j]; ++i)
+   for (i = context->freelist_list.num - 1; i >= 0; --i)
        {
 	  if (edd)
-	    edd->func.list_free(*((void**)(context->freelist_list.list[j][i])));
+	    edd->func.list_free(*((void**)(context->freelist_list.list[i])));
        }
    _eet_free_reset(&context->freelist_list);
 }
 
-#define _eet_freelist_str_add(Ctx, Data)   _eet_free_add(&Ctx->freelist_str, Data);
+#define _eet_freelist_str_add(Ctx, Data)   do { if (!Ctx->arena) _eet_free_add(&Ctx->freelist_str, Data); } while (0)
 #define _eet_freelist_str_reset(Ctx)       _eet_free_reset(&Ctx->freelist_str);
 #define _eet_freelist_str_ref(Ctx)         _eet_free_ref(&Ctx->freelist_str);
 #define _eet_freelist_str_unref(Ctx)       _eet_free_unref(&Ctx->freelist_str);
@@ -1746,22 +2491,20 @@ _eet_freelist_list_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 static void
 _eet_freelist_str_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 {
-   int j;
    int i;
 
    if (context->freelist_str.ref > 0) return;
-   for (j = 0; j < 256; ++j)
-     for (i = 0; i < context->freelist_str.num[j]; ++i)
+   for (i = context->freelist_str.num - 1; i >= 0; --i)
        {
 	  if (edd)
-	    edd->func.str_free(context->freelist_str.list[j][i]);
+	    edd->func.str_free(context->freelist_str.list[i]);
 	  else
-	    free(context->freelist_str.list[j][i]);
+	    free(context->freelist_str.list[i]);
        }
    _eet_free_reset(&context->freelist_str);
 }
 
-#define _eet_freelist_direct_str_add(Ctx, Data)    _eet_free_add(&Ctx->freelist_direct_str, Data);
+#define _eet_freelist_direct_str_add(Ctx, Data)    do { if (!Ctx->arena) _eet_free_add(&Ctx->freelist_direct_str, Data); } while (0)
 #define _eet_freelist_direct_str_reset(Ctx)        _eet_free_reset(&Ctx->freelist_direct_str);
 #define _eet_freelist_direct_str_ref(Ctx)          _eet_free_ref(&Ctx->freelist_direct_str);
 #define _eet_freelist_direct_str_unref(Ctx)        _eet_free_unref(&Ctx->freelist_direct_str);
@@ -1769,22 +2512,20 @@ _eet_freelist_str_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 static void
 _eet_freelist_direct_str_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 {
-   int j;
    int i;
 
    if (context->freelist_direct_str.ref > 0) return;
-   for (j = 0; j < 256; ++j)
-     for (i = 0; i < context->freelist_direct_str.num[j]; ++i)
+   for (i = context->freelist_direct_str.num - 1; i >= 0; --i)
        {
 	  if (edd)
-	    edd->func.str_direct_free(context->freelist_direct_str.list[j][i]);
+	    edd->func.str_direct_free(context->freelist_direct_str.list[i]);
 	  else
-	    free(context->freelist_direct_str.list[j][i]);
+	    free(context->freelist_direct_str.list[i]);
        }
    _eet_free_reset(&context->freelist_direct_str);
 }
 
-#define _eet_freelist_hash_add(Ctx, Data) _eet_free_add(&Ctx->freelist_hash, Data);
+#define _eet_freelist_hash_add(Ctx, Data) do { if (!Ctx->arena) _eet_free_add(&Ctx->freelist_hash, Data); } while (0)
 #define _eet_freelist_hash_reset(Ctx)     _eet_free_reset(&Ctx->freelist_hash);
 #define _eet_freelist_hash_ref(Ctx)	  _eet_free_ref(&Ctx->freelist_hash);
 #define _eet_freelist_hash_unref(Ctx)	  _eet_free_unref(&Ctx->freelist_hash);
@@ -1792,17 +2533,15 @@ _eet_freelist_direct_str_free(Eet_Free_Context *context, Eet_Data_Descriptor *ed
 static void
 _eet_freelist_hash_free(Eet_Free_Context *context, Eet_Data_Descriptor *edd)
 {
-   int j;
    int i;
 
    if (context->freelist_hash.ref > 0) return;
-   for (j = 0; j < 256; ++j)
-     for (i = 0; i < context->freelist_hash.num[j]; ++i)
+   for (i = context->freelist_hash.num - 1; i >= 0; --i)
        {
 	  if (edd)
-	    edd->func.hash_free(context->freelist_hash.list[j][i]);
+	    edd->func.hash_free(context->freelist_hash.list[i]);
 	  else
-	    free(context->freelist_hash.list[j][i]);
+	    free(context->freelist_hash.list[i]);
        }
    _eet_free_reset(&context->freelist_hash);
 }
@@ -1827,6 +2566,176 @@ _eet_freelist_all_unref(Eet_Free_Context *freelist_context)
    _eet_freelist_direct_str_unref(freelist_context);
 }
 
+/* Arena blocks start small and double up to 1MB, anything bigger than a
+ * quarter of the next block gets a block of its own. Blocks come from
+ * calloc, so like _eet_mem_alloc every allocation is zeroed. */
+#define EET_DATA_ARENA_ALIGN       sizeof(double)
+#define EET_DATA_ARENA_HEADER      ((sizeof(Eet_Data_Arena_Block) + 15) & ~15)
+#define EET_DATA_ARENA_BLOCK_MIN   4096
+#define EET_DATA_ARENA_BLOCK_MAX   (1024 * 1024)
+
+static void *
+_eet_data_arena_alloc(Eet_Data_Arena *arena, size_t size, size_t align)
+{
+   Eet_Data_Arena_Block *block;
+   size_t offset;
+
+   block = arena->blocks;
+   if (block)
+     {
+	offset = (block->used + align - 1) & ~(align - 1);
+	if (offset + size <= block->size)
+	  {
+	     block->used = offset + size;
+	     return ((char *)block) + offset;
+	  }
+     }
+
+   if (arena->next_size < EET_DATA_ARENA_BLOCK_MIN)
+     arena->next_size = EET_DATA_ARENA_BLOCK_MIN;
+
+   if (size > arena->next_size / 4)
+     {
+	block = calloc(1, EET_DATA_ARENA_HEADER + size);
+	if (!block) return NULL;
+	block->size = EET_DATA_ARENA_HEADER + size;
+	block->used = block->size;
+
+	/* Keep filling the current block. */
+	if (arena->blocks)
+	  {
+	     block->next = arena->blocks->next;
+	     arena->blocks->next = block;
+	  }
+	else
+	  arena->blocks = block;
+
+	return ((char *)block) + EET_DATA_ARENA_HEADER;
+     }
+
+   block = calloc(1, arena->next_size);
+   if (!block) return NULL;
+   block->size = arena->next_size;
+   block->used = EET_DATA_ARENA_HEADER + size;
+   block->next = arena->blocks;
+   arena->blocks = block;
+
+   if (arena->next_size < EET_DATA_ARENA_BLOCK_MAX)
+     arena->next_size *= 2;
+
+   return ((char *)block) + EET_DATA_ARENA_HEADER;
+}
+
+static Eina_Bool
+_eet_data_arena_container_add(Eet_Data_Arena *arena, void **ptr,
+			      void *(*list_free) (void *l),
+			      void (*hash_free) (void *h))
+{
+   Eet_Data_Arena_Container *container;
+
+   if (arena->containers_num == arena->containers_size)
+     {
+	int size;
+
+	size = arena->containers_size ? arena->containers_size * 2 : 64;
+	container = realloc(arena->containers, size * sizeof (Eet_Data_Arena_Container));
+	if (!container) return EINA_FALSE;
+
+	arena->containers = container;
+	arena->containers_size = size;
+     }
+
+   container = arena->containers + arena->containers_num++;
+   container->ptr = ptr;
+   container->list_free = list_free;
+   container->hash_free = hash_free;
+
+   return EINA_TRUE;
+}
+
+static void *
+_eet_data_mem_alloc(Eet_Free_Context *context, Eet_Data_Descriptor *edd, size_t size)
+{
+   if (context->arena)
+     return _eet_data_arena_alloc(context->arena, size, EET_DATA_ARENA_ALIGN);
+   return edd->func.mem_alloc(size);
+}
+
+/* direct tells that str comes from the dictionary, it is then shared when
+ * the descriptor allows it. */
+static char *
+_eet_data_str_alloc(Eet_Free_Context *context, const Eet_Dictionary *ed,
+		    Eet_Data_Descriptor *edd, const char *str, Eina_Bool direct)
+{
+   char *result;
+
+   if (context->arena)
+     {
+	size_t len;
+
+	if ((direct && ed) || context->borrow)
+	  return (char *)str;
+
+	len = strlen(str) + 1;
+	result = _eet_data_arena_alloc(context->arena, len, 1);
+	if (result) memcpy(result, str, len);
+	return result;
+     }
+
+   if (context->file)
+     return (char *)str;
+
+   if (direct && ed && edd->func.str_direct_alloc)
+     {
+	result = edd->func.str_direct_alloc(str);
+	_eet_freelist_direct_str_add(context, result);
+     }
+   else
+     {
+	result = edd->func.str_alloc(str);
+	_eet_freelist_str_add(context, result);
+     }
+
+   return result;
+}
+
+EAPI Eet_Data_Arena *
+eet_data_arena_new(void)
+{
+   return calloc(1, sizeof (Eet_Data_Arena));
+}
+
+EAPI void
+eet_data_arena_free(Eet_Data_Arena *arena)
+{
+   Eet_Data_Arena_Block *block;
+   int i;
+
+   if (!arena) return ;
+
+   /* Containers first, their heads live in the blocks. */
+   for (i = arena->containers_num - 1; i >= 0; --i)
+     {
+	Eet_Data_Arena_Container *container = arena->containers + i;
+
+	if (!*container->ptr) continue ;
+	if (container->list_free)
+	  container->list_free(*container->ptr);
+	else if (container->hash_free)
+	  container->hash_free(*container->ptr);
+     }
+   free(arena->containers);
+
+   while (arena->blocks)
+     {
+	block = arena->blocks;
+	arena->blocks = block->next;
+	free(block);
+     }
+
+   free(arena);
+}
+
 static int
 eet_data_descriptor_encode_hash_cb(void *hash __UNUSED__, const char *cipher_key, void *hdata, void *fdata)
 {
@@ -1834,9 +2743,6 @@ eet_data_descriptor_encode_hash_cb(void *hash __UNUSED__, const char *cipher_key
    Eet_Data_Encode_Hash_Info    *edehi;
    Eet_Data_Stream              *ds;
    Eet_Data_Element             *ede;
-   Eet_Data_Chunk               *echnk;
-   void                         *data = NULL;
-   int                           size;
 
    edehi = fdata;
    ede = edehi->ede;
@@ -1844,143 +2750,51 @@ eet_data_descriptor_encode_hash_cb(void *hash __UNUSED__, const char *cipher_key
    ed = edehi->ed;
 
    /* Store key */
-   data = eet_data_put_type(ed,
-                            EET_T_STRING,
-			    &cipher_key,
-			    &size);
-   if (data)
-     {
-	echnk = eet_data_chunk_new(data, size, ede->name, ede->type, ede->group_type);
-	eet_data_chunk_put(ed, echnk, ds);
-	eet_data_chunk_free(echnk);
-	free(data);
-	data = NULL;
-     }
+   eet_data_encode_type(ed, ds, EET_T_STRING, &cipher_key,
+			ede->name, ede->type, ede->group_type);
 
    EET_ASSERT(!((ede->type > EET_T_UNKNOW) && (ede->type < EET_T_STRING)), return );
 
    /* Store data */
    if (ede->type >= EET_T_STRING)
      eet_data_put_unknown(ed, NULL, ede, ds, &hdata);
-   else
-     {
-	if (ede->subtype)
-	  data = _eet_data_descriptor_encode(ed,
-					     ede->subtype,
-					     hdata,
-					     &size);
-	if (data)
-	  {
-	     echnk = eet_data_chunk_new(data, size, ede->name, ede->type, ede->group_type);
-	     eet_data_chunk_put(ed, echnk, ds);
-	     eet_data_chunk_free(echnk);
-	     free(data);
-	     data = NULL;
-	  }
-     }
+   else if (ede->subtype)
+     eet_data_encode_struct(ed, ds, ede->subtype, hdata,
+			    ede->name, ede->type, ede->group_type);
 
    return 1;
 }
 
-static char *
-_eet_data_dump_token_get(const char *src, int *len)
+/* an array of simple values, the way eet_data_put_array() packs it */
+static Eina_Bool
+_eet_data_dump_packed_encode(Eet_Dictionary *ed, Eet_Data_Stream *ds,
+			     Eet_Node *node, int type)
 {
-   const char *p;
-   char *tok = NULL;
-   int in_token = 0;
-   int in_quote = 0;
-   int tlen = 0, tsize = 0;
-
-#define TOK_ADD(x) \
-   { \
-      tlen++; \
-      if (tlen >= tsize) \
-	{ \
-	   tsize += 32; \
-	   tok = realloc(tok, tsize); \
-	} \
-      tok[tlen - 1] = x; \
-   }
-
-   for (p = src; *len > 0; p++, (*len)--)
-     {
-	if (in_token)
-	  {
-	     if (in_quote)
-	       {
-		  if ((p[0] == '\"') && (p > src) && (p[-1] != '\\'))
-		    {
-		       in_quote = 0;
-		    }
-		  else if ((p[0] == '\\') && (*len > 1) && (p[1] == '\"'))
-		    {
-		       /* skip */
-		    }
-		  else if ((p[0] == '\\') && (p > src) && (p[-1] == '\\'))
-		    {
-		       /* skip */
-		    }
-		  else if ((p[0] == '\\') && (*len > 1) && (p[1] == 'n'))
-		    {
-		       /* skip */
-		    }
-		  else if ((p[0] == 'n') && (p > src) && (p[-1] == '\\'))
-		    {
-		       TOK_ADD('\n');
-		    }
-		  else
-		    TOK_ADD(p[0]);
-	       }
-	     else
-	       {
-		  if (p[0] == '\"') in_quote = 1;
-		  else
-		    {
-		       if ((isspace(p[0])) || (p[0] == ';')) /* token ends here */
-			 {
-			    TOK_ADD(0);
-			    (*len)--;
-			    return tok;
-			 }
-		       else
-			 TOK_ADD(p[0]);
-		    }
-	       }
-	  }
-	else
-	  {
-	     if (!((isspace(p[0])) || (p[0] == ';')))
-	       {
-		  in_token = 1;
-		  (*len)++;
-		  p--;
-	       }
-	  }
-     }
-   if (in_token)
+   Eet_Node *n;
+   char *values;
+   int count = 0;
+   int width;
+   int i;
+
+   for (n = node->values; n; n = n->next)
      {
-	TOK_ADD(0);
-	return tok;
+	if (n->type != type && n->type != EET_T_NULL) return EINA_FALSE;
+	count++;
      }
-   if (tok) free(tok);
-   return NULL;
-}
+   if (count < node->count) count = node->count;
 
-static void
-eet_data_encode(Eet_Dictionary *ed, Eet_Data_Stream *ds, void *data, const char *name, int size, int type, int group_type)
-{
-   Eet_Data_Chunk *echnk;
+   width = eet_basic_codec[type - 1].size;
+   values = calloc(count, width);
+   if (!values) return EINA_FALSE;
 
-   if (!data) type = EET_T_NULL;
+   for (i = 0, n = node->values; n; n = n->next, i++)
+     if (n->type == type)
+       memcpy(values + i * width, &(n->data.value), width);
 
-   if (group_type != EET_G_UNKNOWN)
-     if (type >= EET_T_LAST)
-       type = EET_T_UNKNOW;
+   eet_data_put_packed_array(ed, ds, node->name, type, node->type, values, count);
+   free(values);
 
-   echnk = eet_data_chunk_new(data, size, name, type, group_type);
-   eet_data_chunk_put(ed, echnk, ds);
-   eet_data_chunk_free(echnk);
-   free(data);
+   return EINA_TRUE;
 }
 
 static void *
@@ -1989,10 +2803,10 @@ _eet_data_dump_encode(int parent_type,
                       Eet_Node *node,
 		      int *size_ret)
 {
-   Eet_Data_Chunk *chnk = NULL;
    Eet_Data_Stream *ds;
    void *cdata, *data;
-   int csize, size;
+   int size;
+   int start = -1;
    int count;
    int child_type;
    Eet_Node *n;
@@ -2014,6 +2828,9 @@ _eet_data_dump_encode(int parent_type,
    switch (node->type)
      {
       case EET_G_UNKNOWN:
+	start = eet_data_chunk_open(ed, ds, node->name, EET_T_UNKNOW, node->type);
+	if (start < 0) break;
+
 	for (n = node->values; n; n = n->next)
 	  {
 	     data = _eet_data_dump_encode(node->type, ed, n, &size);
@@ -2035,11 +2852,18 @@ _eet_data_dump_encode(int parent_type,
 	       }
 	  }
 
-	data = eet_data_put_type(ed,
-				 EET_T_INT,
-				 &node->count,
-				 &size);
-	eet_data_encode(ed, ds, data, node->name, size, child_type, node->type);
+	if (IS_PACKED_TYPE(child_type)
+	    && _eet_data_dump_packed_encode(ed, ds, node, child_type))
+	  {
+	     *size_ret = ds->pos;
+	     cdata = ds->data;
+
+	     eet_data_stream_flush(ds);
+
+	     return cdata;
+	  }
+
+	eet_data_encode_type(ed, ds, EET_T_INT, &node->count, node->name, child_type, node->type);
 
 	count = node->count;
 
@@ -2051,14 +2875,14 @@ _eet_data_dump_encode(int parent_type,
 	       {
 		case EET_T_STRING:
 		case EET_T_INLINED_STRING:
-		   data = eet_data_put_type(ed, n->type, &(n->data.value.str), &size);
-		   if (data) eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   eet_data_encode_type(ed, ds, n->type, &(n->data.value.str), node->name, n->type, node->type);
 		   break;
 		case EET_T_NULL:
 		   continue;
 		default:
 		   data = _eet_data_dump_encode(n->type, ed, n, &size);
 		   eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   free(data);
 		   break;
 	       }
 	     if (ds->pos != pos) count--;
@@ -2073,9 +2897,7 @@ _eet_data_dump_encode(int parent_type,
 	*size_ret = ds->pos;
 	cdata = ds->data;
 
-	ds->data = NULL;
-	ds->size = 0;
-	eet_data_stream_free(ds);
+	eet_data_stream_flush(ds);
 
 	return cdata;
 	break;
@@ -2086,14 +2908,14 @@ _eet_data_dump_encode(int parent_type,
 	       {
 		case EET_T_STRING:
 		case EET_T_INLINED_STRING:
-		   data = eet_data_put_type(ed, n->type, &(n->data.value.str), &size);
-		   if (data) eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   eet_data_encode_type(ed, ds, n->type, &(n->data.value.str), node->name, n->type, node->type);
 		   break;
 		case EET_T_NULL:
 		   continue;
 		default:
 		   data = _eet_data_dump_encode(node->type, ed, n, &size);
 		   eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   free(data);
 	       }
 	  }
 
@@ -2101,24 +2923,21 @@ _eet_data_dump_encode(int parent_type,
 	*size_ret = ds->pos;
 	cdata = ds->data;
 
-	ds->data = NULL;
-	ds->size = 0;
-	eet_data_stream_free(ds);
+	eet_data_stream_flush(ds);
 
 	return cdata;
 	break;
       case EET_G_HASH:
 	if (node->key)
 	  {
-	     data = eet_data_put_type(ed,
-                                      EET_T_STRING,
-				      &node->key,
-				      &size);
-	     eet_data_encode(ed, ds, data, node->name, size, node->type, node->type);
+	     eet_data_encode_type(ed, ds, EET_T_STRING, &node->key, node->name, node->type, node->type);
 	  }
 	else
-	  /* A Hash without key will not decode correctly. */
-	  return NULL;
+	  {
+	     /* A Hash without key will not decode correctly. */
+	     eet_data_stream_free(ds);
+	     return NULL;
+	  }
 
 	for (n = node->values; n; n = n->next)
 	  {
@@ -2126,14 +2945,14 @@ _eet_data_dump_encode(int parent_type,
 	       {
 		case EET_T_STRING:
 		case EET_T_INLINED_STRING:
-		   data = eet_data_put_type(ed, n->type, &(n->data.value.str), &size);
-		   if (data) eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   eet_data_encode_type(ed, ds, n->type, &(n->data.value.str), node->name, n->type, node->type);
 		   break;
 		case EET_T_NULL:
 		   continue;
 		default:
 		   data = _eet_data_dump_encode(node->type, ed, n, &size);
 		   eet_data_encode(ed, ds, data, node->name, size, n->type, node->type);
+		   free(data);
 	       }
 	  }
 
@@ -2149,10 +2968,9 @@ _eet_data_dump_encode(int parent_type,
 
 #define EET_DATA_NODE_ENCODE(Eet_Type, Type)				\
       case Eet_Type:							\
-	data = eet_data_put_type(ed, node->type, &(node->data.value.Type), &size); \
-        if (data)								\
+        if (eet_data_encode_type(ed, ds, node->type, &(node->data.value.Type), \
+				 node->name, node->type, parent_type))	\
 	  {								\
-	     eet_data_encode(ed, ds, data, node->name, size, node->type, parent_type); \
 	     cdata = ds->data;						\
 	     *size_ret = ds->pos;					\
 	     eet_data_stream_flush(ds);					\
@@ -2176,1485 +2994,5182 @@ _eet_data_dump_encode(int parent_type,
 	break;
      }
 
-   if ((node->type >= EET_G_UNKNOWN) && (node->type < EET_G_LAST))
-     chnk = eet_data_chunk_new(ds->data, ds->pos, node->name, EET_T_UNKNOW, node->type);
-   else
-     chnk = eet_data_chunk_new(ds->data, ds->pos, node->name, node->type, EET_G_UNKNOWN);
-   eet_data_stream_flush(ds);
+   /* anything else is an empty chunk */
+   if (start < 0)
+     {
+	if ((node->type >= EET_G_UNKNOWN) && (node->type < EET_G_LAST))
+	  start = eet_data_chunk_open(ed, ds, node->name, EET_T_UNKNOW, node->type);
+	else
+	  start = eet_data_chunk_open(ed, ds, node->name, node->type, EET_G_UNKNOWN);
+     }
+   if (start >= 0) eet_data_chunk_close(ds, start);
 
-   ds = eet_data_stream_new();
-   eet_data_chunk_put(ed, chnk, ds);
    cdata = ds->data;
-   csize = ds->pos;
+   *size_ret = ds->pos;
 
    eet_data_stream_flush(ds);
-   *size_ret = csize;
-
-   free(chnk->data);
-   eet_data_chunk_free(chnk);
 
    return cdata;
 }
 
-static void *
-_eet_data_dump_parse(Eet_Dictionary *ed,
-                     int *size_ret,
-		     const char *src,
-		     int size)
+/*
+ * Text undump. The text is read once, each value is encoded as soon as it
+ * is read, in the chunks _eet_data_dump_encode() writes for the same node
+ * tree. Tokens point in the text, only names and strings are copied, once
+ * unescaped, in buffers reused for the whole text.
+ */
+#define EET_DATA_UNDUMP_IS(Token, Str) \
+  ((Token).len == sizeof (Str) - 1 && !memcmp((Token).s, Str, sizeof (Str) - 1))
+
+static const struct {
+   const char *name;
+   int         type;
+} _eet_data_undump_types[] = {
+     { "char:",        EET_T_CHAR           },
+     { "short:",       EET_T_SHORT          },
+     { "int:",         EET_T_INT            },
+     { "long_long:",   EET_T_LONG_LONG      },
+     { "float:",       EET_T_FLOAT          },
+     { "double:",      EET_T_DOUBLE         },
+     { "uchar:",       EET_T_UCHAR          },
+     { "ushort:",      EET_T_USHORT         },
+     { "uint:",        EET_T_UINT           },
+     { "ulong_long:",  EET_T_ULONG_LONG     },
+     { "string:",      EET_T_STRING         },
+     { "inlined:",     EET_T_INLINED_STRING },
+     { "null",         EET_T_NULL           }
+};
+
+static Eina_Bool
+_eet_data_undump_error(Eet_Data_Undump *u, const char *at, const char *msg)
 {
-   void *cdata = NULL;
-   const char *p = NULL;
-#define M_NONE 0
-#define M_STRUCT 1
-#define M_ 2
-   int left, jump;
-   Eet_Node *node_base = NULL;
-   Eet_Node *node = NULL;
-   Eet_Node *n = NULL, *nn = NULL;
-
-   /* FIXME; handle parse errors */
-#define TOK_GET(t) \
-   jump = left; t = _eet_data_dump_token_get(p, &left); p += jump - left;
-   left = size;
-   for (p = src; p < (src + size);)
-     {
-	char *tok1, *tok2, *tok3, *tok4;
-
-	TOK_GET(tok1);
-	if (tok1)
-	  {
-	     if (!strcmp(tok1, "group"))
-	       {
-		  TOK_GET(tok2);
-		  if (tok2)
-		    {
-		       TOK_GET(tok3);
-		       if (tok3)
-			 {
-			    TOK_GET(tok4);
-			    if (tok4)
-			      {
-				 if (!strcmp(tok4, "{"))
-				   {
-				      /* we have 'group NAM TYP {' */
-				      n = eet_node_new();
-				      if (n)
-					{
-					   n->parent = node;
-					   if (!node_base)
-					     {
-						node_base = n;
-					     }
-					   if (node)
-					     {
-						/* append node */
-						if (!node->values)
-						  node->values = n;
-						else
-						  {
-						     for (nn = node->values; nn; nn = nn->next)
-						       {
-							  if (!nn->next)
-							    {
-							       nn->next = n;
-							       break;
-							    }
-						       }
-						  }
-					     }
-					   n->name = eina_stringshare_add(tok2);
-					   if      (!strcmp(tok3, "struct"))    n->type = EET_G_UNKNOWN;
-					   else if (!strcmp(tok3, "array"))     n->type = EET_G_ARRAY;
-					   else if (!strcmp(tok3, "var_array")) n->type = EET_G_VAR_ARRAY;
-					   else if (!strcmp(tok3, "list"))      n->type = EET_G_LIST;
-					   else if (!strcmp(tok3, "hash"))      n->type = EET_G_HASH;
-					   else
-					     {
-					       ERR("ERROR: group type '%s' invalid.", tok3);
-					     }
-					   node = n;
-					}
-				   }
-				 free(tok4);
-			      }
-			    free(tok3);
-			 }
-		       free(tok2);
-		    }
-	       }
-	     else if (!strcmp(tok1, "value"))
-	       {
-		  TOK_GET(tok2);
-		  if (tok2)
-		    {
-		       TOK_GET(tok3);
-		       if (tok3)
-			 {
-			    TOK_GET(tok4);
-			    if (tok4)
-			      {
-				 /* we have 'value NAME TYP XXX' */
-				 if (node_base)
-				   {
-				      n = eet_node_new();
-				      if (n)
-					{
-					   n->parent = node;
-					   /* append node */
-					   if (!node->values)
-					     node->values = n;
-					   else
-					     {
-						for (nn = node->values; nn; nn = nn->next)
-						  {
-						     if (!nn->next)
-						       {
-							  nn->next = n;
-							  break;
-						       }
-						  }
-					     }
-					   n->name = eina_stringshare_add(tok2);
-					   if      (!strcmp(tok3, "char:"))
-					     {
-						n->type = EET_T_CHAR;
-						sscanf(tok4, "%hhi", &(n->data.value.c));
-					     }
-					   else if (!strcmp(tok3, "short:"))
-					     {
-						n->type = EET_T_SHORT;
-						sscanf(tok4, "%hi", &(n->data.value.s));
-					     }
-					   else if (!strcmp(tok3, "int:"))
-					     {
-						n->type = EET_T_INT;
-						sscanf(tok4, "%i", &(n->data.value.i));
-					     }
-					   else if (!strcmp(tok3, "long_long:"))
-					     {
-						n->type = EET_T_LONG_LONG;
-						sscanf(tok4, "%lli", &(n->data.value.l));
-					     }
-					   else if (!strcmp(tok3, "float:"))
-					     {
-						n->type = EET_T_FLOAT;
-						sscanf(tok4, "%f", &(n->data.value.f));
-					     }
-					   else if (!strcmp(tok3, "double:"))
-					     {
-						n->type = EET_T_DOUBLE;
-						sscanf(tok4, "%lf", &(n->data.value.d));
-					     }
-					   else if (!strcmp(tok3, "uchar:"))
-					     {
-						n->type = EET_T_UCHAR;
-						sscanf(tok4, "%hhu", &(n->data.value.uc));
-					     }
-					   else if (!strcmp(tok3, "ushort:"))
-					     {
-						n->type = EET_T_USHORT;
-						sscanf(tok4, "%hu", &(n->data.value.us));
-					     }
-					   else if (!strcmp(tok3, "uint:"))
-					     {
-						n->type = EET_T_UINT;
-						sscanf(tok4, "%u", &(n->data.value.ui));
-					     }
-					   else if (!strcmp(tok3, "ulong_long:"))
-					     {
-						n->type = EET_T_ULONG_LONG;
-						sscanf(tok4, "%llu", &(n->data.value.ul));
-					     }
-					   else if (!strcmp(tok3, "string:"))
-					     {
-						n->type = EET_T_STRING;
-						n->data.value.str = eina_stringshare_add(tok4);
-					     }
-					   else if (!strcmp(tok3, "inlined:"))
-					     {
-						n->type = EET_T_INLINED_STRING;
-						n->data.value.str = eina_stringshare_add(tok4);
-					     }
-					   else if (!strcmp(tok3, "null"))
-					     {
-						n->type = EET_T_NULL;
-						n->data.value.str = NULL;
-					     }
-					   else
-					     {
-						ERR("ERROR: value type '%s' invalid.", tok4);
-					     }
-					}
-				   }
-				 free(tok4);
-			      }
-			    free(tok3);
-			 }
-		       free(tok2);
-		    }
-	       }
-	     else if (!strcmp(tok1, "key"))
-	       {
-		  TOK_GET(tok2);
-		  if (tok2)
-		    {
-		       /* we have 'key NAME' */
-		       if (node)
-			 {
-			    node->key = eina_stringshare_add(tok2);
-			 }
-		       free(tok2);
-		    }
-	       }
-	     else if (!strcmp(tok1, "count"))
-	       {
-		  TOK_GET(tok2);
-		  if (tok2)
-		    {
-		       /* we have a 'count COUNT' */
-		       if (node)
-			 {
-			    sscanf(tok2, "%i", &(node->count));
-			 }
-		       free(tok2);
-		    }
-	       }
-	     else if (!strcmp(tok1, "}"))
-	       {
-		  /* we have an end of the group */
-		  if (node) node = node->parent;
-	       }
-	     free(tok1);
-	  }
+   const char *line;
+   const char *p;
+   int l;
+
+   /* only the first error means something */
+   if (u->error) return EINA_FALSE;
+   u->error = EINA_TRUE;
+
+   for (l = 1, line = p = u->src; p < at; p++)
+     if (*p == '\n')
+       {
+	  line = p + 1;
+	  l++;
+       }
+
+   ERR("Undump failed at line %i, column %i: %s.", l, (int) (at - line) + 1, msg);
+   return EINA_FALSE;
+}
+
+static Eina_Bool
+_eet_data_undump_token(Eet_Data_Undump *u, Eet_Data_Undump_Token *t)
+{
+   const char *p = u->p;
+   Eina_Bool quote = EINA_FALSE;
+
+   while (p < u->end && (*p == ';' || isspace((unsigned char) *p)))
+     p++;
+   /* a nul ends the text */
+   if (p == u->end || !*p)
+     {
+	u->p = u->end = p;
+	return EINA_FALSE;
      }
 
-   if (node_base)
+   t->s = p;
+   t->quoted = EINA_FALSE;
+   for (; p < u->end && *p; p++)
      {
-	cdata = _eet_data_dump_encode(EET_G_UNKNOWN, ed, node_base, size_ret);
-	eet_node_del(node_base);
+	if (quote)
+	  {
+	     if (*p == '\\' && p + 1 < u->end) p++;
+	     else if (*p == '\"') quote = EINA_FALSE;
+	  }
+	else if (*p == '\"')
+	  {
+	     quote = EINA_TRUE;
+	     t->quoted = EINA_TRUE;
+	  }
+	else if (*p == ';' || isspace((unsigned char) *p))
+	  break;
      }
-   return cdata;
+   if (quote)
+     return _eet_data_undump_error(u, t->s, "string not terminated");
+
+   t->len = p - t->s;
+   u->p = p;
+   return EINA_TRUE;
 }
 
-#define NEXT_CHUNK(P, Size, Echnk, Ed)                  \
-  {                                                     \
-     int        tmp;                                    \
-     tmp = Ed ? (int) (sizeof(int) * 2) : Echnk.len + 4;\
-     P += (4 + Echnk.size + tmp);                       \
-     Size -= (4 + Echnk.size + tmp);                    \
-  }
+/* the next token, any end of the text is an error */
+static Eina_Bool
+_eet_data_undump_token_need(Eet_Data_Undump *u, Eet_Data_Undump_Token *t)
+{
+   if (_eet_data_undump_token(u, t)) return EINA_TRUE;
+   return _eet_data_undump_error(u, u->p, "unexpected end of text");
+}
 
-static void *
-_eet_data_descriptor_decode(Eet_Free_Context *context,
-			    const Eet_Dictionary *ed,
-                            Eet_Data_Descriptor *edd,
-			    const void *data_in,
-			    int size_in)
+/* the text of t unquoted and unescaped, in the buffer i of u */
+static const char *
+_eet_data_undump_text(Eet_Data_Undump *u, const Eet_Data_Undump_Token *t, int i)
 {
-   Eet_Node *result = NULL;
-   void *data = NULL;
-   char *p;
-   int size, i;
-   Eet_Data_Chunk chnk;
+   const char *p;
+   const char *end;
+   Eina_Bool quote = EINA_FALSE;
+   char *d;
 
-   if (_eet_data_words_bigendian == -1)
+   if (t->len >= u->str_size[i])
      {
-	unsigned long int v;
-
-	v = htonl(0x12345678);
-	if (v == 0x12345678) _eet_data_words_bigendian = 1;
-	else _eet_data_words_bigendian = 0;
-     }
+	int size;
 
-   if (edd)
-     {
-	data = edd->func.mem_alloc(edd->size);
-	if (!data) return NULL;
-	if (edd->ed != ed)
+	size = u->str_size[i] * 2;
+	if (size <= t->len) size = t->len + 64;
+	d = realloc(u->str[i], size);
+	if (!d)
 	  {
-	     for (i = 0; i < edd->elements.num; i++)
-	       edd->elements.set[i].directory_name_ptr = NULL;
-	     edd->ed = ed;
+	     _eet_data_undump_error(u, t->s, "not enough memory");
+	     return NULL;
 	  }
+	u->str[i] = d;
+	u->str_size[i] = size;
      }
-   _eet_freelist_all_ref(context);
-   if (data) _eet_freelist_add(context, data);
-   memset(&chnk, 0, sizeof(Eet_Data_Chunk));
-   eet_data_chunk_get(ed, &chnk, data_in, size_in);
-   if (!chnk.name) goto error;
-   if (edd)
-     {
-	if (strcmp(chnk.name, edd->name)) goto error;
-     }
-   p = chnk.data;
-   if (ed)
-     size = size_in - (4 + sizeof(int) * 2);
-   else
-     size = size_in - (4 + 4 + chnk.len);
-   if (edd)
-     {
-	if (!edd->elements.hash.buckets) _eet_descriptor_hash_new(edd);
-     }
-   else
+
+   d = u->str[i];
+   if (!t->quoted)
      {
-	switch (chnk.group_type)
-	  {
-	   case EET_G_UNKNOWN:
-	      switch (chnk.type)
-		{
-		 case EET_T_STRING:
-		    return eet_node_string_new(chnk.name, chnk.data);
-		 case EET_T_INLINED_STRING:
-		    return eet_node_inlined_string_new(chnk.name, chnk.data);
-		 case EET_T_NULL:
-		    return eet_node_null_new(chnk.name);
-		 default:
-		    result = eet_node_struct_new(chnk.name, NULL);
-		}
-	      break;
-	   case EET_G_VAR_ARRAY:
-	      return eet_node_var_array_new(chnk.name, NULL);
-	   case EET_G_LIST:
-	   case EET_G_HASH:
-	   case EET_G_ARRAY:
-	   case EET_G_UNION:
-	   case EET_G_VARIANT:
-	   default:
-	      goto error;
-	  }
+	memcpy(d, t->s, t->len);
+	d[t->len] = '\0';
+	return d;
      }
-   while (size > 0)
-     {
-	Eet_Data_Chunk echnk;
-	Eet_Data_Element *ede = NULL;
-	Eet_Node *child = NULL;
-	int group_type = EET_G_UNKNOWN, type = EET_T_UNKNOW;
-	int ret = 0;
 
-	/* get next data chunk */
-	memset(&echnk, 0, sizeof(Eet_Data_Chunk));
-	eet_data_chunk_get(ed, &echnk, p, size);
-	if (!echnk.name) goto error;
-	/* FIXME: don't REPLY on edd - work without */
-	if (edd)
+   for (p = t->s, end = t->s + t->len; p < end; p++)
+     {
+	if (*p == '\"')
+	  quote = !quote;
+	else if (quote && *p == '\\' && p + 1 < end)
 	  {
-	     ede = _eet_descriptor_hash_find(edd, echnk.name, echnk.hash);
-	     if (ede)
-	       {
-		  group_type = ede->group_type;
-		  type = ede->type;
-		  if ((echnk.type == 0) && (echnk.group_type == 0))
-		    {
-		       type = ede->type;
-		       group_type = ede->group_type;
-		    }
-		  else
-		    {
-		       if (IS_SIMPLE_TYPE(echnk.type) &&
-			   eet_data_type_match(echnk.type, ede->type))
-			 /* Needed when converting on the fly from FP to Float */
-			 type = ede->type;
-		       else if ((echnk.group_type > EET_G_UNKNOWN) &&
-				(echnk.group_type < EET_G_LAST) &&
-				(echnk.group_type == ede->group_type))
-			 group_type = echnk.group_type;
-		    }
-	       }
+	     p++;
+	     *d++ = *p == 'n' ? '\n' : *p;
 	  }
-	/*...... dump to node */
 	else
-	  {
-	     type = echnk.type;
-	     group_type = echnk.group_type;
-	  }
+	  *d++ = *p;
+     }
+   *d = '\0';
 
-	if (!edd && group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(type))
-	  {
-	     unsigned char dd[128];
+   return u->str[i];
+}
 
-	     ret = eet_data_get_type(ed,
-				     type,
-				     echnk.data,
-				     ((char *)echnk.data) + echnk.size,
-				     dd);
-	     if (ret <= 0) goto error;
+/* the value of type written in t, strings are left in the buffer 1 of u */
+static Eina_Bool
+_eet_data_undump_value_get(Eet_Data_Undump *u, const Eet_Data_Undump_Token *t, int type, Eet_Node_Data *v)
+{
+   const char *s;
+   char *end;
 
-	     child = eet_data_node_simple_type(type, echnk.name, dd);
+   s = _eet_data_undump_text(u, t, 1);
+   if (!s) return EINA_FALSE;
 
-	     eet_node_struct_append(result, echnk.name, child);
-	  }
-	else
-	  {
-	     ret = eet_group_codec[group_type - 100].get(context,
-							 ed, edd, ede, &echnk,
-							 type, group_type, ede ? (void*) (((char *)data) + ede->offset) : (void**) &result,
-							 &p, &size);
+   /* the conversions of the scanf() formats the values were dumped with */
+   switch (type)
+     {
+      case EET_T_CHAR: v->value.c = strtol(s, &end, 0); break;
+      case EET_T_SHORT: v->value.s = strtol(s, &end, 0); break;
+      case EET_T_INT: v->value.i = strtol(s, &end, 0); break;
+      case EET_T_LONG_LONG: v->value.l = strtoll(s, &end, 0); break;
+      case EET_T_FLOAT: v->value.f = strtod(s, &end); break;
+      case EET_T_DOUBLE: v->value.d = strtod(s, &end); break;
+      case EET_T_UCHAR: v->value.uc = strtoul(s, &end, 10); break;
+      case EET_T_USHORT: v->value.us = strtoul(s, &end, 10); break;
+      case EET_T_UINT: v->value.ui = strtoul(s, &end, 10); break;
+      case EET_T_ULONG_LONG: v->value.ul = strtoull(s, &end, 10); break;
+      default:
+	 v->value.str = s;
+	 return EINA_TRUE;
+     }
 
-	     if (ret <= 0) goto error;
-	  }
+   if (end == s)
+     return _eet_data_undump_error(u, t->s, "invalid number");
+   return EINA_TRUE;
+}
 
-	/* advance to next chunk */
-        NEXT_CHUNK(p, size, echnk, ed);
-     }
+/* add a value to the array being packed, NULL for a null */
+static Eina_Bool
+_eet_data_undump_packed_add(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, const void *value)
+{
+   int width;
 
-   _eet_freelist_all_unref(context);
-   if (!edd)
+   width = eet_basic_codec[g->child_type - 1].size;
+   if ((g->items + 1) * width > u->packed_size)
      {
-	_eet_freelist_str_free(context, edd);
-	_eet_freelist_direct_str_free(context, edd);
-	_eet_freelist_list_free(context, edd);
-	_eet_freelist_hash_free(context, edd);
-	_eet_freelist_free(context, edd);
-     }
-   else
-     {
-	_eet_freelist_reset(context);
-	_eet_freelist_str_reset(context);
-	_eet_freelist_list_reset(context);
-	_eet_freelist_hash_reset(context);
-	_eet_freelist_direct_str_reset(context);
+	char *packed;
+	int size;
+
+	size = u->packed_size * 2;
+	if (size < (g->items + 1) * width) size = (g->items + 1) * width + 256;
+	packed = realloc(u->packed, size);
+	if (!packed)
+	  return _eet_data_undump_error(u, u->p, "not enough memory");
+	u->packed = packed;
+	u->packed_size = size;
      }
 
-   if (!edd)
-     return result;
+   if (value) memcpy(u->packed + g->items * width, value, width);
+   else memset(u->packed + g->items * width, 0, width);
+   g->items++;
 
-   return data;
+   return EINA_TRUE;
+}
 
-error:
-   eet_node_del(result);
+/* the array g gets an item of type that isn't null, see how it is encoded */
+static Eina_Bool
+_eet_data_undump_array_item(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, int type)
+{
+   int items;
 
-   _eet_freelist_all_unref(context);
-   _eet_freelist_str_free(context, edd);
-   _eet_freelist_direct_str_free(context, edd);
-   _eet_freelist_list_free(context, edd);
-   _eet_freelist_hash_free(context, edd);
-   _eet_freelist_free(context, edd);
+   switch (g->mode)
+     {
+      case EET_DATA_UNDUMP_ARRAY_NONE:
+	 g->child_type = type;
+	 if (!IS_PACKED_TYPE(type)) break;
+
+	 /* the nulls before the first value are zeros */
+	 g->mode = EET_DATA_UNDUMP_ARRAY_PACKED;
+	 items = g->items;
+	 for (g->items = 0; g->items < items;)
+	   if (!_eet_data_undump_packed_add(u, g, NULL))
+	     return EINA_FALSE;
+	 return EINA_TRUE;
+      case EET_DATA_UNDUMP_ARRAY_PACKED:
+	 if (type == g->child_type) return EINA_TRUE;
+	 /* the values already read are packed, they can't be chunks now */
+	 return _eet_data_undump_error(u, u->p, "array items of different types");
+      default:
+	 return EINA_TRUE;
+     }
 
-   /* FIXME: Warn that something goes wrong here. */
-   return NULL;
+   g->mode = EET_DATA_UNDUMP_ARRAY_CHUNKS;
+   if (eet_data_encode_type(u->ed, u->ds, EET_T_INT, &g->count, g->name, g->child_type, g->type))
+     g->count_end = u->ds->pos;
+
+   if (g->grow)
+     for (; g->items > 0; g->items--)
+       eet_data_encode(u->ed, u->ds, NULL, g->name, 0, EET_T_NULL, g->type);
+   return EINA_TRUE;
 }
 
-static int
-eet_data_get_list(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		  int type, int group_type __UNUSED__, void *data,
-		  char **p, int *size)
+/* 'NAME TYPE {' after a group token, return the group name */
+static const char *
+_eet_data_undump_group_head(Eet_Data_Undump *u, int *type)
 {
-   Eet_Data_Descriptor *subtype = NULL;
-   void *list = NULL;
-   void **ptr;
-   void *data_ret;
+   Eet_Data_Undump_Token t;
+   const char *name;
+   int i;
 
-   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+   if (!_eet_data_undump_token_need(u, &t)) return NULL;
+   name = _eet_data_undump_text(u, &t, 0);
+   if (!name) return NULL;
 
-   if (edd)
+   if (!_eet_data_undump_token_need(u, &t)) return NULL;
+   for (i = 0; i <= EET_G_HASH - EET_G_UNKNOWN; i++)
+     if (t.len == (int) strlen(_eet_node_dump_g_name[i])
+	 && !memcmp(t.s, _eet_node_dump_g_name[i], t.len))
+       break;
+   if (i > EET_G_HASH - EET_G_UNKNOWN)
      {
-	subtype = ede->subtype;
-
-	if (type != ede->type)
-	  return 0;
+	_eet_data_undump_error(u, t.s, "invalid group type");
+	return NULL;
      }
+   *type = EET_G_UNKNOWN + i;
 
-   ptr = (void **)data;
-   list = *ptr;
-   data_ret = NULL;
-
-   if (IS_POINTER_TYPE(type))
+   if (!_eet_data_undump_token_need(u, &t)) return NULL;
+   if (!EET_DATA_UNDUMP_IS(t, "{"))
      {
-	POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, type, &data_ret, p, size, on_error);
-     }
-   else
-     {
-	STRUCT_TYPE_DECODE(data_ret, context, ed, subtype, echnk->data, echnk->size, on_error);
+	_eet_data_undump_error(u, t.s, "'{' expected");
+	return NULL;
      }
 
-   if (edd)
+   return eina_stringshare_add(name);
+}
+
+/* start g, a group with name and type */
+static void
+_eet_data_undump_group_open(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, const char *name, int type)
+{
+   memset(g, 0, sizeof (Eet_Data_Undump_Group));
+   g->name = name;
+   g->type = type;
+   g->start = -1;
+   g->mode = EET_DATA_UNDUMP_ARRAY_NONE;
+   g->child_type = EET_T_NULL;
+
+   if (type == EET_G_UNKNOWN)
+     g->start = eet_data_chunk_open(u->ed, u->ds, name, EET_T_UNKNOW, type);
+}
+
+/* the end of g */
+static Eina_Bool
+_eet_data_undump_group_close(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, const char *at)
+{
+   switch (g->type)
      {
-	list = edd->func.list_append(list, data_ret);
-	*ptr = list;
-	_eet_freelist_list_add(context, ptr);
+      case EET_G_UNKNOWN:
+	 if (g->start >= 0) eet_data_chunk_close(u->ds, g->start);
+	 break;
+      case EET_G_ARRAY:
+      case EET_G_VAR_ARRAY:
+	 if (g->grow && g->count < g->total) g->count = g->total;
+
+	 if (g->mode == EET_DATA_UNDUMP_ARRAY_PACKED)
+	   {
+	      while (g->items < g->count)
+		if (!_eet_data_undump_packed_add(u, g, NULL))
+		  return EINA_FALSE;
+	      eet_data_put_packed_array(u->ed, u->ds, g->name, g->child_type, g->type,
+					u->packed, g->items);
+	      break;
+	   }
+
+	 if (g->mode == EET_DATA_UNDUMP_ARRAY_NONE)
+	   eet_data_encode_type(u->ed, u->ds, EET_T_INT, &g->count, g->name, EET_T_NULL, g->type);
+	 else if (g->grow && g->count_end > 0 && u->ds->data)
+	   {
+	      int count = g->total;
+
+	      CONV32(count);
+	      memcpy(((char *)u->ds->data) + g->count_end - sizeof (int), &count, sizeof (int));
+	      break;
+	   }
+	 for (; g->count > 0; g->count--)
+	   eet_data_encode(u->ed, u->ds, NULL, g->name, 0, EET_T_NULL, g->type);
+	 break;
+      case EET_G_HASH:
+	 if (!g->key)
+	   return _eet_data_undump_error(u, at, "hash without key");
+	 break;
      }
-   else
+
+   return EINA_TRUE;
+}
+
+/* the key of the hash g */
+static void
+_eet_data_undump_key(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, const char *key)
+{
+   eet_data_encode_type(u->ed, u->ds, EET_T_STRING, &key, g->name, g->type, g->type);
+   g->key = EINA_TRUE;
+}
+
+/* a group of type starts inside g, start is the chunk to close after it */
+static Eina_Bool
+_eet_data_undump_child_open(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, int type, int *start)
+{
+   *start = -1;
+   switch (g->type)
      {
-	eet_node_list_append(*((Eet_Node**) data), echnk->name, data_ret);
+      case EET_G_UNKNOWN:
+	 return EINA_TRUE;
+      case EET_G_ARRAY:
+      case EET_G_VAR_ARRAY:
+	 g->total++;
+	 if (!_eet_data_undump_array_item(u, g, type)) return EINA_FALSE;
+	 g->count--;
+	 /* fallthrough */
+      default:
+	 /* an item of a list, an array or a hash is in a chunk of its own */
+	 *start = eet_data_chunk_open(u->ed, u->ds, g->name, EET_T_UNKNOW, g->type);
+	 return EINA_TRUE;
      }
+}
 
-   return 1;
-
- on_error:
-   return 0;
+static void
+_eet_data_undump_child_close(Eet_Data_Undump *u, int start)
+{
+   if (start >= 0) eet_data_chunk_close(u->ds, start);
 }
 
-static int
-eet_data_get_hash(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		  int type, int group_type __UNUSED__, void *data,
-		  char **p, int *size)
+/* a value of type named name inside g */
+static Eina_Bool
+_eet_data_undump_value_add(Eet_Data_Undump *u, Eet_Data_Undump_Group *g, const char *name, int type, Eet_Node_Data *v)
 {
-   void **ptr;
-   void *hash = NULL;
-   char *key = NULL;
-   void *data_ret = NULL;
-   int ret = 0;
+   switch (g->type)
+     {
+      case EET_G_UNKNOWN:
+	 /* a null member is left out, as the descriptor encoder does, an
+	  * empty chunk would be decoded as a value of the member type */
+	 if (type != EET_T_NULL)
+	   eet_data_encode_type(u->ed, u->ds, type, &v->value, name, type, g->type);
+	 break;
+      case EET_G_ARRAY:
+      case EET_G_VAR_ARRAY:
+	 g->total++;
+	 if (type == EET_T_NULL)
+	   {
+	      if (g->mode == EET_DATA_UNDUMP_ARRAY_PACKED)
+		return _eet_data_undump_packed_add(u, g, NULL);
+	      if (g->mode == EET_DATA_UNDUMP_ARRAY_NONE)
+		g->items++;
+	      else if (g->grow)
+		{
+		   eet_data_encode(u->ed, u->ds, NULL, g->name, 0, EET_T_NULL, g->type);
+		   g->count--;
+		}
+	      /* else nulls of an array of chunks come last */
+	      break;
+	   }
 
-   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+	 if (!_eet_data_undump_array_item(u, g, type)) return EINA_FALSE;
+	 if (g->mode == EET_DATA_UNDUMP_ARRAY_PACKED)
+	   return _eet_data_undump_packed_add(u, g, &v->value);
 
-   ptr = (void **)data;
-   hash = *ptr;
+	 if (IS_POINTER_TYPE(type)
+	     && eet_data_encode_type(u->ed, u->ds, type, &v->value, g->name, type, g->type))
+	   g->count--;
+	 break;
+      default:
+	 /* only strings have a chunk type of their own in a list or a hash */
+	 if (type != EET_T_NULL)
+	   eet_data_encode_type(u->ed, u->ds, type, &v->value, g->name, type, g->type);
+	 break;
+     }
 
-   /* Read key */
-   ret = eet_data_get_type(ed,
-			   EET_T_STRING,
-			   echnk->data,
-			   ((char *)echnk->data) + echnk->size,
-			   &key);
-   if (ret <= 0) goto on_error;
+   return EINA_TRUE;
+}
 
-   /* Advance to next chunk */
-   NEXT_CHUNK((*p), (*size), (*echnk), ed);
-   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+/* a group inside g */
+static Eina_Bool
+_eet_data_undump_group_child(Eet_Data_Undump *u, Eet_Data_Undump_Group *g)
+{
+   const char *name;
+   Eina_Bool r;
+   int start;
+   int type;
 
-   /* Read value */
-   eet_data_chunk_get(ed, echnk, *p, *size);
-   if (!echnk->name) goto on_error;
+   name = _eet_data_undump_group_head(u, &type);
+   if (!name) return EINA_FALSE;
 
-   if (IS_POINTER_TYPE(echnk->type))
-     {
-	POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, echnk->type, &data_ret, p, size, on_error);
-     }
-   else
+   r = _eet_data_undump_child_open(u, g, type, &start);
+   if (r)
      {
-	STRUCT_TYPE_DECODE(data_ret, context, ed, ede ? ede->subtype : NULL, echnk->data, echnk->size, on_error);
+	r = _eet_data_undump_group(u, name, type);
+	_eet_data_undump_child_close(u, start);
      }
 
-   if (edd)
-     {
-	hash = edd->func.hash_add(hash, key, data_ret);
-	*ptr = hash;
-	_eet_freelist_hash_add(context, hash);
-     }
-   else
-     {
-	eet_node_hash_add(*((Eet_Node **) data), echnk->name, key, data_ret);
-     }
-
-   return 1;
-
- on_error:
-   return ret;
+   eina_stringshare_del(name);
+   return r;
 }
 
-/* var arrays and fixed arrays have to
- * get all chunks at once. for fixed arrays
- * we can get each chunk and increment a
- * counter stored on the element itself but
- * it wont be thread safe. for var arrays
- * we still need a way to get the number of
- * elements from the data, so storing the
- * number of elements and the element data on
- * each chunk is pointless.
- */
-static int
-eet_data_get_array(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd,
-		   Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		   int type, int group_type, void *data,
-		   char **p, int *size)
+/* 'NAME TYPE VALUE' after a value token inside g */
+static Eina_Bool
+_eet_data_undump_value(Eet_Data_Undump *u, Eet_Data_Undump_Group *g)
 {
-   Eina_List *childs = NULL;
+   Eet_Data_Undump_Token t;
+   Eet_Node_Data v;
    const char *name;
-   Eet_Node *tmp;
-   void *ptr;
-   int count;
-   int ret;
-   int subsize = 0;
-   int i;
+   unsigned int i;
+   int type;
+
+   if (!_eet_data_undump_token_need(u, &t)) return EINA_FALSE;
+   name = _eet_data_undump_text(u, &t, 0);
+   if (!name) return EINA_FALSE;
+
+   if (!_eet_data_undump_token_need(u, &t)) return EINA_FALSE;
+   for (i = 0; i < sizeof (_eet_data_undump_types) / sizeof (_eet_data_undump_types[0]); i++)
+     if (t.len == (int) strlen(_eet_data_undump_types[i].name)
+	 && !memcmp(t.s, _eet_data_undump_types[i].name, t.len))
+       break;
+   if (i == sizeof (_eet_data_undump_types) / sizeof (_eet_data_undump_types[0]))
+     return _eet_data_undump_error(u, t.s, "invalid value type");
+   type = _eet_data_undump_types[i].type;
+
+   if (type != EET_T_NULL)
+     {
+	if (!_eet_data_undump_token_need(u, &t)) return EINA_FALSE;
+	if (!_eet_data_undump_value_get(u, &t, type, &v)) return EINA_FALSE;
+     }
 
-   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+   return _eet_data_undump_value_add(u, g, name, type, &v);
+}
 
-   ptr = data;
-   /* read the number of elements */
-   ret = eet_data_get_type(ed,
-			   EET_T_INT,
-			   echnk->data,
-			   ((char *)echnk->data) + echnk->size,
-			   &count);
-   if (ret <= 0) return ret;
+/* the content of a group, up to its closing brace */
+static Eina_Bool
+_eet_data_undump_group(Eet_Data_Undump *u, const char *name, int type)
+{
+   Eet_Data_Undump_Group g;
+   Eet_Data_Undump_Token t;
 
-   name = echnk->name;
+   _eet_data_undump_group_open(u, &g, name, type);
 
-   if (ede)
+   for (;;)
      {
-	if (IS_POINTER_TYPE(type))
-	  subsize = eet_basic_codec[ede->type].size;
-	else
-	  subsize = ede->subtype->size;
+	if (!_eet_data_undump_token(u, &t))
+	  return _eet_data_undump_error(u, u->p, "unexpected end of text, '}' expected");
 
-	if (group_type == EET_G_VAR_ARRAY)
+	if (EET_DATA_UNDUMP_IS(t, "}"))
+	  break;
+
+	if (EET_DATA_UNDUMP_IS(t, "key"))
 	  {
-	     /* store the number of elements
-	      * on the counter offset */
-	     *(int *)(((char *)data) + ede->count - ede->offset) = count;
-	     /* allocate space for the array of elements */
-	     *(void **)ptr = edd->func.mem_alloc(count * subsize);
+	     const char *key;
 
-	     if (!*(void **)ptr) return 0;
+	     if (type != EET_G_HASH)
+	       return _eet_data_undump_error(u, t.s, "key outside of a hash");
+	     if (g.key || g.children)
+	       return _eet_data_undump_error(u, t.s, "key expected first in a hash");
 
-	     memset(*(void **)ptr, 0, count * subsize);
+	     if (!_eet_data_undump_token_need(u, &t)) return EINA_FALSE;
+	     key = _eet_data_undump_text(u, &t, 1);
+	     if (!key) return EINA_FALSE;
 
-	     _eet_freelist_add(context, *(void **)ptr);
+	     _eet_data_undump_key(u, &g, key);
+	     continue;
 	  }
-     }
 
-   /* get all array elements */
-   for (i = 0; i < count; i++)
-     {
-	void *dst = NULL;
-	void *data_ret = NULL;
-
-	/* Advance to next chunk */
-	NEXT_CHUNK((*p), (*size), (*echnk), ed);
-	memset(echnk, 0, sizeof(Eet_Data_Chunk));
-
-	eet_data_chunk_get(ed, echnk, *p, *size);
-	if (!echnk->name || strcmp(echnk->name, name) != 0) goto on_error;
-	/* get the data */
-
-	if (echnk->group_type != group_type
-	    || (echnk->type != type && echnk->type != EET_T_NULL))
-	  goto on_error;
-
-	if (ede)
-	  if (ede->group_type != echnk->group_type
-	      || (echnk->type != ede->type && echnk->type != EET_T_NULL))
-	    goto on_error;
-
-	/* get the destination pointer */
-	if (ede)
+	if (EET_DATA_UNDUMP_IS(t, "count"))
 	  {
-	     if (group_type == EET_G_ARRAY)
-	       dst = (char *)ptr + (subsize * i);
-	     else
-	       dst = *(char **)ptr + (subsize * i);
+	     const char *s;
+	     char *end;
+
+	     if (type != EET_G_ARRAY && type != EET_G_VAR_ARRAY)
+	       return _eet_data_undump_error(u, t.s, "count outside of an array");
+	     if (g.children)
+	       return _eet_data_undump_error(u, t.s, "count expected before the array items");
+
+	     if (!_eet_data_undump_token_need(u, &t)) return EINA_FALSE;
+	     s = _eet_data_undump_text(u, &t, 1);
+	     if (!s) return EINA_FALSE;
+	     g.count = strtol(s, &end, 0);
+	     if (end == s)
+	       return _eet_data_undump_error(u, t.s, "invalid count");
+	     continue;
 	  }
 
-	if (IS_POINTER_TYPE(echnk->type))
+	if (type == EET_G_HASH && !g.key)
+	  return _eet_data_undump_error(u, t.s, "key expected first in a hash");
+	g.children = EINA_TRUE;
+
+	if (EET_DATA_UNDUMP_IS(t, "group"))
 	  {
-	     POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, echnk->type, &data_ret, p, size, on_error);
-	     if (dst) memcpy(dst, &data_ret, subsize);
-	     if (!edd) childs = eina_list_append(childs, data_ret);
+	     if (!_eet_data_undump_group_child(u, &g)) return EINA_FALSE;
 	  }
-	else
+	else if (EET_DATA_UNDUMP_IS(t, "value"))
 	  {
-	     STRUCT_TYPE_DECODE(data_ret, context, ed, ede ? ede->subtype : NULL, echnk->data, echnk->size, on_error);
-	     if (dst)
-	       {
-		  memcpy(dst, data_ret, subsize);
-		  _eet_freelist_add(context, data_ret);
-	       }
-	     if (!edd) childs = eina_list_append(childs, data_ret);
+	     if (!_eet_data_undump_value(u, &g)) return EINA_FALSE;
 	  }
+	else
+	  return _eet_data_undump_error(u, t.s, "'group', 'value', 'key', 'count' or '}' expected");
      }
 
-   if (!edd)
+   return _eet_data_undump_group_close(u, &g, t.s);
+}
+
+static Eina_Bool
+_eet_data_undump_init(Eet_Data_Undump *u, Eet_Dictionary *ed, const char *src, int size)
+{
+   if (_eet_data_words_bigendian == -1)
      {
-	Eet_Node *parent = *((Eet_Node **) data);
-	Eet_Node *array;
+	unsigned long int v;
 
-	if (group_type == EET_G_ARRAY)
-	  array = eet_node_array_new(name, count, childs);
-	else
-	  array = eet_node_var_array_new(name, childs);
+	v = htonl(0x12345678);
+	if (v == 0x12345678) _eet_data_words_bigendian = 1;
+	else _eet_data_words_bigendian = 0;
+     }
 
-	if (!array) goto on_error;
+   memset(u, 0, sizeof (*u));
+   u->ed = ed;
+   u->src = u->p = src;
+   u->end = src + size;
 
-	eet_node_struct_append(parent, name, array);
-     }
+   u->ds = eet_data_stream_new();
+   return u->ds != NULL;
+}
 
-   return 1;
+/* return the encoded data, or NULL if the text had an error */
+static void *
+_eet_data_undump_shutdown(Eet_Data_Undump *u, int *size_ret)
+{
+   void *cdata = NULL;
 
- on_error:
-   EINA_LIST_FREE(childs, tmp)
-     eet_node_del(tmp);
+   if (u->ds && !u->error)
+     {
+	cdata = u->ds->data;
+	*size_ret = u->ds->pos;
+	eet_data_stream_flush(u->ds);
+	u->ds = NULL;
+     }
 
-   return 0;
+   eet_data_stream_free(u->ds);
+   free(u->str[0]);
+   free(u->str[1]);
+   free(u->packed);
+   return cdata;
 }
 
-static void
-eet_data_put_union(Eet_Dictionary *ed,
-		   __UNUSED__ Eet_Data_Descriptor *edd,
-		   Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+static void *
+_eet_data_dump_parse(Eet_Dictionary *ed,
+                     int *size_ret,
+		     const char *src,
+		     int size)
 {
-   const char *union_type;
-   int i;
-
-   EET_ASSERT(!((ede->type != EET_T_UNKNOW) || (!ede->subtype)), return );
+   Eet_Data_Undump u;
+   Eet_Data_Undump_Token t;
+   const char *name;
+   Eina_Bool r;
+   int type;
 
-   union_type = ede->subtype->func.type_get(((char*) data_in) + ede->count - ede->offset,
-					    NULL);
+   if (!_eet_data_undump_init(&u, ed, src, size)) goto on_error;
 
-   if (!union_type) return ;
+   if (!_eet_data_undump_token(&u, &t))
+     {
+	_eet_data_undump_error(&u, u.p, "no group to undump");
+	goto on_error;
+     }
+   if (!EET_DATA_UNDUMP_IS(t, "group"))
+     {
+	_eet_data_undump_error(&u, t.s, "'group' expected");
+	goto on_error;
+     }
 
-   /* Search the structure of the union to encode. */
-   for (i = 0; i < ede->subtype->elements.num; ++i)
-     if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
-       {
-	  Eet_Data_Element *sede;
-	  void *data;
-	  int size;
+   /* the top group is encoded as a member of a structure would be */
+   name = _eet_data_undump_group_head(&u, &type);
+   if (!name) goto on_error;
+   r = _eet_data_undump_group(&u, name, type);
+   eina_stringshare_del(name);
+   if (!r) goto on_error;
 
-	  /* Yeah we found it ! */
-	  data = eet_data_put_type(ed, EET_T_STRING, &union_type, &size);
-	  if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
+   if (_eet_data_undump_token(&u, &t))
+     _eet_data_undump_error(&u, t.s, "text after the end of the top group");
+   return _eet_data_undump_shutdown(&u, size_ret);
 
-	  sede = &(ede->subtype->elements.set[i]);
-	  data = _eet_data_descriptor_encode(ed,
-					     sede->subtype,
-					     data_in,
-					     &size);
-	  if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
-	  break;
-       }
+ on_error:
+   u.error = EINA_TRUE;
+   return _eet_data_undump_shutdown(&u, size_ret);
 }
 
-static int
-eet_data_get_union(Eet_Free_Context *context, const Eet_Dictionary *ed,
-		   __UNUSED__ Eet_Data_Descriptor *edd,
-		   Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		   int type, int group_type, void *data,
-		   char **p, int *size)
+/*
+ * Json undump, of the text the json dump writes. As with the text undump,
+ * each value is encoded as soon as it is read. Strings are scanned for the
+ * quote or backslash ending a run 16 bytes at a time where SSE2 is there.
+ */
+static const char *
+_eet_data_json_scan(const char *p, const char *end)
 {
-   const char *union_type;
-   void *data_ret = NULL;
-   int ret = 0;
-   int i;
+#ifdef __SSE2__
+   const __m128i quote = _mm_set1_epi8('"');
+   const __m128i backslash = _mm_set1_epi8('\\');
 
-   /* Read type */
-   ret = eet_data_get_type(ed,
-			   EET_T_STRING,
-			   echnk->data,
-			   ((char *)echnk->data) + echnk->size,
-			   &union_type);
-   if (ret <= 0) goto on_error;
+   for (; end - p >= 16; p += 16)
+     {
+	__m128i v;
+	int mask;
 
-   /* Advance to next chunk */
-   NEXT_CHUNK((*p), (*size), (*echnk), ed);
-   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+	v = _mm_loadu_si128((const __m128i *) p);
+	mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+					      _mm_cmpeq_epi8(v, backslash)));
+	if (mask) return p + __builtin_ctz(mask);
+     }
+#endif
+   while (p < end && *p != '"' && *p != '\\')
+     p++;
+   return p;
+}
 
-   /* Read value */
-   eet_data_chunk_get(ed, echnk, *p, *size);
-   if (!echnk->name) goto on_error;
+/* skip blanks, return the next character, nul at the end of the text */
+static char
+_eet_data_json_next(Eet_Data_Undump *u)
+{
+   while (u->p < u->end
+	  && (*u->p == ' ' || *u->p == '\n' || *u->p == '\t' || *u->p == '\r'))
+     u->p++;
 
-   if (ede)
+   if (u->p == u->end) return '\0';
+   return *u->p;
+}
+
+static Eina_Bool
+_eet_data_json_expect(Eet_Data_Undump *u, char c)
+{
+   char tbuf[16];
+
+   if (_eet_data_json_next(u) == c)
      {
-	EET_ASSERT(!(ede->group_type != group_type || ede->type != type), goto on_error);
+	u->p++;
+	return EINA_TRUE;
+     }
 
-	/* Search the structure of the union to decode */
-	for (i = 0; i < ede->subtype->elements.num; ++i)
-	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
-	    {
-	       Eet_Data_Element *sede;
-	       char *ut;
+   snprintf(tbuf, sizeof (tbuf), "'%c' expected", c);
+   return _eet_data_undump_error(u, u->p, tbuf);
+}
 
-	       /* Yeah we found it ! */
-	       sede = &(ede->subtype->elements.set[i]);
-	       EET_ASSERT(sede->subtype, goto on_error);
+static int
+_eet_data_json_hex(const char *s)
+{
+   int r = 0;
+   int i;
 
-	       data_ret = _eet_data_descriptor_decode(context,
-						      ed,
-						      sede->subtype,
-						      echnk->data,
-						      echnk->size);
-	       if (!data_ret) goto on_error;
+   for (i = 0; i < 4; i++)
+     {
+	r <<= 4;
+	if (s[i] >= '0' && s[i] <= '9') r |= s[i] - '0';
+	else if (s[i] >= 'a' && s[i] <= 'f') r |= s[i] - 'a' + 10;
+	else if (s[i] >= 'A' && s[i] <= 'F') r |= s[i] - 'A' + 10;
+	else return -1;
+     }
 
-	       /* Memcopy the structure content to remove pointer indirection. */
-	       memcpy(data, data_ret, sede->subtype->size);
+   return r;
+}
 
-	       /* data_ret is now useless. */
-	       sede->subtype->func.mem_free(data_ret);
+/* \uXXXX at s, a surrogate pair takes two, written in utf-8 at d */
+static const char *
+_eet_data_json_unicode(const char *s, const char *end, char **d)
+{
+   unsigned char *o = (unsigned char *) *d;
+   int c;
 
-	       /* Set union type. */
-	       if ((!ed) || (!ede->subtype->func.str_direct_alloc))
-		 {
-		    ut = ede->subtype->func.str_alloc(union_type);
-		    _eet_freelist_str_add(context, ut);
-		 }
-	       else
-		 {
-		    ut = ede->subtype->func.str_direct_alloc(union_type);
-		    _eet_freelist_direct_str_add(context, ut);
-		 }
+   if (end - s < 5) return NULL;
+   c = _eet_data_json_hex(s + 1);
+   if (c < 0) return NULL;
+   s += 5;
 
-	       ede->subtype->func.type_set(ut,
-					   ((char*) data) + ede->count - ede->offset,
-					   EINA_FALSE);
+   if (c >= 0xd800 && c < 0xdc00)
+     {
+	int low;
 
-	       break;
-	    }
+	if (end - s < 6 || s[0] != '\\' || s[1] != 'u') return NULL;
+	low = _eet_data_json_hex(s + 2);
+	if (low < 0xdc00 || low >= 0xe000) return NULL;
+	c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+	s += 6;
+     }
+
+   if (c < 0x80)
+     *o++ = c;
+   else if (c < 0x800)
+     {
+	*o++ = 0xc0 | (c >> 6);
+	*o++ = 0x80 | (c & 0x3f);
+     }
+   else if (c < 0x10000)
+     {
+	*o++ = 0xe0 | (c >> 12);
+	*o++ = 0x80 | ((c >> 6) & 0x3f);
+	*o++ = 0x80 | (c & 0x3f);
      }
    else
      {
-	/* FIXME: generate node structure. */
-	data_ret = _eet_data_descriptor_decode(context,
-					       ed, NULL,
-					       echnk->data, echnk->size);
-	goto on_error;
+	*o++ = 0xf0 | (c >> 18);
+	*o++ = 0x80 | ((c >> 12) & 0x3f);
+	*o++ = 0x80 | ((c >> 6) & 0x3f);
+	*o++ = 0x80 | (c & 0x3f);
      }
 
-   return 1;
+   *d = (char *) o;
+   return s;
+}
 
- on_error:
-   return 0;
-}
-
-static void
-eet_data_put_variant(Eet_Dictionary *ed,
-		     __UNUSED__ Eet_Data_Descriptor *edd,
-		     Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+/* a string, unescaped in the buffer i of u */
+static const char *
+_eet_data_json_string(Eet_Data_Undump *u, int i)
 {
-   const char *union_type;
-   void *data;
-   Eina_Bool unknow = EINA_FALSE;
-   int size;
-   int i;
-
-   EET_ASSERT(!((ede->type != EET_T_UNKNOW) || (!ede->subtype)), return );
-
-   union_type = ede->subtype->func.type_get(((char*) data_in) + ede->count - ede->offset,
-					    &unknow);
+   const char *start;
+   const char *p;
+   const char *s;
+   char *d;
 
-   if (!union_type && unknow == EINA_FALSE) return ;
+   if (!_eet_data_json_expect(u, '"')) return NULL;
 
-   if (unknow)
+   /* find its end first, unescaped it is never longer */
+   for (start = p = u->p; ; p += 2)
      {
-	/* Handle opaque internal representation */
-	Eet_Variant_Unknow *evu;
+	p = _eet_data_json_scan(p, u->end);
+	if (p + 1 >= u->end && (p == u->end || *p == '\\'))
+	  {
+	     _eet_data_undump_error(u, start - 1, "string not terminated");
+	     return NULL;
+	  }
+	if (*p == '"') break;
+     }
 
-	data = eet_data_put_type(ed, EET_T_STRING, &union_type, &size);
-	if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
+   if (p - start >= u->str_size[i])
+     {
+	int size;
 
-	evu = (Eet_Variant_Unknow*) data_in;
-	if (evu && EINA_MAGIC_CHECK(evu, EET_MAGIC_VARIANT))
-	  eet_data_encode(ed, ds, evu->data, ede->name, evu->size, ede->type, ede->group_type);
+	size = u->str_size[i] * 2;
+	if (size <= p - start) size = p - start + 64;
+	d = realloc(u->str[i], size);
+	if (!d)
+	  {
+	     _eet_data_undump_error(u, start, "not enough memory");
+	     return NULL;
+	  }
+	u->str[i] = d;
+	u->str_size[i] = size;
      }
-   else
+
+   for (d = u->str[i], s = start; s < p; )
      {
-	/* Search the structure of the union to encode. */
-	for (i = 0; i < ede->subtype->elements.num; ++i)
-	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
-	    {
-	       Eet_Data_Element *sede;
+	const char *e;
 
-	       /* Yeah we found it ! */
-	       data = eet_data_put_type(ed, EET_T_STRING, &union_type, &size);
-	       if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
+	e = memchr(s, '\\', p - s);
+	if (!e) e = p;
+	memcpy(d, s, e - s);
+	d += e - s;
+	s = e;
+	if (s == p) break;
 
-	       sede = &(ede->subtype->elements.set[i]);
+	switch (s[1])
+	  {
+	   case '"': case '\\': case '/': *d++ = s[1]; break;
+	   case 'b': *d++ = '\b'; break;
+	   case 'f': *d++ = '\f'; break;
+	   case 'n': *d++ = '\n'; break;
+	   case 'r': *d++ = '\r'; break;
+	   case 't': *d++ = '\t'; break;
+	   case 'u':
+	      s = _eet_data_json_unicode(s + 1, p, &d);
+	      if (!s)
+		{
+		   _eet_data_undump_error(u, e, "invalid unicode escape");
+		   return NULL;
+		}
+	      continue ;
+	   default:
+	      _eet_data_undump_error(u, s, "invalid escape");
+	      return NULL;
+	  }
+	s += 2;
+     }
+   *d = '\0';
 
-	       if (sede->group_type != EET_G_UNKNOWN)
-		 {
-		    Eet_Data_Stream *lds;
+   u->p = p + 1;
+   return u->str[i];
+}
 
-		    lds = eet_data_stream_new();
-		    eet_group_codec[sede->group_type - 100].put(ed,
-								sede->subtype,
-								sede,
-								lds,
-								data_in);
-		    if (lds->size != 0)
-		      {
- 			 eet_data_encode(ed, ds, lds->data, ede->name, lds->pos,
-					 ede->type, ede->group_type);
+/* '{"TYPE":' opening a value, return its type */
+static int
+_eet_data_json_type(Eet_Data_Undump *u)
+{
+   const char *at;
+   const char *s;
+   int i;
 
-			 lds->data = NULL;
-			 lds->size = 0;
-		      }
-		    else
-		      {
-			 eet_data_encode(ed, ds, NULL, ede->name, 0,
-					 EET_T_NULL, ede->group_type);
-		      }
+   if (!_eet_data_json_expect(u, '{')) return -1;
 
-		    eet_data_stream_free(lds);
-		 }
-	       else
-		 {
-		    data = _eet_data_descriptor_encode(ed,
-						       sede->subtype,
-						       *(void**)data_in,
-						       &size);
-		    if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
-		 }
+   _eet_data_json_next(u);
+   at = u->p;
+   s = _eet_data_json_string(u, 1);
+   if (!s) return -1;
+   if (!_eet_data_json_expect(u, ':')) return -1;
 
-	       break;
-	    }
-     }
+   for (i = EET_T_CHAR; i <= EET_T_INLINED_STRING; i++)
+     if (!strcmp(s, eet_basic_codec[i - 1].name))
+       return i;
+   if (!strcmp(s, "null"))
+     return EET_T_NULL;
+   for (i = 0; i <= EET_G_HASH - EET_G_UNKNOWN; i++)
+     if (!strcmp(s, _eet_node_dump_g_name[i]))
+       return EET_G_UNKNOWN + i;
+
+   _eet_data_undump_error(u, at, "invalid type");
+   return -1;
 }
 
-static int
-eet_data_get_variant(Eet_Free_Context *context, const Eet_Dictionary *ed,
-		     __UNUSED__ Eet_Data_Descriptor *edd,
-		     Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		     int type, int group_type, void *data,
-		     char **p, int *size)
+static Eina_Bool
+_eet_data_json_simple_get(Eet_Data_Undump *u, int type, Eet_Node_Data *v)
 {
-   const char *union_type;
-   void *data_ret = NULL;
-   int ret = 0;
-   int i;
+   const char *at;
+   const char *s;
+   char tbuf[64];
+   char *end;
+   int len;
 
-   /* Read type */
-   ret = eet_data_get_type(ed,
-			   EET_T_STRING,
-			   echnk->data,
-			   ((char *)echnk->data) + echnk->size,
-			   &union_type);
-   if (ret <= 0) goto on_error;
+   _eet_data_json_next(u);
+   at = u->p;
 
-   /* Advance to next chunk */
-   NEXT_CHUNK((*p), (*size), (*echnk), ed);
-   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+   if (type == EET_T_NULL)
+     {
+	if (u->end - u->p < 4 || memcmp(u->p, "null", 4))
+	  return _eet_data_undump_error(u, at, "null expected");
+	u->p += 4;
+	return EINA_TRUE;
+     }
 
-   /* Read value */
-   eet_data_chunk_get(ed, echnk, *p, *size);
-   if (!echnk->name) goto on_error;
+   if (type == EET_T_STRING || type == EET_T_INLINED_STRING)
+     {
+	v->value.str = _eet_data_json_string(u, 1);
+	return v->value.str != NULL;
+     }
 
-   if (ede)
+   /* floats that aren't finite are strings */
+   if ((type == EET_T_FLOAT || type == EET_T_DOUBLE) && *u->p == '"')
      {
-	char *ut;
+	s = _eet_data_json_string(u, 1);
+	if (!s) return EINA_FALSE;
+     }
+   else
+     {
+	for (len = 0; u->p + len < u->end; len++)
+	  if (!u->p[len] || !strchr("+-0123456789.eE", u->p[len]))
+	    break;
+	if (!len || len >= (int) sizeof (tbuf))
+	  return _eet_data_undump_error(u, at, "number expected");
+
+	memcpy(tbuf, u->p, len);
+	tbuf[len] = '\0';
+	u->p += len;
+	s = tbuf;
+     }
 
-	EET_ASSERT(ede->subtype, goto on_error);
+   switch (type)
+     {
+      case EET_T_CHAR: v->value.c = strtol(s, &end, 10); break;
+      case EET_T_SHORT: v->value.s = strtol(s, &end, 10); break;
+      case EET_T_INT: v->value.i = strtol(s, &end, 10); break;
+      case EET_T_LONG_LONG: v->value.l = strtoll(s, &end, 10); break;
+      case EET_T_FLOAT: v->value.f = strtod(s, &end); break;
+      case EET_T_DOUBLE: v->value.d = strtod(s, &end); break;
+      case EET_T_UCHAR: v->value.uc = strtoul(s, &end, 10); break;
+      case EET_T_USHORT: v->value.us = strtoul(s, &end, 10); break;
+      case EET_T_UINT: v->value.ui = strtoul(s, &end, 10); break;
+      case EET_T_ULONG_LONG: v->value.ul = strtoull(s, &end, 10); break;
+      default: return _eet_data_undump_error(u, at, "invalid type");
+     }
 
-	if ((!ed) || (!ede->subtype->func.str_direct_alloc))
-	  {
-	     ut = ede->subtype->func.str_alloc(union_type);
-	     _eet_freelist_str_add(context, ut);
-	  }
-	else
-	  {
-	     ut = ede->subtype->func.str_direct_alloc(union_type);
-	     _eet_freelist_direct_str_add(context, ut);
-	  }
+   if (end == s || *end)
+     return _eet_data_undump_error(u, at, "invalid number");
+   return EINA_TRUE;
+}
 
-	/* Search the structure of the union to decode */
-	for (i = 0; i < ede->subtype->elements.num; ++i)
-	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
-	    {
-	       Eet_Data_Element *sede;
+/* the members of a structure, name is its descriptor */
+static Eina_Bool
+_eet_data_json_struct(Eet_Data_Undump *u, const char *name)
+{
+   Eet_Data_Undump_Group g;
+   const char *member;
+   char c;
 
-	       /* Yeah we found it ! */
-	       sede = &(ede->subtype->elements.set[i]);
+   if (!_eet_data_json_expect(u, '{')) return EINA_FALSE;
 
-	       if (sede->group_type != EET_G_UNKNOWN)
-		 {
-		    Eet_Data_Chunk chnk;
-		    char *p2;
-		    int size2;
-		    int ret;
+   _eet_data_undump_group_open(u, &g, name, EET_G_UNKNOWN);
+   if (_eet_data_json_next(u) == '}')
+     u->p++;
+   else
+     do
+       {
+	  member = _eet_data_json_string(u, 0);
+	  if (!member) return EINA_FALSE;
+	  if (!_eet_data_json_expect(u, ':')) return EINA_FALSE;
+	  if (!_eet_data_json_value(u, &g, member)) return EINA_FALSE;
+
+	  c = _eet_data_json_next(u);
+	  if (c != ',' && c != '}')
+	    return _eet_data_undump_error(u, u->p, "',' or '}' expected");
+	  u->p++;
+       }
+     while (c == ',');
 
-		    p2 = echnk->data;
-		    size2 = echnk->size;
+   return _eet_data_undump_group_close(u, &g, u->p);
+}
 
-		    /* Didn't find a proper way to provide this
-		       without duplicating code */
-		    while (size2 > 0)
-		      {
-			 memset(&chnk, 0, sizeof(Eet_Data_Chunk));
-			 eet_data_chunk_get(ed, &chnk, p2, size2);
+/* the items of a list or an array */
+static Eina_Bool
+_eet_data_json_list(Eet_Data_Undump *u, const char *name, int type)
+{
+   Eet_Data_Undump_Group g;
+   char c;
 
-			 if (!chnk.name) goto on_error;
+   if (!_eet_data_json_expect(u, '[')) return EINA_FALSE;
 
-			 ret = eet_group_codec[sede->group_type - 100].get(context,
-									   ed, sede->subtype,
-									   sede, &chnk,
-									   sede->type, sede->group_type,
-									   data, &p2, &size2);
+   _eet_data_undump_group_open(u, &g, name, type);
+   g.grow = EINA_TRUE;
+   if (_eet_data_json_next(u) == ']')
+     u->p++;
+   else
+     do
+       {
+	  if (!_eet_data_json_value(u, &g, NULL)) return EINA_FALSE;
 
-			 if (ret <= 0) goto on_error;
+	  c = _eet_data_json_next(u);
+	  if (c != ',' && c != ']')
+	    return _eet_data_undump_error(u, u->p, "',' or ']' expected");
+	  u->p++;
+       }
+     while (c == ',');
 
-			 /* advance to next chunk */
-			 NEXT_CHUNK(p2, size2, chnk, ed);
-		      }
+   return _eet_data_undump_group_close(u, &g, u->p);
+}
 
-		    /* Put garbage so that we will not put eet_variant_unknow in it */
-		    data_ret = (void*) data;
+/* the items of a hash, each in a group with its key */
+static Eina_Bool
+_eet_data_json_hash(Eet_Data_Undump *u, Eet_Data_Undump_Group *parent, const char *name)
+{
+   Eet_Data_Undump_Group g;
+   const char *key;
+   int start;
+   char c;
 
-		    /* Set variant type. */
-		    ede->subtype->func.type_set(ut,
-						((char*) data) + ede->count - ede->offset,
-						EINA_FALSE);
-		    break;
-		 }
+   if (!_eet_data_json_expect(u, '{')) return EINA_FALSE;
 
-	       data_ret = _eet_data_descriptor_decode(context,
-						      ed,
-						      sede->subtype,
-						      echnk->data,
-						      echnk->size);
-	       if (!data_ret) break;
+   if (_eet_data_json_next(u) == '}')
+     {
+	u->p++;
+	return EINA_TRUE;
+     }
 
-	       /* And point to the variant data. */
-	       *(void**) data = data_ret;
+   do
+     {
+	key = _eet_data_json_string(u, 1);
+	if (!key) return EINA_FALSE;
+	if (!_eet_data_json_expect(u, ':')) return EINA_FALSE;
+
+	if (!_eet_data_undump_child_open(u, parent, EET_G_HASH, &start))
+	  return EINA_FALSE;
+	_eet_data_undump_group_open(u, &g, name, EET_G_HASH);
+	_eet_data_undump_key(u, &g, key);
+	if (!_eet_data_json_value(u, &g, NULL)) return EINA_FALSE;
+	if (!_eet_data_undump_group_close(u, &g, u->p)) return EINA_FALSE;
+	_eet_data_undump_child_close(u, start);
+
+	c = _eet_data_json_next(u);
+	if (c != ',' && c != '}')
+	  return _eet_data_undump_error(u, u->p, "',' or '}' expected");
+	u->p++;
+     }
+   while (c == ',');
 
-	       /* Set variant type. */
-	       ede->subtype->func.type_set(ut,
-					   ((char*) data) + ede->count - ede->offset,
-					   EINA_FALSE);
-	       break;
-	    }
+   return EINA_TRUE;
+}
 
-	if (!data_ret)
-	  {
-	     Eet_Variant_Unknow *evu;
+/* a group of type inside parent, as the text undump would have read it */
+static Eina_Bool
+_eet_data_json_group(Eet_Data_Undump *u, Eet_Data_Undump_Group *parent, const char *name, int type)
+{
+   Eet_Data_Undump_Group member;
+   const char *descriptor;
+   Eina_Bool r = EINA_FALSE;
+   int start;
 
-	     evu = calloc(1, sizeof (Eet_Variant_Unknow) + echnk->size - 1);
-	     if (!evu) goto on_error;
+   if (type == EET_G_HASH)
+     return _eet_data_json_hash(u, parent, name);
 
-	     evu->size = echnk->size;
-	     memcpy(evu->data, echnk->data, evu->size);
-	     EINA_MAGIC_SET(evu, EET_MAGIC_VARIANT);
+   if (type != EET_G_UNKNOWN)
+     {
+	if (!_eet_data_undump_child_open(u, parent, type, &start))
+	  return EINA_FALSE;
+	r = _eet_data_json_list(u, name, type);
+	_eet_data_undump_child_close(u, start);
+	return r;
+     }
 
-	     /* And point to the opaque internal data scructure */
-	     *(void**) data = evu;
+   /* {"Descriptor_Name": {...}} */
+   if (!_eet_data_json_expect(u, '{')) return EINA_FALSE;
+   descriptor = _eet_data_json_string(u, 0);
+   if (!descriptor) return EINA_FALSE;
+   descriptor = eina_stringshare_add(descriptor);
+   if (!_eet_data_json_expect(u, ':')) goto on_error;
 
-	     /* Set variant type. */
-	     ede->subtype->func.type_set(ut,
-					 ((char*) data) + ede->count - ede->offset,
-					 EINA_TRUE);
-	  }
-     }
-   else
+   /* a member holds the structure in a group of its own */
+   if (parent && parent->type == EET_G_UNKNOWN)
      {
-	/* FIXME: dump node structure. */
-	data_ret = _eet_data_descriptor_decode(context,
-					       ed, NULL,
-					       echnk->data, echnk->size);
-	goto on_error;
+	_eet_data_undump_group_open(u, &member, name, EET_G_UNKNOWN);
+	parent = &member;
      }
 
-   return 1;
+   start = -1;
+   if (parent && !_eet_data_undump_child_open(u, parent, EET_G_UNKNOWN, &start))
+     goto on_error;
+   r = _eet_data_json_struct(u, descriptor);
+   _eet_data_undump_child_close(u, start);
+   if (r && parent == &member)
+     r = _eet_data_undump_group_close(u, &member, u->p);
+   if (r)
+     r = _eet_data_json_expect(u, '}');
 
  on_error:
-   return 0;
+   eina_stringshare_del(descriptor);
+   return r;
 }
 
-static Eet_Node *
-eet_data_node_simple_type(int type, const char *name, void *dd)
+/* a value, name is its member name when parent is a structure */
+static Eina_Bool
+_eet_data_json_value(Eet_Data_Undump *u, Eet_Data_Undump_Group *parent, const char *name)
 {
-#ifdef EET_T_TYPE
-# undef EET_T_TYPE
-#endif
+   Eet_Node_Data v;
+   const char *at;
+   Eina_Bool r;
+   int type;
 
-#define EET_T_TYPE(Eet_Type, Eet_Node_Type, Type)			\
-   case Eet_Type:							\
-     return eet_node_##Eet_Node_Type##_new(name, *((Type *) dd));	\
+   _eet_data_json_next(u);
+   at = u->p;
+   type = _eet_data_json_type(u);
+   if (type < 0) return EINA_FALSE;
 
-   switch (type)
+   if (!parent && type != EET_G_UNKNOWN)
+     return _eet_data_undump_error(u, at, "a structure expected");
+
+   if (type < EET_G_UNKNOWN)
      {
-	EET_T_TYPE(EET_T_CHAR, char, char);
-	EET_T_TYPE(EET_T_SHORT, short, short);
-	EET_T_TYPE(EET_T_INT, int, int);
-	EET_T_TYPE(EET_T_LONG_LONG, long_long, long long);
-	EET_T_TYPE(EET_T_FLOAT, float, float);
-	EET_T_TYPE(EET_T_DOUBLE, double, double);
-	EET_T_TYPE(EET_T_UCHAR, unsigned_char, unsigned char);
-	EET_T_TYPE(EET_T_USHORT, unsigned_short, unsigned short);
-	EET_T_TYPE(EET_T_UINT, unsigned_int, unsigned int);
-	EET_T_TYPE(EET_T_ULONG_LONG, unsigned_long_long, unsigned long long);
-	EET_T_TYPE(EET_T_STRING, string, char*);
-	EET_T_TYPE(EET_T_INLINED_STRING, inlined_string, char*);
-      case EET_T_NULL:
-	 return eet_node_null_new(name);
-      default:
-	 ERR("Unknow type passed to eet_data_node_simple_type");
-	 return NULL;
+	if (!_eet_data_json_simple_get(u, type, &v)) return EINA_FALSE;
+	if (!_eet_data_undump_value_add(u, parent, name, type, &v)) return EINA_FALSE;
+     }
+   else
+     {
+	/* items of a list, an array or a hash are named after it */
+	if (parent && parent->type != EET_G_UNKNOWN)
+	  name = parent->name;
+	/* the name outlives the buffers it is read in */
+	name = eina_stringshare_add(name ? name : "");
+	r = _eet_data_json_group(u, parent, name, type);
+	eina_stringshare_del(name);
+	if (!r) return EINA_FALSE;
      }
+
+   return _eet_data_json_expect(u, '}');
 }
 
-static int
-eet_data_get_unknown(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
-		     int type, int group_type __UNUSED__, void *data,
-		     char **p __UNUSED__, int *size __UNUSED__)
-{
-   int ret;
-   void *data_ret;
+static void *
+_eet_data_json_parse(Eet_Dictionary *ed,
+		     int *size_ret,
+		     const char *src,
+		     int size)
+{
+   Eet_Data_Undump u;
 
-   if (IS_SIMPLE_TYPE(type))
+   if (!_eet_data_undump_init(&u, ed, src, size)) goto on_error;
+
+   if (!_eet_data_json_next(&u))
      {
-	unsigned char dd[128];
+	_eet_data_undump_error(&u, u.p, "no structure to undump");
+	goto on_error;
+     }
+   if (!_eet_data_json_value(&u, NULL, NULL)) goto on_error;
 
-	ret = eet_data_get_type(ed, type, echnk->data, ((char *)echnk->data) + echnk->size, edd ? (char*) data : (char*) dd);
-	if (ret <= 0) return ret;
+   if (_eet_data_json_next(&u))
+     _eet_data_undump_error(&u, u.p, "text after the end of the top structure");
+   return _eet_data_undump_shutdown(&u, size_ret);
 
-	if (!edd)
+ on_error:
+   u.error = EINA_TRUE;
+   return _eet_data_undump_shutdown(&u, size_ret);
+}
+
+#define NEXT_CHUNK(P, Size, Echnk, Ed)                  \
+  {                                                     \
+     int        tmp;                                    \
+     tmp = Ed ? (int) (sizeof(int) * 2) : Echnk.len + 4;\
+     P += (4 + Echnk.size + tmp);                       \
+     Size -= (4 + Echnk.size + tmp);                    \
+  }
+
+/*
+ * Compact struct payload, written instead of one chunk per element once
+ * eet_data_descriptor_compact_set() is called on a descriptor:
+ *
+ *   "CPK" + version byte
+ *   int     schema hash of the descriptor, see _eet_data_descriptor_schema_hash
+ *   then one value per element, in declaration order:
+ *   char, uchar         the byte itself
+ *   other integers      varint, zigzag encoded when signed
+ *   fixed point         zigzag varint of the raw value
+ *   float, double       IEEE bits as an int or a long long
+ *   string              varint 0 for NULL, else with a dictionary the index
+ *                       of the string + 1, without one the size of the
+ *                       string with its nul followed by its bytes
+ *   inlined string      as a string without dictionary
+ *   null                nothing
+ *   anything else       varint size followed by the chunks the element
+ *                       would be written as without compact
+ *
+ * A tagged payload starts with a chunk, "CHK" or "CHnK", so both can be
+ * told apart. A payload written for another version of the descriptor is
+ * refused instead of being misread.
+ */
+#define EET_DATA_COMPACT_VERSION 1
+#define EET_DATA_COMPACT_IS(P, Size) \
+  ((Size) >= 8 && (P)[0] == 'C' && (P)[1] == 'P' && (P)[2] == 'K')
+
+#define ZIGZAG_ENCODE(V) (((unsigned long long)(V) << 1) ^ (unsigned long long)((long long)(V) >> 63))
+#define ZIGZAG_DECODE(U) ((long long)((U) >> 1) ^ -(long long)((U) & 1))
+
+static unsigned int
+_eet_data_schema_hash_add(unsigned int hash, const void *data, int length)
+{
+   const unsigned char *s = data;
+   int i;
+
+   /* FNV-1a */
+   for (i = 0; i < length; i++)
+     {
+	hash ^= s[i];
+	hash *= 16777619;
+     }
+
+   return hash;
+}
+
+/* everything the position and encoding of compact values depend on */
+static unsigned int
+_eet_data_descriptor_schema_hash(const Eet_Data_Descriptor *edd)
+{
+   unsigned int hash;
+   int i;
+
+   hash = _eet_data_schema_hash_add(2166136261U, edd->name, strlen(edd->name) + 1);
+   for (i = 0; i < edd->elements.num; i++)
+     {
+	Eet_Data_Element *ede = &(edd->elements.set[i]);
+
+	hash = _eet_data_schema_hash_add(hash, ede->name, strlen(ede->name) + 1);
+	hash = _eet_data_schema_hash_add(hash, &ede->type, 1);
+	hash = _eet_data_schema_hash_add(hash, &ede->group_type, 1);
+     }
+
+   return hash;
+}
+
+static void
+eet_data_stream_varint_write(Eet_Data_Stream *ds, unsigned long long value)
+{
+   unsigned char buf[10];
+   int n = 0;
+
+   do
+     {
+	buf[n] = value & 0x7F;
+	value >>= 7;
+	if (value) buf[n] |= 0x80;
+	n++;
+     }
+   while (value);
+
+   eet_data_stream_write(ds, buf, n);
+}
+
+static int
+eet_data_varint_get(const char *src, const char *src_end, unsigned long long *value)
+{
+   unsigned long long result = 0;
+   int n;
+
+   for (n = 0; n < 10 && src + n < src_end; n++)
+     {
+	unsigned char c = src[n];
+
+	result |= (unsigned long long)(c & 0x7F) << (7 * n);
+	if (!(c & 0x80))
 	  {
- 	     Eet_Node **parent = data;
-	     Eet_Node *node;
+	     *value = result;
+	     return n + 1;
+	  }
+     }
 
-	     node = eet_data_node_simple_type(type, echnk->name, dd);
+   return -1;
+}
 
-	     if (*parent) eet_node_struct_append(*parent, echnk->name, node);
-	     else *parent = node;
+/* turn the placeholder byte at start into the varint size of what follows */
+static void
+eet_data_stream_varint_patch(Eet_Data_Stream *ds, int start)
+{
+   unsigned char buf[10];
+   unsigned long long length;
+   int n = 0;
+
+   if (!ds->data || ds->pos <= start) return ;
+
+   length = ds->pos - start - 1;
+   do
+     {
+	buf[n] = length & 0x7F;
+	length >>= 7;
+	if (length) buf[n] |= 0x80;
+	n++;
+     }
+   while (length);
+
+   if (n > 1)
+     {
+	int end = ds->pos;
+
+	/* make room, the content moves up */
+	eet_data_stream_write(ds, buf, n - 1);
+	if (!ds->data) return ;
+	memmove(((char *)ds->data) + start + n,
+		((char *)ds->data) + start + 1,
+		end - start - 1);
+     }
+   memcpy(((char *)ds->data) + start, buf, n);
+}
+
+static Eina_Bool
+_eet_data_compact_put(Eet_Dictionary *ed, Eet_Data_Element *ede, Eet_Data_Stream *ds, const void *src)
+{
+   unsigned long long value;
+
+   switch (ede->type)
+     {
+      case EET_T_CHAR:
+      case EET_T_UCHAR:
+	 eet_data_stream_write(ds, src, 1);
+	 return EINA_TRUE;
+      case EET_T_SHORT:
+	 value = ZIGZAG_ENCODE(*(const short *)src);
+	 break;
+      case EET_T_INT:
+      case EET_T_F16P16:
+      case EET_T_F8P24:
+	 value = ZIGZAG_ENCODE(*(const int *)src);
+	 break;
+      case EET_T_LONG_LONG:
+      case EET_T_F32P32:
+	 value = ZIGZAG_ENCODE(*(const long long *)src);
+	 break;
+      case EET_T_USHORT:
+	 value = *(const unsigned short *)src;
+	 break;
+      case EET_T_UINT:
+	 value = *(const unsigned int *)src;
+	 break;
+      case EET_T_ULONG_LONG:
+	 value = *(const unsigned long long *)src;
+	 break;
+      case EET_T_FLOAT:
+	{
+	   int bits;
+
+	   memcpy(&bits, src, sizeof (int));
+	   CONV32(bits);
+	   eet_data_stream_write(ds, &bits, sizeof (int));
+	   return EINA_TRUE;
+	}
+      case EET_T_DOUBLE:
+	{
+	   long long bits;
+
+	   memcpy(&bits, src, sizeof (long long));
+	   CONV64(bits);
+	   eet_data_stream_write(ds, &bits, sizeof (long long));
+	   return EINA_TRUE;
+	}
+      case EET_T_STRING:
+      case EET_T_INLINED_STRING:
+	{
+	   const char *str = *(const char * const *)src;
+	   int idx;
+
+	   if (!str)
+	     value = 0;
+	   else if (ed && ede->type == EET_T_STRING)
+	     {
+		idx = eet_dictionary_string_add(ed, str);
+		if (idx < 0) return EINA_FALSE;
+		value = idx + 1;
+	     }
+	   else
+	     {
+		value = strlen(str) + 1;
+		eet_data_stream_varint_write(ds, value);
+		eet_data_stream_write(ds, str, value);
+		return EINA_TRUE;
+	     }
+	   break;
+	}
+      case EET_T_NULL:
+	 return EINA_TRUE;
+      default:
+	 return EINA_FALSE;
+     }
+
+   eet_data_stream_varint_write(ds, value);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_compact_encode(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, const void *data_in, Eet_Data_Stream *ds)
+{
+   unsigned char head[4] = { 'C', 'P', 'K', EET_DATA_COMPACT_VERSION };
+   unsigned int hash;
+   int i;
+
+   hash = edd->schema_hash;
+   CONV32(hash);
+   eet_data_stream_write(ds, head, sizeof (head));
+   eet_data_stream_write(ds, &hash, sizeof (hash));
+
+   for (i = 0; i < edd->elements.num; i++)
+     {
+	Eet_Data_Element *ede = &(edd->elements.set[i]);
+	void *src = ((char *)data_in) + ede->offset;
+
+	if (ede->group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(ede->type))
+	  {
+	     if (!_eet_data_compact_put(ed, ede, ds, src))
+	       return EINA_FALSE;
 	  }
 	else
 	  {
-	     if (type == EET_T_STRING)
-	       {
-		  char **str;
-
-		  str = (char **)(((char *)data));
-		  if (*str)
-		    {
-		       if ((ed == NULL) || (edd->func.str_direct_alloc == NULL))
-			 {
-			    *str = edd->func.str_alloc(*str);
-			    _eet_freelist_str_add(context, *str);
-			 }
-		       else
-			 {
-			    *str = edd->func.str_direct_alloc(*str);
-			    _eet_freelist_direct_str_add(context, *str);
-			 }
-		    }
-	       }
-	     else if (edd && type == EET_T_INLINED_STRING)
-	       {
-		  char **str;
+	     int start = ds->pos;
 
-		  str = (char **)(((char *)data));
-		  if (*str)
-		    {
-		       *str = edd->func.str_alloc(*str);
-		       _eet_freelist_str_add(context, *str);
-		    }
-	       }
+	     eet_data_stream_write(ds, "", 1);
+	     eet_group_codec[ede->group_type - 100].put(ed, edd, ede, ds, src);
+	     eet_data_stream_varint_patch(ds, start);
 	  }
      }
-   else
+
+   return ds->data != NULL;
+}
+
+static int
+_eet_data_compact_get(Eet_Free_Context *context, const Eet_Dictionary *ed,
+		      Eet_Data_Descriptor *edd, int type,
+		      const char *src, const char *src_end, void *dst)
+{
+   unsigned long long value;
+   int n;
+
+   switch (type)
      {
-	Eet_Data_Descriptor *subtype;
+      case EET_T_CHAR:
+      case EET_T_UCHAR:
+	 if (src + 1 > src_end) return -1;
+	 *(char *)dst = *src;
+	 return 1;
+      case EET_T_FLOAT:
+	{
+	   int bits;
+
+	   if (src + sizeof (int) > src_end) return -1;
+	   memcpy(&bits, src, sizeof (int));
+	   CONV32(bits);
+	   memcpy(dst, &bits, sizeof (int));
+	   return sizeof (int);
+	}
+      case EET_T_DOUBLE:
+	{
+	   long long bits;
+
+	   if (src + sizeof (long long) > src_end) return -1;
+	   memcpy(&bits, src, sizeof (long long));
+	   CONV64(bits);
+	   memcpy(dst, &bits, sizeof (long long));
+	   return sizeof (long long);
+	}
+      case EET_T_NULL:
+	 return 0;
+      default:
+	 break;
+     }
 
-	subtype = ede ? ede->subtype : NULL;
+   n = eet_data_varint_get(src, src_end, &value);
+   if (n < 0) return -1;
 
-	if (subtype || !edd)
+   switch (type)
+     {
+      case EET_T_SHORT:
+	 *(short *)dst = ZIGZAG_DECODE(value);
+	 break;
+      case EET_T_INT:
+      case EET_T_F16P16:
+      case EET_T_F8P24:
+	 *(int *)dst = ZIGZAG_DECODE(value);
+	 break;
+      case EET_T_LONG_LONG:
+      case EET_T_F32P32:
+	 *(long long *)dst = ZIGZAG_DECODE(value);
+	 break;
+      case EET_T_USHORT:
+	 *(unsigned short *)dst = value;
+	 break;
+      case EET_T_UINT:
+	 *(unsigned int *)dst = value;
+	 break;
+      case EET_T_ULONG_LONG:
+	 *(unsigned long long *)dst = value;
+	 break;
+      case EET_T_STRING:
+      case EET_T_INLINED_STRING:
+	{
+	   const char *str;
+
+	   if (value == 0)
+	     {
+		*(char **)dst = NULL;
+		break;
+	     }
+
+	   if (ed && type == EET_T_STRING)
+	     {
+		if (value > INT_MAX) return -1;
+		str = eet_dictionary_string_get_char(ed, value - 1);
+		if (!str) return -1;
+		*(char **)dst = _eet_data_str_alloc(context, ed, edd, str, EINA_TRUE);
+		break;
+	     }
+
+	   if (value > (unsigned long long)(src_end - src - n)) return -1;
+	   str = src + n;
+	   if (str[value - 1] != '\0') return -1;
+	   *(char **)dst = _eet_data_str_alloc(context, ed, edd, str, EINA_FALSE);
+	   n += value;
+	   break;
+	}
+      default:
+	 return -1;
+     }
+
+   return n;
+}
+
+/* the size of a compact value of a type, to step over it */
+static int
+_eet_data_compact_skip(const Eet_Dictionary *ed, int type,
+		       const char *src, const char *src_end)
+{
+   unsigned long long value;
+   int n;
+
+   switch (type)
+     {
+      case EET_T_CHAR:
+      case EET_T_UCHAR:
+	 n = 1;
+	 break;
+      case EET_T_FLOAT:
+	 n = sizeof (int);
+	 break;
+      case EET_T_DOUBLE:
+	 n = sizeof (long long);
+	 break;
+      case EET_T_NULL:
+	 return 0;
+      default:
+	 n = eet_data_varint_get(src, src_end, &value);
+	 if (n < 0) return -1;
+	 if (type == EET_T_INLINED_STRING || (type == EET_T_STRING && !ed))
+	   {
+	      if (value > (unsigned long long)(src_end - src - n)) return -1;
+	      n += value;
+	   }
+	 return n;
+     }
+
+   if (src + n > src_end) return -1;
+   return n;
+}
+
+static Eina_Bool
+_eet_data_compact_decode(Eet_Free_Context *context, const Eet_Dictionary *ed,
+			 Eet_Data_Descriptor *edd, void *data, char *p, int size)
+{
+   Eet_Data_Translation *tr = NULL;
+   const char *end = p + size;
+   unsigned int hash;
+   int num;
+   int i;
+
+   if (p[3] != EET_DATA_COMPACT_VERSION) return EINA_FALSE;
+   memcpy(&hash, p + 4, sizeof (hash));
+   CONV32(hash);
+   if (hash != edd->schema_hash)
+     {
+	Eina_List *l;
+
+	EINA_LIST_FOREACH(edd->translations, l, tr)
+	  if (tr->schema_hash == hash)
+	    break;
+	if (!l)
 	  {
- 	     Eet_Node **parent = data;
-	     void **ptr;
+	     ERR("Compact data for '%s' was written with another descriptor.", edd->name);
+	     return EINA_FALSE;
+	  }
+     }
+   p += 8;
 
-	     data_ret = _eet_data_descriptor_decode(context, ed, subtype, echnk->data, echnk->size);
-	     if (!data_ret) return 0;
+   num = tr ? tr->num : edd->elements.num;
+   for (i = 0; i < num; i++)
+     {
+	Eet_Data_Element *ede;
+	void *dst = NULL;
+	int type, group_type;
+	int n;
 
-	     if (edd)
-	       {
-		  ptr = (void **)(((char *)data));
-		  *ptr = (void *)data_ret;
-	       }
+	if (tr)
+	  {
+	     ede = tr->steps[i].index < 0 ? NULL : &(edd->elements.set[tr->steps[i].index]);
+	     type = tr->steps[i].type;
+	     group_type = tr->steps[i].group_type;
+	  }
+	else
+	  {
+	     ede = &(edd->elements.set[i]);
+	     type = ede->type;
+	     group_type = ede->group_type;
+	  }
+	if (ede) dst = ((char *)data) + ede->offset;
+
+	if (group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(type))
+	  {
+	     if (!ede)
+	       n = _eet_data_compact_skip(ed, type, p, end);
+	     else if (type == ede->type)
+	       n = _eet_data_compact_get(context, ed, edd, type, p, end, dst);
 	     else
 	       {
-		  Eet_Node *node = data_ret;
+		  unsigned char dd[sizeof (long long)];
 
-		  if (*parent)
-		    {
-		       node = eet_node_struct_child_new(echnk->name, node);
-		       eet_node_struct_append(*parent, echnk->name, node);
-		    }
-		  else *parent = node;
+		  n = _eet_data_compact_get(context, ed, edd, type, p, end, dd);
+		  if (n >= 0) eet_data_type_widen(type, dd, ede->type, dst);
+	       }
+	     if (n < 0) return EINA_FALSE;
+	     p += n;
+	  }
+	else
+	  {
+	     unsigned long long length;
+	     char *chunks;
+	     int left;
+
+	     n = eet_data_varint_get(p, end, &length);
+	     if (n < 0 || length > (unsigned long long)(end - p - n))
+	       return EINA_FALSE;
+
+	     chunks = p + n;
+	     left = length;
+	     p = chunks + length;
+	     if (!ede) continue ;
+
+	     while (left > 0)
+	       {
+		  Eet_Data_Chunk echnk;
+		  int head;
+
+		  memset(&echnk, 0, sizeof(Eet_Data_Chunk));
+		  eet_data_chunk_get(ed, &echnk, chunks, left);
+		  if (!echnk.name) return EINA_FALSE;
+
+		  /* the chunk has to fit in the member and be of its kind */
+		  head = 4 + (ed ? (int) (sizeof(int) * 2) : echnk.len + 4);
+		  if (echnk.size > left - head
+		      || echnk.group_type != ede->group_type)
+		    return EINA_FALSE;
+
+		  if (eet_group_codec[ede->group_type - 100].get(context,
+								 ed, edd, ede, &echnk,
+								 ede->type, ede->group_type, dst,
+								 &chunks, &left) <= 0)
+		    return EINA_FALSE;
+
+		  NEXT_CHUNK(chunks, left, echnk, ed);
 	       }
 	  }
      }
 
-   return 1;
+   return EINA_TRUE;
 }
 
-static void
-eet_data_put_array(Eet_Dictionary *ed, Eet_Data_Descriptor *edd __UNUSED__, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+/*
+ * Columns, written instead of one struct chunk per item for the lists and
+ * arrays of a descriptor once eet_data_descriptor_columnar_set() is called
+ * on it. A list is then a single chunk, an array keeps its count chunk and
+ * the columns follow the count:
+ *
+ *   "COL" + version byte
+ *   varint  number of rows
+ *   varint  number of columns
+ *   then for each column:
+ *   name    the element name, nul terminated, empty for the chunks column
+ *   byte    the element type
+ *   byte    how the values are encoded
+ *   varint  size of the values
+ *   values
+ *
+ * Basic members have a column each, in declaration order:
+ *   integers, fixed point   DELTA or RLE, whichever is smaller
+ *   float, double           RAW
+ *   strings                 DICT
+ * Everything else of a row is kept in one last CHUNKS column.
+ *
+ *   RAW     the values back to back, little endian IEEE bits
+ *   DELTA   zigzag varint of the difference with the value of the row before
+ *   RLE     zigzag varint of a value, then varint of how many rows have it
+ *   DICT    varint number of distinct strings, each nul terminated, then
+ *           the index of the string of each row, 0 for NULL, as an integer
+ *           column starting with its encoding byte
+ *   CHUNKS  for each row, varint size of the chunks of its other members
+ *           followed by those chunks
+ *
+ * Columns are found by name and skipped whole when the descriptor has no
+ * use for them, so decoding a single member of a long list doesn't touch
+ * the values of the others.
+ */
+#define EET_DATA_COLUMNS_VERSION 1
+#define EET_DATA_COLUMNS_IS(P, Size) \
+  ((Size) >= 6 && (P)[0] == 'C' && (P)[1] == 'O' && (P)[2] == 'L')
+
+#define EET_DATA_COLUMN_RAW 0
+#define EET_DATA_COLUMN_DELTA 1
+#define EET_DATA_COLUMN_RLE 2
+#define EET_DATA_COLUMN_DICT 3
+#define EET_DATA_COLUMN_CHUNKS 4
+
+#define EET_DATA_COLUMN_IS_INT(Type) \
+  (IS_SIMPLE_TYPE(Type) && (Type) != EET_T_FLOAT && (Type) != EET_T_DOUBLE \
+   && !IS_POINTER_TYPE(Type))
+
+typedef struct _Eet_Data_Column_Dict Eet_Data_Column_Dict;
+
+/* the distinct strings of a column, while it is written */
+struct _Eet_Data_Column_Dict
 {
-   void *data;
-   int offset = 0;
-   int subsize;
-   int count;
-   int size;
-   int j;
+   const char **strings;
+   int          count;
+   int          size;
 
-   EET_ASSERT(!((ede->type > EET_T_UNKNOW) && (ede->type < EET_T_STRING)), return );
+   /* open addressing, index + 1 in strings, 0 for a free slot */
+   int         *slots;
+   int          mask;
+};
+
+static int
+eet_data_varint_size(unsigned long long value)
+{
+   int n = 1;
+
+   while (value >>= 7)
+     n++;
+   return n;
+}
+
+static long long
+_eet_data_column_int_get(int type, const void *src)
+{
+   switch (type)
+     {
+      case EET_T_CHAR: return *(const signed char *)src;
+      case EET_T_SHORT: return *(const short *)src;
+      case EET_T_INT:
+      case EET_T_F16P16:
+      case EET_T_F8P24:
+	 return *(const int *)src;
+      case EET_T_UCHAR: return *(const unsigned char *)src;
+      case EET_T_USHORT: return *(const unsigned short *)src;
+      case EET_T_UINT: return *(const unsigned int *)src;
+      default: return *(const long long *)src;
+     }
+}
+
+static void
+_eet_data_column_int_set(int type, void *dst, long long value)
+{
+   switch (type)
+     {
+      case EET_T_CHAR: *(char *)dst = value; break;
+      case EET_T_SHORT: *(short *)dst = value; break;
+      case EET_T_INT:
+      case EET_T_F16P16:
+      case EET_T_F8P24:
+	 *(int *)dst = value;
+	 break;
+      case EET_T_UCHAR: *(unsigned char *)dst = value; break;
+      case EET_T_USHORT: *(unsigned short *)dst = value; break;
+      case EET_T_UINT: *(unsigned int *)dst = value; break;
+      default: *(long long *)dst = value; break;
+     }
+}
+
+static void
+_eet_data_column_ints_put(Eet_Data_Stream *ds, const long long *values, int count)
+{
+   unsigned long long prev = 0;
+   unsigned char encoding;
+   int delta = 0;
+   int rle = 0;
+   int start;
+   int run;
+   int i;
+
+   for (i = 0; i < count; i++)
+     {
+	delta += eet_data_varint_size(ZIGZAG_ENCODE((unsigned long long) values[i] - prev));
+	prev = values[i];
+     }
+   for (i = 0; i < count; i += run)
+     {
+	for (run = 1; i + run < count && values[i + run] == values[i]; run++)
+	  ;
+	rle += eet_data_varint_size(ZIGZAG_ENCODE(values[i])) + eet_data_varint_size(run);
+     }
+
+   encoding = rle < delta ? EET_DATA_COLUMN_RLE : EET_DATA_COLUMN_DELTA;
+   eet_data_stream_write(ds, &encoding, 1);
+   start = ds->pos;
+   eet_data_stream_write(ds, "", 1);
+
+   prev = 0;
+   for (i = 0; i < count; i += run)
+     {
+	if (encoding == EET_DATA_COLUMN_DELTA)
+	  {
+	     eet_data_stream_varint_write(ds, ZIGZAG_ENCODE((unsigned long long) values[i] - prev));
+	     prev = values[i];
+	     run = 1;
+	     continue ;
+	  }
+
+	for (run = 1; i + run < count && values[i + run] == values[i]; run++)
+	  ;
+	eet_data_stream_varint_write(ds, ZIGZAG_ENCODE(values[i]));
+	eet_data_stream_varint_write(ds, run);
+     }
+
+   eet_data_stream_varint_patch(ds, start);
+}
+
+/* read the integer column at src, return its size or -1, with values
+ * NULL only check that it holds count rows */
+static int
+_eet_data_column_ints_get(const char *src, const char *src_end, long long *values, int count)
+{
+   unsigned long long length;
+   unsigned long long value;
+   unsigned long long prev = 0;
+   const char *p;
+   const char *end;
+   int encoding;
+   int n;
+   int i;
+
+   if (src >= src_end) return -1;
+   encoding = (unsigned char) *src;
+
+   n = eet_data_varint_get(src + 1, src_end, &length);
+   if (n < 0 || length > (unsigned long long)(src_end - src - 1 - n))
+     return -1;
+   p = src + 1 + n;
+   end = p + length;
+
+   for (i = 0; i < count; )
+     {
+	n = eet_data_varint_get(p, end, &value);
+	if (n < 0) return -1;
+	p += n;
+
+	if (encoding == EET_DATA_COLUMN_DELTA)
+	  {
+	     prev += ZIGZAG_DECODE(value);
+	     if (values) values[i] = prev;
+	     i++;
+	  }
+	else if (encoding == EET_DATA_COLUMN_RLE)
+	  {
+	     unsigned long long run;
+
+	     n = eet_data_varint_get(p, end, &run);
+	     if (n < 0 || run == 0 || run > (unsigned long long)(count - i))
+	       return -1;
+	     p += n;
+
+	     if (!values) i += run;
+	     else
+	       for (; run > 0; run--)
+		 values[i++] = ZIGZAG_DECODE(value);
+	  }
+	else
+	  return -1;
+     }
+
+   if (p != end) return -1;
+   return end - src;
+}
+
+static int
+_eet_data_column_dict_add(Eet_Data_Column_Dict *dict, const char *str)
+{
+   unsigned int hash;
+   int i;
+
+   if (!str) return 0;
+
+   /* keep the table at most half full */
+   if (dict->count * 2 >= dict->mask)
+     {
+	int *slots;
+	int size;
+	int j;
+
+	size = dict->mask ? (dict->mask + 1) * 2 : 64;
+	slots = calloc(size, sizeof (int));
+	if (!slots) return -1;
+
+	for (j = 0; j < dict->count; j++)
+	  {
+	     hash = _eet_data_schema_hash_add(2166136261U, dict->strings[j], strlen(dict->strings[j]));
+	     for (i = hash & (size - 1); slots[i]; i = (i + 1) & (size - 1))
+	       ;
+	     slots[i] = j + 1;
+	  }
+
+	free(dict->slots);
+	dict->slots = slots;
+	dict->mask = size - 1;
+     }
+
+   hash = _eet_data_schema_hash_add(2166136261U, str, strlen(str));
+   for (i = hash & dict->mask; dict->slots[i]; i = (i + 1) & dict->mask)
+     if (!strcmp(dict->strings[dict->slots[i] - 1], str))
+       return dict->slots[i];
+
+   if (dict->count == dict->size)
+     {
+	const char **strings;
+	int size;
+
+	size = dict->size ? dict->size * 2 : 64;
+	strings = realloc(dict->strings, size * sizeof (char *));
+	if (!strings) return -1;
+	dict->strings = strings;
+	dict->size = size;
+     }
+
+   dict->strings[dict->count++] = str;
+   dict->slots[i] = dict->count;
+   return dict->count;
+}
+
+static Eina_Bool
+_eet_data_column_strings_put(Eet_Data_Stream *ds, Eet_Data_Element *ede, void **rows, int count, long long *values)
+{
+   Eet_Data_Column_Dict dict;
+   const char *last = NULL;
+   long long index = 0;
+   Eina_Bool r = EINA_FALSE;
+   int i;
+
+   memset(&dict, 0, sizeof (dict));
+   for (i = 0; i < count; i++)
+     {
+	const char *str;
+
+	str = *(const char **)(((char *)rows[i]) + ede->offset);
+	/* rows often share the string of the one before */
+	if (!i || str != last)
+	  {
+	     index = _eet_data_column_dict_add(&dict, str);
+	     if (index < 0) break;
+	     last = str;
+	  }
+	values[i] = index;
+     }
+
+   if (i == count)
+     {
+	eet_data_stream_varint_write(ds, dict.count);
+	for (i = 0; i < dict.count; i++)
+	  eet_data_stream_write(ds, dict.strings[i], strlen(dict.strings[i]) + 1);
+	_eet_data_column_ints_put(ds, values, count);
+	r = EINA_TRUE;
+     }
+
+   free(dict.strings);
+   free(dict.slots);
+   return r;
+}
+
+/* EINA_FALSE when out of memory or when the rows have no member to put
+ * in a column, nothing is written then */
+static Eina_Bool
+eet_data_put_columns(Eet_Dictionary *ed, Eet_Data_Stream *ds, Eet_Data_Element *ede,
+		     void **rows, int count)
+{
+   unsigned char head[4] = { 'C', 'O', 'L', EET_DATA_COLUMNS_VERSION };
+   Eet_Data_Descriptor *subtype = ede->subtype;
+   long long *values;
+   Eina_Bool chunks = EINA_FALSE;
+   int columns = 0;
+   int start;
+   int i;
+   int j;
+
+   for (i = 0; i < subtype->elements.num; i++)
+     {
+	Eet_Data_Element *sede = &(subtype->elements.set[i]);
+
+	if (sede->group_type != EET_G_UNKNOWN || !IS_SIMPLE_TYPE(sede->type))
+	  chunks = EINA_TRUE;
+	else if (sede->type != EET_T_NULL)
+	  columns++;
+     }
+   /* the reader refuses rows that nothing covers */
+   if (!columns && !chunks) return EINA_FALSE;
+
+   values = malloc(count * sizeof (long long));
+   if (!values) return EINA_FALSE;
+
+   start = eet_data_chunk_open(ed, ds, ede->name, EET_T_UNKNOW, ede->group_type);
+   if (start < 0) goto on_error;
+
+   if (ede->group_type != EET_G_LIST)
+     {
+	int v = count;
+
+	CONV32(v);
+	eet_data_stream_write(ds, &v, sizeof (int));
+     }
+
+   eet_data_stream_write(ds, head, sizeof (head));
+   eet_data_stream_varint_write(ds, count);
+   eet_data_stream_varint_write(ds, columns + chunks);
+
+   for (i = 0; i < subtype->elements.num; i++)
+     {
+	Eet_Data_Element *sede = &(subtype->elements.set[i]);
+	unsigned char t[2];
+	int pos;
+
+	if (sede->group_type != EET_G_UNKNOWN || !IS_SIMPLE_TYPE(sede->type)
+	    || sede->type == EET_T_NULL)
+	  continue ;
+
+	t[0] = sede->type;
+	eet_data_stream_write(ds, sede->name, strlen(sede->name) + 1);
+
+	if (EET_DATA_COLUMN_IS_INT(sede->type))
+	  {
+	     /* the integer column writes its own encoding and size */
+	     eet_data_stream_write(ds, t, 1);
+	     for (j = 0; j < count; j++)
+	       values[j] = _eet_data_column_int_get(sede->type, ((char *)rows[j]) + sede->offset);
+	     _eet_data_column_ints_put(ds, values, count);
+	     continue ;
+	  }
+
+	t[1] = IS_POINTER_TYPE(sede->type) ? EET_DATA_COLUMN_DICT : EET_DATA_COLUMN_RAW;
+	eet_data_stream_write(ds, t, 2);
+	pos = ds->pos;
+	eet_data_stream_write(ds, "", 1);
+
+	if (t[1] == EET_DATA_COLUMN_DICT)
+	  {
+	     if (!_eet_data_column_strings_put(ds, sede, rows, count, values))
+	       goto on_error;
+	  }
+	else
+	  for (j = 0; j < count; j++)
+	    {
+	       if (sede->type == EET_T_FLOAT)
+		 {
+		    int bits;
+
+		    memcpy(&bits, ((char *)rows[j]) + sede->offset, sizeof (int));
+		    CONV32(bits);
+		    eet_data_stream_write(ds, &bits, sizeof (int));
+		 }
+	       else
+		 {
+		    long long bits;
+
+		    memcpy(&bits, ((char *)rows[j]) + sede->offset, sizeof (long long));
+		    CONV64(bits);
+		    eet_data_stream_write(ds, &bits, sizeof (long long));
+		 }
+	    }
+
+	eet_data_stream_varint_patch(ds, pos);
+     }
+
+   if (chunks)
+     {
+	unsigned char t[2] = { EET_T_UNKNOW, EET_DATA_COLUMN_CHUNKS };
+	int pos;
+
+	eet_data_stream_write(ds, "", 1);
+	eet_data_stream_write(ds, t, 2);
+	pos = ds->pos;
+	eet_data_stream_write(ds, "", 1);
+
+	for (j = 0; j < count; j++)
+	  {
+	     int row = ds->pos;
+
+	     eet_data_stream_write(ds, "", 1);
+	     for (i = 0; i < subtype->elements.num; i++)
+	       {
+		  Eet_Data_Element *sede = &(subtype->elements.set[i]);
+
+		  if (sede->group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(sede->type))
+		    continue ;
+		  eet_group_codec[sede->group_type - 100].put(ed, subtype, sede, ds,
+							      ((char *)rows[j]) + sede->offset);
+	       }
+	     eet_data_stream_varint_patch(ds, row);
+	  }
+
+	eet_data_stream_varint_patch(ds, pos);
+     }
+
+   eet_data_chunk_close(ds, start);
+   free(values);
+   return EINA_TRUE;
+
+ on_error:
+   if (start >= 0 && ds->data) ds->pos = start;
+   free(values);
+   return EINA_FALSE;
+}
+
+/* the number of rows of the columns at src, -1 if they are broken */
+static int
+_eet_data_columns_count(const char *src, int size)
+{
+   unsigned long long count;
+
+   if (!EET_DATA_COLUMNS_IS(src, size) || src[3] != EET_DATA_COLUMNS_VERSION)
+     return -1;
+   if (eet_data_varint_get(src + 4, src + size, &count) < 0 || count > INT_MAX)
+     return -1;
+   return count;
+}
+
+/* the number of rows of the columns at src once every column is known to
+ * hold them all, -1 if they are broken, so that a short payload can't ask
+ * for many rows before any of them is read */
+static int
+_eet_data_columns_check(const char *src, int size)
+{
+   unsigned long long columns;
+   const char *end = src + size;
+   const char *p;
+   int count;
+   int n;
+
+   count = _eet_data_columns_count(src, size);
+   if (count < 0) return -1;
+
+   p = src + 4;
+   p += eet_data_varint_get(p, end, &columns);
+   n = eet_data_varint_get(p, end, &columns);
+   if (n < 0) return -1;
+   p += n;
+
+   /* rows that no column covers would cost nothing to ask for */
+   if (count > 0 && !columns) return -1;
+
+   for (; columns > 0; columns--)
+     {
+	unsigned long long length;
+	const char *values;
+	const char *s;
+	int type;
+	int encoding;
+	int i;
+
+	s = memchr(p, '\0', end - p);
+	if (!s || end - s < 4) return -1;
+	type = (unsigned char) s[1];
+	encoding = (unsigned char) s[2];
+
+	n = eet_data_varint_get(s + 3, end, &length);
+	if (n < 0 || length > (unsigned long long)(end - s - 3 - n)) return -1;
+	values = s + 3 + n;
+
+	if (p == s ? encoding != EET_DATA_COLUMN_CHUNKS
+	    : (!IS_SIMPLE_TYPE(type) || type == EET_T_NULL || type > EET_T_F8P24))
+	  return -1;
+
+	switch (encoding)
+	  {
+	   case EET_DATA_COLUMN_DELTA:
+	   case EET_DATA_COLUMN_RLE:
+	      if (!EET_DATA_COLUMN_IS_INT(type)
+		  || _eet_data_column_ints_get(s + 2, end, NULL, count) != n + 1 + (int) length)
+		return -1;
+	      break;
+	   case EET_DATA_COLUMN_RAW:
+	      if ((type != EET_T_FLOAT && type != EET_T_DOUBLE)
+		  || (unsigned long long) count * eet_basic_codec[type - 1].size != length)
+		return -1;
+	      break;
+	   case EET_DATA_COLUMN_DICT:
+	      {
+		 unsigned long long distinct;
+		 const char *dend = values + length;
+		 const char *d = values;
+
+		 if (!IS_POINTER_TYPE(type)) return -1;
+		 n = eet_data_varint_get(d, dend, &distinct);
+		 if (n < 0 || distinct > (unsigned long long)(dend - d)) return -1;
+		 for (d += n; distinct > 0; distinct--)
+		   {
+		      d = memchr(d, '\0', dend - d);
+		      if (!d) return -1;
+		      d++;
+		   }
+		 if (_eet_data_column_ints_get(d, dend, NULL, count) != dend - d)
+		   return -1;
+		 break;
+	      }
+	   case EET_DATA_COLUMN_CHUNKS:
+	      {
+		 const char *cend = values + length;
+		 const char *c = values;
+
+		 if (p != s) return -1;
+		 for (i = 0; i < count; i++)
+		   {
+		      unsigned long long row;
+
+		      n = eet_data_varint_get(c, cend, &row);
+		      if (n < 0 || row > (unsigned long long)(cend - c - n)) return -1;
+		      c += n + row;
+		   }
+		 break;
+	      }
+	   default:
+	      return -1;
+	  }
+
+	p = values + length;
+     }
+
+   return count;
+}
+
+/* the chunks of the members without a column, for one row */
+static Eina_Bool
+_eet_data_column_chunks_get(Eet_Free_Context *context, const Eet_Dictionary *ed,
+			    Eet_Data_Descriptor *edd, void *row, char *chunks, int left)
+{
+   while (left > 0)
+     {
+	Eet_Data_Chunk echnk;
+	Eet_Data_Element *ede;
+
+	memset(&echnk, 0, sizeof(Eet_Data_Chunk));
+	eet_data_chunk_get(ed, &echnk, chunks, left);
+	if (!echnk.name) return EINA_FALSE;
+
+	ede = _eet_descriptor_hash_find(edd, echnk.name, echnk.len);
+	if (ede && ede->group_type == echnk.group_type
+	    && !(ede->group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(ede->type)))
+	  {
+	     if (eet_group_codec[ede->group_type - 100].get(context,
+							    ed, edd, ede, &echnk,
+							    ede->type, ede->group_type,
+							    ((char *)row) + ede->offset,
+							    &chunks, &left) <= 0)
+	       return EINA_FALSE;
+	  }
+
+	NEXT_CHUNK(chunks, left, echnk, ed);
+     }
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_column_strings_get(Eet_Free_Context *context, const Eet_Dictionary *ed,
+			     Eet_Data_Descriptor *edd, Eet_Data_Element *ede,
+			     const char *p, const char *end,
+			     void **rows, int count, long long *values)
+{
+   unsigned long long distinct;
+   const char **strings;
+   Eina_Bool r = EINA_FALSE;
+   int n;
+   int i;
+
+   n = eet_data_varint_get(p, end, &distinct);
+   if (n < 0 || distinct > (unsigned long long)(end - p)) return EINA_FALSE;
+   p += n;
+
+   strings = malloc((distinct + 1) * sizeof (char *));
+   if (!strings) return EINA_FALSE;
+
+   strings[0] = NULL;
+   for (i = 1; i <= (int) distinct; i++)
+     {
+	const char *s = memchr(p, '\0', end - p);
+
+	if (!s) goto on_error;
+	strings[i] = p;
+	p = s + 1;
+     }
+
+   if (_eet_data_column_ints_get(p, end, values, count) != end - p)
+     goto on_error;
+
+   for (i = 0; i < count; i++)
+     {
+	char **dst = (char **)(((char *)rows[i]) + ede->offset);
+
+	if (values[i] < 0 || values[i] > (long long) distinct) goto on_error;
+	if (!values[i])
+	  *dst = NULL;
+	else
+	  {
+	     *dst = _eet_data_str_alloc(context, ed, edd, strings[values[i]], EINA_FALSE);
+	     if (!*dst) goto on_error;
+	  }
+     }
+   r = EINA_TRUE;
+
+ on_error:
+   free(strings);
+   return r;
+}
+
+/* decode the columns at src in count rows */
+static Eina_Bool
+_eet_data_columns_get(Eet_Free_Context *context, const Eet_Dictionary *ed,
+		      Eet_Data_Descriptor *edd, char *src, int size,
+		      void **rows, int count)
+{
+   unsigned long long columns;
+   long long *values;
+   const char *end = src + size;
+   char *p;
+   Eina_Bool r = EINA_FALSE;
+   int n;
+
+   if (_eet_data_columns_count(src, size) != count) return EINA_FALSE;
+
+   /* skip the number of rows, already checked */
+   p = src + 4;
+   p += eet_data_varint_get(p, end, &columns);
+   n = eet_data_varint_get(p, end, &columns);
+   if (n < 0) return EINA_FALSE;
+   p += n;
+
+   values = malloc((count ? count : 1) * sizeof (long long));
+   if (!values) return EINA_FALSE;
+
+   for (; columns > 0; columns--)
+     {
+	unsigned long long length;
+	Eet_Data_Element *ede;
+	const char *name;
+	const char *s;
+	int type;
+	int encoding;
+	int i;
+
+	name = p;
+	s = memchr(p, '\0', end - p);
+	if (!s || end - s < 4) goto on_error;
+	type = (unsigned char) s[1];
+	encoding = (unsigned char) s[2];
+	p = (char *) s + 2;
+
+	/* the encoding byte, then the size of the values */
+	n = eet_data_varint_get(p + 1, end, &length);
+	if (n < 0 || length > (unsigned long long)(end - p - 1 - n)) goto on_error;
+	n++;
+
+	ede = NULL;
+	if (*name)
+	  {
+	     if (!IS_SIMPLE_TYPE(type) || type == EET_T_NULL || type > EET_T_F8P24)
+	       goto on_error;
+
+	     ede = _eet_descriptor_hash_find(edd, name, s - name + 1);
+	     /* not wanted, or not something it can be read in */
+	     if (ede && (ede->group_type != EET_G_UNKNOWN
+			 || !(type == ede->type
+			      || (IS_POINTER_TYPE(type) && IS_POINTER_TYPE(ede->type)
+				  && ede->type != EET_T_NULL)
+			      || eet_data_type_widen_match(type, ede->type))))
+	       ede = NULL;
+	  }
+
+	switch (encoding)
+	  {
+	   case EET_DATA_COLUMN_DELTA:
+	   case EET_DATA_COLUMN_RLE:
+	      if (!EET_DATA_COLUMN_IS_INT(type)) goto on_error;
+	      if (!ede) break;
+	      if (_eet_data_column_ints_get(p, end, values, count) != n + (int) length)
+		goto on_error;
+	      for (i = 0; i < count; i++)
+		_eet_data_column_int_set(ede->type, ((char *)rows[i]) + ede->offset, values[i]);
+	      break;
+	   case EET_DATA_COLUMN_RAW:
+	      {
+		 const char *v = p + n;
+		 int width;
+
+		 if (!ede) break;
+		 if (type != EET_T_FLOAT && type != EET_T_DOUBLE) goto on_error;
+		 width = eet_basic_codec[type - 1].size;
+		 if ((unsigned long long) count * width != length) goto on_error;
+
+		 for (i = 0; i < count; i++, v += width)
+		   {
+		      void *dst = ((char *)rows[i]) + ede->offset;
+
+		      if (type == EET_T_FLOAT)
+			{
+			   int bits;
+			   float f;
+
+			   memcpy(&bits, v, sizeof (int));
+			   CONV32(bits);
+			   memcpy(&f, &bits, sizeof (int));
+			   if (ede->type == EET_T_DOUBLE) *(double *)dst = f;
+			   else *(float *)dst = f;
+			}
+		      else
+			{
+			   long long bits;
+
+			   memcpy(&bits, v, sizeof (long long));
+			   CONV64(bits);
+			   memcpy(dst, &bits, sizeof (long long));
+			}
+		   }
+		 break;
+	      }
+	   case EET_DATA_COLUMN_DICT:
+	      if (!ede) break;
+	      if (!IS_POINTER_TYPE(type)) goto on_error;
+	      if (!_eet_data_column_strings_get(context, ed, edd, ede, p + n, p + n + length,
+						rows, count, values))
+		goto on_error;
+	      break;
+	   case EET_DATA_COLUMN_CHUNKS:
+	      {
+		 const char *cend = p + n + length;
+		 char *c = p + n;
+
+		 if (*name) goto on_error;
+		 for (i = 0; i < count; i++)
+		   {
+		      unsigned long long row;
+		      int m;
+
+		      m = eet_data_varint_get(c, cend, &row);
+		      if (m < 0 || row > (unsigned long long)(cend - c - m)) goto on_error;
+		      c += m;
+		      if (!_eet_data_column_chunks_get(context, ed, edd, rows[i], c, row))
+			goto on_error;
+		      c += row;
+		   }
+		 break;
+	      }
+	   default:
+	      goto on_error;
+	  }
+
+	p += n + length;
+     }
+   r = EINA_TRUE;
+
+ on_error:
+   free(values);
+   return r;
+}
+
+static void *
+_eet_data_descriptor_decode(Eet_Free_Context *context,
+			    const Eet_Dictionary *ed,
+                            Eet_Data_Descriptor *edd,
+			    const void *data_in,
+			    int size_in)
+{
+   Eet_Node *result = NULL;
+   Eet_Data_Decode_Plan *plan = NULL;
+   Eet_Data_Lazy *lazy;
+   void *data = NULL;
+   char *p;
+   int size;
+   int cursor = 0;
+   Eet_Data_Chunk chnk;
+
+   /* only the outer structure is decoded lazily */
+   lazy = context->lazy;
+   context->lazy = NULL;
+
+   if (_eet_data_words_bigendian == -1)
+     {
+	unsigned long int v;
+
+	v = htonl(0x12345678);
+	if (v == 0x12345678) _eet_data_words_bigendian = 1;
+	else _eet_data_words_bigendian = 0;
+     }
+
+   if (edd)
+     {
+	data = _eet_data_mem_alloc(context, edd, edd->size);
+	if (!data) return NULL;
+     }
+   _eet_freelist_all_ref(context);
+   if (data) _eet_freelist_add(context, data);
+   memset(&chnk, 0, sizeof(Eet_Data_Chunk));
+   eet_data_chunk_get(ed, &chnk, data_in, size_in);
+   if (!chnk.name) goto error;
+   if (edd)
+     {
+	if (strcmp(chnk.name, edd->name)) goto error;
+     }
+   p = chnk.data;
+   if (ed)
+     size = size_in - (4 + sizeof(int) * 2);
+   else
+     size = size_in - (4 + 4 + chnk.len);
+   if (edd)
+     {
+	/* skipped members would not follow the plan */
+	if (!lazy) plan = edd->plan;
+
+	if (EET_DATA_COMPACT_IS(p, size))
+	  {
+	     if (!_eet_data_compact_decode(context, ed, edd, data, p, size))
+	       goto error;
+	     size = 0;
+	  }
+     }
+   else
+     {
+	switch (chnk.group_type)
+	  {
+	   case EET_G_UNKNOWN:
+	      switch (chnk.type)
+		{
+		 case EET_T_STRING:
+		    return eet_node_string_new(chnk.name, chnk.data);
+		 case EET_T_INLINED_STRING:
+		    return eet_node_inlined_string_new(chnk.name, chnk.data);
+		 case EET_T_NULL:
+		    return eet_node_null_new(chnk.name);
+		 default:
+		    result = eet_node_struct_new(chnk.name, NULL);
+		}
+	      break;
+	   case EET_G_VAR_ARRAY:
+	      return eet_node_var_array_new(chnk.name, NULL);
+	   case EET_G_LIST:
+	   case EET_G_HASH:
+	   case EET_G_ARRAY:
+	   case EET_G_UNION:
+	   case EET_G_VARIANT:
+	   default:
+	      goto error;
+	  }
+     }
+   while (size > 0)
+     {
+	Eet_Data_Chunk echnk;
+	Eet_Data_Element *ede = NULL;
+	Eet_Node *child = NULL;
+	int group_type = EET_G_UNKNOWN, type = EET_T_UNKNOW;
+	int widen = 0;
+	int ret = 0;
+
+	/* get next data chunk */
+	memset(&echnk, 0, sizeof(Eet_Data_Chunk));
+	if (plan)
+	  ede = _eet_data_decode_plan_match(plan, &cursor, ed, &echnk, p, size);
+	if (ede)
+	  {
+	     /* the plan already checked that the chunk is what ede expects */
+	     group_type = ede->group_type;
+	     type = ede->type;
+	  }
+	else
+	  {
+	     memset(&echnk, 0, sizeof(Eet_Data_Chunk));
+	     eet_data_chunk_get(ed, &echnk, p, size);
+	     if (!echnk.name) goto error;
+	     /* FIXME: don't REPLY on edd - work without */
+	     if (edd)
+	       {
+		  ede = _eet_descriptor_hash_find(edd, echnk.name, echnk.len);
+		  if (ede)
+		    {
+		       /* carry on with the plan from there */
+		       if (plan) cursor = ede - edd->elements.set;
+
+		       group_type = ede->group_type;
+		       type = ede->type;
+		       if ((echnk.type == 0) && (echnk.group_type == 0))
+			 {
+			    type = ede->type;
+			    group_type = ede->group_type;
+			 }
+		       else
+			 {
+			    if (IS_SIMPLE_TYPE(echnk.type) &&
+				eet_data_type_match(echnk.type, ede->type))
+			      /* Needed when converting on the fly from FP to Float */
+			      type = ede->type;
+			    else if (IS_SIMPLE_TYPE(echnk.type) &&
+				     (echnk.group_type == EET_G_UNKNOWN) &&
+				     (ede->group_type == EET_G_UNKNOWN) &&
+				     eet_data_type_widen_match(echnk.type, ede->type))
+			      /* Written by a version with a smaller type */
+			      widen = echnk.type;
+			    else if ((echnk.group_type > EET_G_UNKNOWN) &&
+				     (echnk.group_type < EET_G_LAST) &&
+				     (echnk.group_type == ede->group_type))
+			      group_type = echnk.group_type;
+			 }
+		    }
+	       }
+	     /*...... dump to node */
+	     else
+	       {
+		  type = echnk.type;
+		  group_type = echnk.group_type;
+	       }
+	  }
+
+	if (lazy && ede
+	    && (group_type == EET_G_LIST || group_type == EET_G_HASH
+		|| group_type == EET_G_VAR_ARRAY
+		|| (group_type == EET_G_UNKNOWN && type == EET_T_UNKNOW)))
+	  {
+	     char *start = p;
+
+	     NEXT_CHUNK(p, size, echnk, ed);
+	     if (!_eet_data_lazy_defer(lazy, ede, start, p)) goto error;
+	     continue ;
+	  }
+
+	if (widen)
+	  {
+	     unsigned char dd[sizeof (long long)];
+
+	     ret = eet_data_chunk_value_get(ed, &echnk, widen, dd);
+	     if (ret <= 0) goto error;
+
+	     eet_data_type_widen(widen, dd, ede->type, ((char *)data) + ede->offset);
+	  }
+	else if (!edd && group_type == EET_G_UNKNOWN && IS_SIMPLE_TYPE(type))
+	  {
+	     unsigned char dd[128];
+
+	     ret = eet_data_chunk_value_get(ed, &echnk, type, dd);
+	     if (ret <= 0) goto error;
+
+	     child = eet_data_node_simple_type(type, echnk.name, dd);
+
+	     eet_node_struct_append(result, echnk.name, child);
+	  }
+	else
+	  {
+	     ret = eet_group_codec[group_type - 100].get(context,
+							 ed, edd, ede, &echnk,
+							 type, group_type, ede ? (void*) (((char *)data) + ede->offset) : (void**) &result,
+							 &p, &size);
+
+	     if (ret <= 0) goto error;
+	  }
+
+	/* advance to next chunk */
+        NEXT_CHUNK(p, size, echnk, ed);
+     }
+
+   _eet_freelist_all_unref(context);
+   if (!edd)
+     {
+	_eet_freelist_str_free(context, edd);
+	_eet_freelist_direct_str_free(context, edd);
+	_eet_freelist_list_free(context, edd);
+	_eet_freelist_hash_free(context, edd);
+	_eet_freelist_free(context, edd);
+     }
+   else
+     {
+	_eet_freelist_reset(context);
+	_eet_freelist_str_reset(context);
+	_eet_freelist_list_reset(context);
+	_eet_freelist_hash_reset(context);
+	_eet_freelist_direct_str_reset(context);
+     }
+
+   if (!edd)
+     return result;
+
+   return data;
+
+error:
+   eet_node_del(result);
+
+   _eet_freelist_all_unref(context);
+   _eet_freelist_str_free(context, edd);
+   _eet_freelist_direct_str_free(context, edd);
+   _eet_freelist_list_free(context, edd);
+   _eet_freelist_hash_free(context, edd);
+   _eet_freelist_free(context, edd);
+
+   /* FIXME: Warn that something goes wrong here. */
+   return NULL;
+}
+
+static int
+eet_data_get_list(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		  int type, int group_type __UNUSED__, void *data,
+		  char **p, int *size)
+{
+   Eet_Data_Descriptor *subtype = NULL;
+   void *list = NULL;
+   void **ptr;
+   void *data_ret;
+
+   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+
+   if (edd)
+     {
+	subtype = ede->subtype;
+
+	if (type != ede->type)
+	  return 0;
+     }
+
+   ptr = (void **)data;
+   list = *ptr;
+   data_ret = NULL;
+
+   if (!IS_POINTER_TYPE(type)
+       && EET_DATA_COLUMNS_IS((char *) echnk->data, echnk->size))
+     {
+	void **rows;
+	int count;
+	int i;
+
+	if (!edd)
+	  {
+	     ERR("Columns of '%s' can't be decoded without a descriptor.", echnk->name);
+	     return 0;
+	  }
+
+	count = _eet_data_columns_check(echnk->data, echnk->size);
+	if (count <= 0 || count > INT_MAX / (int) sizeof (void *)) return 0;
+
+	rows = malloc(count * sizeof (void *));
+	if (!rows) return 0;
+
+	for (i = 0; i < count; i++)
+	  {
+	     rows[i] = _eet_data_mem_alloc(context, subtype, subtype->size);
+	     if (!rows[i]) break;
+	     _eet_freelist_add(context, rows[i]);
+	  }
+
+	if (i < count
+	    || !_eet_data_columns_get(context, ed, subtype, echnk->data, echnk->size, rows, count))
+	  {
+	     free(rows);
+	     return 0;
+	  }
+
+	for (i = 0; i < count; i++)
+	  list = edd->func.list_append(list, rows[i]);
+	free(rows);
+
+	if (context->arena && !*ptr && list &&
+	    !_eet_data_arena_container_add(context->arena, ptr, edd->func.list_free, NULL))
+	  {
+	     edd->func.list_free(list);
+	     return 0;
+	  }
+	if (!*ptr) _eet_freelist_list_add(context, ptr);
+	*ptr = list;
+	return 1;
+     }
+
+   if (IS_POINTER_TYPE(type))
+     {
+	POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, type, &data_ret, p, size, on_error);
+     }
+   else
+     {
+	STRUCT_TYPE_DECODE(data_ret, context, ed, subtype, echnk->data, echnk->size, on_error);
+     }
+
+   if (edd)
+     {
+	list = edd->func.list_append(list, data_ret);
+	if (context->arena && !*ptr && list &&
+	    !_eet_data_arena_container_add(context->arena, ptr, edd->func.list_free, NULL))
+	  {
+	     edd->func.list_free(list);
+	     goto on_error;
+	  }
+	/* the list is released through the member it is stored in */
+	if (!*ptr) _eet_freelist_list_add(context, ptr);
+	*ptr = list;
+     }
+   else
+     {
+	eet_node_list_append(*((Eet_Node**) data), echnk->name, data_ret);
+     }
+
+   return 1;
+
+ on_error:
+   return 0;
+}
+
+static int
+eet_data_get_hash(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		  int type, int group_type __UNUSED__, void *data,
+		  char **p, int *size)
+{
+   void **ptr;
+   void *hash = NULL;
+   char *key = NULL;
+   void *data_ret = NULL;
+   int ret = 0;
+
+   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+
+   ptr = (void **)data;
+   hash = *ptr;
+
+   /* Read key */
+   ret = eet_data_get_type(ed,
+			   EET_T_STRING,
+			   echnk->data,
+			   ((char *)echnk->data) + echnk->size,
+			   &key);
+   if (ret <= 0) goto on_error;
+
+   /* Advance to next chunk */
+   NEXT_CHUNK((*p), (*size), (*echnk), ed);
+   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+
+   /* Read value */
+   eet_data_chunk_get(ed, echnk, *p, *size);
+   if (!echnk->name) goto on_error;
+
+   if (IS_POINTER_TYPE(echnk->type))
+     {
+	POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, echnk->type, &data_ret, p, size, on_error);
+     }
+   else
+     {
+	STRUCT_TYPE_DECODE(data_ret, context, ed, ede ? ede->subtype : NULL, echnk->data, echnk->size, on_error);
+     }
+
+   if (edd)
+     {
+	hash = edd->func.hash_add(hash, key, data_ret);
+	if (context->arena && !*ptr && hash &&
+	    !_eet_data_arena_container_add(context->arena, ptr, NULL, edd->func.hash_free))
+	  {
+	     edd->func.hash_free(hash);
+	     goto on_error;
+	  }
+	if (hash != *ptr) _eet_freelist_hash_add(context, hash);
+	*ptr = hash;
+     }
+   else
+     {
+	eet_node_hash_add(*((Eet_Node **) data), echnk->name, key, data_ret);
+     }
+
+   return 1;
+
+ on_error:
+   return ret;
+}
+
+/*
+ * Arrays of char, short, int, long long, float and double (and their
+ * unsigned versions) keep their values in the chunk that holds the number
+ * of elements, instead of one implicit structure chunk per element:
+ *
+ *   int            number of elements
+ *   unsigned char  type of the elements
+ *   then the values back to back, little endian, float and double as
+ *   their IEEE bits.
+ *
+ * The count chunk of other arrays only holds the int, so a longer payload
+ * tells a packed array apart.
+ */
+static int
+eet_data_packed_type(const Eet_Data_Element *ede)
+{
+   int type;
+
+   if (ede->group_type != EET_G_ARRAY
+       && ede->group_type != EET_G_VAR_ARRAY)
+     return EET_T_UNKNOW;
+   if (!ede->subtype || !ede->subtype->implicit)
+     return EET_T_UNKNOW;
+
+   type = ede->subtype->elements.set[0].type;
+   if (!IS_PACKED_TYPE(type)) return EET_T_UNKNOW;
+   return type;
+}
+
+/* copy count little endian values of width bytes to or from the host order */
+static void
+eet_data_packed_copy(void *dst, const void *src, int count, int width)
+{
+   if (_eet_data_words_bigendian)
+     switch (width)
+       {
+	case 2: eet_swap16(dst, src, count); return ;
+	case 4: eet_swap32(dst, src, count); return ;
+	case 8: eet_swap64(dst, src, count); return ;
+	default: break;
+       }
+
+   if (dst != src) memcpy(dst, src, count * width);
+}
+
+static void
+eet_data_put_packed_array(Eet_Dictionary *ed, Eet_Data_Stream *ds,
+			  const char *name, int type, int group_type,
+			  const void *src, int count)
+{
+   unsigned char t = type;
+   int width;
+   int start;
+   int pos;
+   int v;
+
+   width = eet_basic_codec[type - 1].size;
+
+   start = eet_data_chunk_open(ed, ds, name, EET_T_UNKNOW, group_type);
+   if (start < 0) return ;
+
+   v = count;
+   CONV32(v);
+   eet_data_stream_write(ds, &v, sizeof (int));
+   eet_data_stream_write(ds, &t, 1);
+
+   pos = ds->pos;
+   eet_data_stream_write(ds, src, count * width);
+   if (!ds->data) return ;
+   eet_data_packed_copy(((char *)ds->data) + pos, ((char *)ds->data) + pos, count, width);
+
+   eet_data_chunk_close(ds, start);
+}
+
+static int
+eet_data_get_packed_array(Eet_Free_Context *context, Eet_Data_Descriptor *edd,
+			  Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+			  int count, int group_type, void *data)
+{
+   const char *src;
+   int type;
+   int width;
+   int size;
+
+   src = ((const char *)echnk->data) + sizeof (int);
+   size = echnk->size - sizeof (int) - 1;
+
+   type = (unsigned char) *src++;
+   if (!IS_PACKED_TYPE(type)) return 0;
+
+   width = eet_basic_codec[type - 1].size;
+   if (count <= 0 || count > size / width || count * width != size)
+     return 0;
+
+   if (edd)
+     {
+	void *dst;
+
+	/* not in the descriptor, skip it */
+	if (!ede) return 1;
+	if (eet_data_packed_type(ede) != type) return 0;
+
+	if (group_type == EET_G_ARRAY)
+	  {
+	     if (count > ede->counter_offset) return 0;
+	     dst = data;
+	  }
+	else
+	  {
+	     /* store the number of elements
+	      * on the counter offset */
+	     *(int *)(((char *)data) + ede->count - ede->offset) = count;
+
+	     dst = _eet_data_mem_alloc(context, edd, size);
+	     if (!dst) return 0;
+	     *(void **)data = dst;
+
+	     _eet_freelist_add(context, dst);
+	  }
+
+	eet_data_packed_copy(dst, src, count, width);
+     }
+   else
+     {
+	Eet_Node *parent = *((Eet_Node **) data);
+	Eet_Node *array;
+	Eina_List *childs = NULL;
+	Eet_Node *tmp;
+	int i;
+
+	for (i = 0; i < count; i++, src += width)
+	  {
+	     unsigned char dd[8];
+
+	     eet_data_packed_copy(dd, src, 1, width);
+
+	     tmp = eet_data_node_simple_type(type, echnk->name, dd);
+	     if (!tmp) goto on_error;
+	     childs = eina_list_append(childs, tmp);
+	  }
+
+	if (group_type == EET_G_ARRAY)
+	  array = eet_node_array_new(echnk->name, count, childs);
+	else
+	  array = eet_node_var_array_new(echnk->name, childs);
+
+	if (!array) goto on_error;
+
+	eet_node_struct_append(parent, echnk->name, array);
+	return 1;
+
+     on_error:
+	EINA_LIST_FREE(childs, tmp)
+	  eet_node_del(tmp);
+	return 0;
+     }
+
+   return 1;
+}
+
+static int
+eet_data_get_columns_array(Eet_Free_Context *context, const Eet_Dictionary *ed,
+			   Eet_Data_Descriptor *edd, Eet_Data_Element *ede,
+			   Eet_Data_Chunk *echnk, int count, int group_type, void *data)
+{
+   char *src;
+   void **rows;
+   char *dst;
+   int subsize;
+   int size;
+   int i;
+
+   src = ((char *)echnk->data) + sizeof (int);
+   size = echnk->size - sizeof (int);
+
+   if (!edd)
+     {
+	ERR("Columns of '%s' can't be decoded without a descriptor.", echnk->name);
+	return 0;
+     }
+   /* not in the descriptor, skip it */
+   if (!ede) return 1;
+
+   if (IS_POINTER_TYPE(ede->type) || !ede->subtype
+       || count <= 0 || _eet_data_columns_check(src, size) != count)
+     return 0;
+
+   subsize = ede->subtype->size;
+   if (subsize <= 0 || count > INT_MAX / subsize) return 0;
+
+   if (group_type == EET_G_ARRAY)
+     {
+	if (count > ede->counter_offset) return 0;
+	dst = data;
+     }
+   else
+     {
+	/* store the number of elements
+	 * on the counter offset */
+	*(int *)(((char *)data) + ede->count - ede->offset) = count;
+
+	dst = _eet_data_mem_alloc(context, edd, count * subsize);
+	if (!dst) return 0;
+	memset(dst, 0, count * subsize);
+	*(void **)data = dst;
+
+	_eet_freelist_add(context, dst);
+     }
+
+   rows = malloc(count * sizeof (void *));
+   if (!rows) return 0;
+
+   for (i = 0; i < count; i++)
+     rows[i] = dst + i * subsize;
+
+   i = _eet_data_columns_get(context, ed, ede->subtype, src, size, rows, count);
+   free(rows);
+   return i;
+}
+
+/* var arrays and fixed arrays have to
+ * get all chunks at once. for fixed arrays
+ * we can get each chunk and increment a
+ * counter stored on the element itself but
+ * it wont be thread safe. for var arrays
+ * we still need a way to get the number of
+ * elements from the data, so storing the
+ * number of elements and the element data on
+ * each chunk is pointless.
+ */
+static int
+eet_data_get_array(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd,
+		   Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		   int type, int group_type, void *data,
+		   char **p, int *size)
+{
+   Eina_List *childs = NULL;
+   const char *name;
+   Eet_Node *tmp;
+   void *ptr;
+   int count;
+   int ret;
+   int subsize = 0;
+   int i;
+
+   EET_ASSERT(!((type > EET_T_UNKNOW) && (type < EET_T_STRING)), return 0);
+
+   ptr = data;
+   /* read the number of elements */
+   ret = eet_data_get_type(ed,
+			   EET_T_INT,
+			   echnk->data,
+			   ((char *)echnk->data) + echnk->size,
+			   &count);
+   if (ret <= 0) return ret;
+
+   if (echnk->size > (int) sizeof(int)
+       && EET_DATA_COLUMNS_IS(((char *)echnk->data) + sizeof (int), echnk->size - (int) sizeof (int)))
+     return eet_data_get_columns_array(context, ed, edd, ede, echnk, count, group_type, data);
+
+   if (echnk->size > (int) sizeof(int))
+     return eet_data_get_packed_array(context, edd, ede, echnk, count, group_type, data);
+
+   name = echnk->name;
+
+   if (ede)
+     {
+	if (IS_POINTER_TYPE(type))
+	  subsize = eet_basic_codec[ede->type].size;
+	else
+	  subsize = ede->subtype->size;
+
+	if (group_type == EET_G_VAR_ARRAY)
+	  {
+	     /* store the number of elements
+	      * on the counter offset */
+	     *(int *)(((char *)data) + ede->count - ede->offset) = count;
+	     /* allocate space for the array of elements */
+	     *(void **)ptr = _eet_data_mem_alloc(context, edd, count * subsize);
+
+	     if (!*(void **)ptr) return 0;
+
+	     memset(*(void **)ptr, 0, count * subsize);
+
+	     _eet_freelist_add(context, *(void **)ptr);
+	  }
+     }
+
+   /* get all array elements */
+   for (i = 0; i < count; i++)
+     {
+	void *dst = NULL;
+	void *data_ret = NULL;
+
+	/* Advance to next chunk */
+	NEXT_CHUNK((*p), (*size), (*echnk), ed);
+	memset(echnk, 0, sizeof(Eet_Data_Chunk));
+
+	eet_data_chunk_get(ed, echnk, *p, *size);
+	if (!echnk->name || strcmp(echnk->name, name) != 0) goto on_error;
+	/* get the data */
+
+	if (echnk->group_type != group_type
+	    || (echnk->type != type && echnk->type != EET_T_NULL))
+	  goto on_error;
+
+	if (ede)
+	  if (ede->group_type != echnk->group_type
+	      || (echnk->type != ede->type && echnk->type != EET_T_NULL))
+	    goto on_error;
+
+	/* get the destination pointer */
+	if (ede)
+	  {
+	     if (group_type == EET_G_ARRAY)
+	       dst = (char *)ptr + (subsize * i);
+	     else
+	       dst = *(char **)ptr + (subsize * i);
+	  }
+
+	if (IS_POINTER_TYPE(echnk->type))
+	  {
+	     POINTER_TYPE_DECODE(context, ed, edd, ede, echnk, echnk->type, &data_ret, p, size, on_error);
+	     if (dst) memcpy(dst, &data_ret, subsize);
+	     if (!edd) childs = eina_list_append(childs, data_ret);
+	  }
+	else
+	  {
+	     STRUCT_TYPE_DECODE(data_ret, context, ed, ede ? ede->subtype : NULL, echnk->data, echnk->size, on_error);
+	     /* data_ret is in the undo log already */
+	     if (dst) memcpy(dst, data_ret, subsize);
+	     if (!edd) childs = eina_list_append(childs, data_ret);
+	  }
+     }
+
+   if (!edd)
+     {
+	Eet_Node *parent = *((Eet_Node **) data);
+	Eet_Node *array;
+
+	if (group_type == EET_G_ARRAY)
+	  array = eet_node_array_new(name, count, childs);
+	else
+	  array = eet_node_var_array_new(name, childs);
+
+	if (!array) goto on_error;
+
+	eet_node_struct_append(parent, name, array);
+     }
+
+   return 1;
+
+ on_error:
+   EINA_LIST_FREE(childs, tmp)
+     eet_node_del(tmp);
+
+   return 0;
+}
+
+static void
+eet_data_put_union(Eet_Dictionary *ed,
+		   __UNUSED__ Eet_Data_Descriptor *edd,
+		   Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   const char *union_type;
+   int i;
+
+   EET_ASSERT(!((ede->type != EET_T_UNKNOW) || (!ede->subtype)), return );
+
+   union_type = ede->subtype->func.type_get(((char*) data_in) + ede->count - ede->offset,
+					    NULL);
+
+   if (!union_type) return ;
+
+   /* Search the structure of the union to encode. */
+   for (i = 0; i < ede->subtype->elements.num; ++i)
+     if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
+       {
+	  Eet_Data_Element *sede;
+
+	  /* Yeah we found it ! */
+	  eet_data_encode_type(ed, ds, EET_T_STRING, &union_type, ede->name, ede->type, ede->group_type);
+
+	  sede = &(ede->subtype->elements.set[i]);
+	  eet_data_encode_struct(ed, ds, sede->subtype, data_in,
+				 ede->name, ede->type, ede->group_type);
+	  break;
+       }
+}
+
+static int
+eet_data_get_union(Eet_Free_Context *context, const Eet_Dictionary *ed,
+		   __UNUSED__ Eet_Data_Descriptor *edd,
+		   Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		   int type, int group_type, void *data,
+		   char **p, int *size)
+{
+   const char *union_type;
+   void *data_ret = NULL;
+   int ret = 0;
+   int i;
+
+   /* Read type */
+   ret = eet_data_get_type(ed,
+			   EET_T_STRING,
+			   echnk->data,
+			   ((char *)echnk->data) + echnk->size,
+			   &union_type);
+   if (ret <= 0) goto on_error;
+
+   /* Advance to next chunk */
+   NEXT_CHUNK((*p), (*size), (*echnk), ed);
+   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+
+   /* Read value */
+   eet_data_chunk_get(ed, echnk, *p, *size);
+   if (!echnk->name) goto on_error;
+
+   if (ede)
+     {
+	EET_ASSERT(!(ede->group_type != group_type || ede->type != type), goto on_error);
+
+	/* Search the structure of the union to decode */
+	for (i = 0; i < ede->subtype->elements.num; ++i)
+	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
+	    {
+	       Eet_Data_Element *sede;
+	       char *ut;
+
+	       /* Yeah we found it ! */
+	       sede = &(ede->subtype->elements.set[i]);
+	       EET_ASSERT(sede->subtype, goto on_error);
+
+	       data_ret = _eet_data_descriptor_decode(context,
+						      ed,
+						      sede->subtype,
+						      echnk->data,
+						      echnk->size);
+	       if (!data_ret) goto on_error;
+
+	       /* Memcopy the structure content to remove pointer indirection. */
+	       memcpy(data, data_ret, sede->subtype->size);
+
+	       /* data_ret is now useless. */
+	       if (!context->arena)
+		 sede->subtype->func.mem_free(data_ret);
+
+	       /* Set union type. */
+	       ut = _eet_data_str_alloc(context, ed, ede->subtype, union_type, EINA_TRUE);
+
+	       ede->subtype->func.type_set(ut,
+					   ((char*) data) + ede->count - ede->offset,
+					   EINA_FALSE);
+
+	       break;
+	    }
+     }
+   else
+     {
+	/* FIXME: generate node structure. */
+	data_ret = _eet_data_descriptor_decode(context,
+					       ed, NULL,
+					       echnk->data, echnk->size);
+	goto on_error;
+     }
+
+   return 1;
+
+ on_error:
+   return 0;
+}
+
+static void
+eet_data_put_variant(Eet_Dictionary *ed,
+		     __UNUSED__ Eet_Data_Descriptor *edd,
+		     Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   const char *union_type;
+   Eina_Bool unknow = EINA_FALSE;
+   int i;
+
+   EET_ASSERT(!((ede->type != EET_T_UNKNOW) || (!ede->subtype)), return );
+
+   union_type = ede->subtype->func.type_get(((char*) data_in) + ede->count - ede->offset,
+					    &unknow);
+
+   if (!union_type && unknow == EINA_FALSE) return ;
+
+   if (unknow)
+     {
+	/* Handle opaque internal representation */
+	Eet_Variant_Unknow *evu;
+
+	eet_data_encode_type(ed, ds, EET_T_STRING, &union_type, ede->name, ede->type, ede->group_type);
+
+	evu = (Eet_Variant_Unknow*) data_in;
+	if (evu && EINA_MAGIC_CHECK(evu, EET_MAGIC_VARIANT))
+	  eet_data_encode(ed, ds, evu->data, ede->name, evu->size, ede->type, ede->group_type);
+     }
+   else
+     {
+	/* Search the structure of the union to encode. */
+	for (i = 0; i < ede->subtype->elements.num; ++i)
+	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
+	    {
+	       Eet_Data_Element *sede;
+
+	       /* Yeah we found it ! */
+	       eet_data_encode_type(ed, ds, EET_T_STRING, &union_type, ede->name, ede->type, ede->group_type);
+
+	       sede = &(ede->subtype->elements.set[i]);
+
+	       if (sede->group_type != EET_G_UNKNOWN)
+		 {
+		    int start;
+		    int payload;
+
+		    /* the group is written right in its chunk */
+		    start = eet_data_chunk_open(ed, ds, ede->name, ede->type, ede->group_type);
+		    if (start < 0) break;
+
+		    payload = ds->pos;
+		    eet_group_codec[sede->group_type - 100].put(ed,
+								sede->subtype,
+								sede,
+								ds,
+								data_in);
+		    if (ds->pos != payload)
+		      {
+			 eet_data_chunk_close(ds, start);
+		      }
+		    else
+		      {
+			 ds->pos = start;
+			 eet_data_encode(ed, ds, NULL, ede->name, 0,
+					 EET_T_NULL, ede->group_type);
+		      }
+		 }
+	       else
+		 {
+		    eet_data_encode_struct(ed, ds, sede->subtype, *(void**)data_in,
+					   ede->name, ede->type, ede->group_type);
+		 }
+
+	       break;
+	    }
+     }
+}
+
+static int
+eet_data_get_variant(Eet_Free_Context *context, const Eet_Dictionary *ed,
+		     __UNUSED__ Eet_Data_Descriptor *edd,
+		     Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		     int type, int group_type, void *data,
+		     char **p, int *size)
+{
+   const char *union_type;
+   void *data_ret = NULL;
+   int ret = 0;
+   int i;
+
+   /* Read type */
+   ret = eet_data_get_type(ed,
+			   EET_T_STRING,
+			   echnk->data,
+			   ((char *)echnk->data) + echnk->size,
+			   &union_type);
+   if (ret <= 0) goto on_error;
+
+   /* Advance to next chunk */
+   NEXT_CHUNK((*p), (*size), (*echnk), ed);
+   memset(echnk, 0, sizeof(Eet_Data_Chunk));
+
+   /* Read value */
+   eet_data_chunk_get(ed, echnk, *p, *size);
+   if (!echnk->name) goto on_error;
+
+   if (ede)
+     {
+	char *ut;
+
+	EET_ASSERT(ede->subtype, goto on_error);
+
+	ut = _eet_data_str_alloc(context, ed, ede->subtype, union_type, EINA_TRUE);
+
+	/* Search the structure of the union to decode */
+	for (i = 0; i < ede->subtype->elements.num; ++i)
+	  if (strcmp(ede->subtype->elements.set[i].name, union_type) == 0)
+	    {
+	       Eet_Data_Element *sede;
+
+	       /* Yeah we found it ! */
+	       sede = &(ede->subtype->elements.set[i]);
+
+	       if (sede->group_type != EET_G_UNKNOWN)
+		 {
+		    Eet_Data_Chunk chnk;
+		    char *p2;
+		    int size2;
+		    int ret;
+
+		    p2 = echnk->data;
+		    size2 = echnk->size;
+
+		    /* Didn't find a proper way to provide this
+		       without duplicating code */
+		    while (size2 > 0)
+		      {
+			 memset(&chnk, 0, sizeof(Eet_Data_Chunk));
+			 eet_data_chunk_get(ed, &chnk, p2, size2);
+
+			 if (!chnk.name) goto on_error;
+
+			 ret = eet_group_codec[sede->group_type - 100].get(context,
+									   ed, sede->subtype,
+									   sede, &chnk,
+									   sede->type, sede->group_type,
+									   data, &p2, &size2);
+
+			 if (ret <= 0) goto on_error;
+
+			 /* advance to next chunk */
+			 NEXT_CHUNK(p2, size2, chnk, ed);
+		      }
+
+		    /* Put garbage so that we will not put eet_variant_unknow in it */
+		    data_ret = (void*) data;
+
+		    /* Set variant type. */
+		    ede->subtype->func.type_set(ut,
+						((char*) data) + ede->count - ede->offset,
+						EINA_FALSE);
+		    break;
+		 }
+
+	       data_ret = _eet_data_descriptor_decode(context,
+						      ed,
+						      sede->subtype,
+						      echnk->data,
+						      echnk->size);
+	       if (!data_ret) break;
+
+	       /* And point to the variant data. */
+	       *(void**) data = data_ret;
+
+	       /* Set variant type. */
+	       ede->subtype->func.type_set(ut,
+					   ((char*) data) + ede->count - ede->offset,
+					   EINA_FALSE);
+	       break;
+	    }
+
+	if (!data_ret)
+	  {
+	     Eet_Variant_Unknow *evu;
+
+	     if (context->arena)
+	       evu = _eet_data_arena_alloc(context->arena, sizeof (Eet_Variant_Unknow) + echnk->size - 1, EET_DATA_ARENA_ALIGN);
+	     else
+	       evu = calloc(1, sizeof (Eet_Variant_Unknow) + echnk->size - 1);
+	     if (!evu) goto on_error;
+
+	     evu->size = echnk->size;
+	     memcpy(evu->data, echnk->data, evu->size);
+	     EINA_MAGIC_SET(evu, EET_MAGIC_VARIANT);
+
+	     /* And point to the opaque internal data scructure */
+	     *(void**) data = evu;
+
+	     /* Set variant type. */
+	     ede->subtype->func.type_set(ut,
+					 ((char*) data) + ede->count - ede->offset,
+					 EINA_TRUE);
+	  }
+     }
+   else
+     {
+	/* FIXME: dump node structure. */
+	data_ret = _eet_data_descriptor_decode(context,
+					       ed, NULL,
+					       echnk->data, echnk->size);
+	goto on_error;
+     }
+
+   return 1;
+
+ on_error:
+   return 0;
+}
+
+static Eet_Node *
+eet_data_node_simple_type(int type, const char *name, void *dd)
+{
+#ifdef EET_T_TYPE
+# undef EET_T_TYPE
+#endif
+
+#define EET_T_TYPE(Eet_Type, Eet_Node_Type, Type)			\
+   case Eet_Type:							\
+     return eet_node_##Eet_Node_Type##_new(name, *((Type *) dd));	\
+
+   switch (type)
+     {
+	EET_T_TYPE(EET_T_CHAR, char, char);
+	EET_T_TYPE(EET_T_SHORT, short, short);
+	EET_T_TYPE(EET_T_INT, int, int);
+	EET_T_TYPE(EET_T_LONG_LONG, long_long, long long);
+	EET_T_TYPE(EET_T_FLOAT, float, float);
+	EET_T_TYPE(EET_T_DOUBLE, double, double);
+	EET_T_TYPE(EET_T_UCHAR, unsigned_char, unsigned char);
+	EET_T_TYPE(EET_T_USHORT, unsigned_short, unsigned short);
+	EET_T_TYPE(EET_T_UINT, unsigned_int, unsigned int);
+	EET_T_TYPE(EET_T_ULONG_LONG, unsigned_long_long, unsigned long long);
+	EET_T_TYPE(EET_T_STRING, string, char*);
+	EET_T_TYPE(EET_T_INLINED_STRING, inlined_string, char*);
+      case EET_T_NULL:
+	 return eet_node_null_new(name);
+      default:
+	 ERR("Unknow type passed to eet_data_node_simple_type");
+	 return NULL;
+     }
+}
+
+static int
+eet_data_get_unknown(Eet_Free_Context *context, const Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Chunk *echnk,
+		     int type, int group_type __UNUSED__, void *data,
+		     char **p __UNUSED__, int *size __UNUSED__)
+{
+   int ret;
+   void *data_ret;
+
+   if (IS_SIMPLE_TYPE(type))
+     {
+	unsigned char dd[128];
+
+	ret = eet_data_chunk_value_get(ed, echnk, type, edd ? (char*) data : (char*) dd);
+	if (ret <= 0) return ret;
+
+	if (!edd)
+	  {
+ 	     Eet_Node **parent = data;
+	     Eet_Node *node;
+
+	     node = eet_data_node_simple_type(type, echnk->name, dd);
+
+	     if (*parent) eet_node_struct_append(*parent, echnk->name, node);
+	     else *parent = node;
+	  }
+	else
+	  {
+	     if (type == EET_T_STRING)
+	       {
+		  char **str;
+
+		  str = (char **)(((char *)data));
+		  if (*str)
+		    *str = _eet_data_str_alloc(context, ed, edd, *str, EINA_TRUE);
+	       }
+	     else if (edd && type == EET_T_INLINED_STRING)
+	       {
+		  char **str;
+
+		  str = (char **)(((char *)data));
+		  if (*str)
+		    *str = _eet_data_str_alloc(context, ed, edd, *str, EINA_FALSE);
+	       }
+	  }
+     }
+   else
+     {
+	Eet_Data_Descriptor *subtype;
+
+	subtype = ede ? ede->subtype : NULL;
+
+	if (subtype || !edd)
+	  {
+ 	     Eet_Node **parent = data;
+	     void **ptr;
+
+	     data_ret = _eet_data_descriptor_decode(context, ed, subtype, echnk->data, echnk->size);
+	     if (!data_ret) return 0;
+
+	     if (edd)
+	       {
+		  ptr = (void **)(((char *)data));
+		  *ptr = (void *)data_ret;
+	       }
+	     else
+	       {
+		  Eet_Node *node = data_ret;
+
+		  if (*parent)
+		    {
+		       node = eet_node_struct_child_new(echnk->name, node);
+		       eet_node_struct_append(*parent, echnk->name, node);
+		    }
+		  else *parent = node;
+	       }
+	  }
+     }
+
+   return 1;
+}
+
+static void
+eet_data_put_array(Eet_Dictionary *ed, Eet_Data_Descriptor *edd __UNUSED__, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   int offset = 0;
+   int subsize;
+   int count;
+   int type;
+   int j;
+
+   EET_ASSERT(!((ede->type > EET_T_UNKNOW) && (ede->type < EET_T_STRING)), return );
+
+   if (ede->group_type == EET_G_ARRAY)
+     count = ede->counter_offset;
+   else
+     count = *(int *)(((char *)data_in) + ede->count - ede->offset);
+
+   if (count <= 0) return;
+
+   type = eet_data_packed_type(ede);
+   if (type != EET_T_UNKNOW)
+     {
+	const void *src;
+
+	if (ede->group_type == EET_G_ARRAY)
+	  src = data_in;
+	else
+	  src = *((void **)data_in);
+
+	if (src) eet_data_put_packed_array(ed, ds, ede->name, type, ede->group_type, src, count);
+	return ;
+     }
+
+   if (!IS_POINTER_TYPE(ede->type) && ede->subtype->columnar)
+     {
+	void **rows;
+	char *src;
+
+	if (ede->group_type == EET_G_ARRAY)
+	  src = data_in;
+	else
+	  src = *((char **)data_in);
+	if (!src) return ;
+
+	/* without memory for the columns, fall back to a chunk per item */
+	rows = malloc(count * sizeof (void *));
+	if (rows)
+	  {
+	     Eina_Bool r;
+
+	     for (j = 0; j < count; j++)
+	       rows[j] = src + j * ede->subtype->size;
+
+	     r = eet_data_put_columns(ed, ds, ede, rows, count);
+	     free(rows);
+	     if (r) return ;
+	  }
+     }
+
+   /* Store number of elements */
+   eet_data_encode_type(ed, ds, EET_T_INT, &count, ede->name, ede->type, ede->group_type);
+
+   if (IS_POINTER_TYPE(ede->type))
+     subsize = eet_basic_codec[ede->type].size;
+   else
+     subsize = ede->subtype->size;
+
+   for (j = 0; j < count; j++)
+     {
+	void *d;
+	int pos = ds->pos;
+
+	if (ede->group_type == EET_G_ARRAY)
+	  d = (void *)(((char *)data_in) + offset);
+	else
+	  d = *(((char **)data_in)) + offset;
+
+	if (IS_POINTER_TYPE(ede->type))
+	  {
+	     if (*(char**) d)
+	       eet_data_put_unknown(ed, NULL, ede, ds, d);
+	  }
+	else
+	  {
+	     eet_data_encode_struct(ed, ds, ede->subtype, d,
+				    ede->name, ede->type, ede->group_type);
+	  }
+
+	if (pos == ds->pos)
+	  {
+	     /* Add a NULL element just to have the correct array layout. */
+	     eet_data_encode(ed, ds, NULL, ede->name, 0, EET_T_NULL, ede->group_type);
+	  }
+
+	offset += subsize;
+     }
+}
+
+static void
+eet_data_put_unknown(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   if (edd && edd->float_ieee
+       && (ede->type == EET_T_FLOAT || ede->type == EET_T_DOUBLE))
+     eet_data_encode_ieee(ed, ds, ede->type, data_in, ede->name);
+   else if (IS_SIMPLE_TYPE(ede->type))
+     eet_data_encode_type(ed, ds, ede->type, data_in, ede->name, ede->type, ede->group_type);
+   else if (ede->subtype)
+     {
+	if (*((char **)data_in))
+	  eet_data_encode_struct(ed, ds, ede->subtype,
+				 *((char **)((char *)(data_in))),
+				 ede->name, ede->type, ede->group_type);
+     }
+}
+
+static void
+eet_data_put_list(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   void *l;
+
+   EET_ASSERT(!(((ede->type > EET_T_UNKNOW) && (ede->type < EET_T_STRING))
+		|| ((ede->type > EET_T_NULL) && (ede->type < EET_T_LAST))),
+	      return );
+
+   l = *((void **)(((char *)data_in)));
+
+   if (!IS_POINTER_TYPE(ede->type) && ede->subtype->columnar)
+     {
+	void **rows = NULL;
+	void *it;
+	int count = 0;
+	int size = 0;
+
+	for (it = l; it; it = edd->func.list_next(it))
+	  {
+	     if (count == size)
+	       {
+		  void **tmp;
+
+		  size = size ? size * 2 : 64;
+		  tmp = realloc(rows, size * sizeof (void *));
+		  if (!tmp) break;
+		  rows = tmp;
+	       }
+	     rows[count++] = edd->func.list_data(it);
+	  }
+
+	/* without memory for the columns, fall back to a chunk per item */
+	if (!it && (!count || eet_data_put_columns(ed, ds, ede, rows, count)))
+	  {
+	     free(rows);
+	     return ;
+	  }
+	free(rows);
+     }
+
+   for (; l; l = edd->func.list_next(l))
+     {
+	if (IS_POINTER_TYPE(ede->type))
+	  {
+	     const void *str = edd->func.list_data(l);
+	     eet_data_put_unknown(ed, NULL, ede, ds, &str);
+	  }
+	else
+	  {
+	     eet_data_encode_struct(ed, ds, ede->subtype,
+				    edd->func.list_data(l),
+				    ede->name, ede->type, ede->group_type);
+	  }
+     }
+}
+
+static void
+eet_data_put_hash(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+{
+   Eet_Data_Encode_Hash_Info fdata;
+   void *l;
+
+   l = *((void **)(((char *)data_in)));
+   fdata.ds = ds;
+   fdata.ede = ede;
+   fdata.ed = ed;
+   edd->func.hash_foreach(l, eet_data_descriptor_encode_hash_cb, &fdata);
+}
+
+/*
+ * Text dumps are written as the data is walked, in the format of
+ * eet_node_dump(), through a buffer given to dumpfunc once full. Only
+ * what is open around the current chunk is remembered: list items come
+ * one after the other, so a list group stays open until a chunk with
+ * another name shows up.
+ */
+static void
+_eet_data_text_dump_init(Eet_Data_Text_Dump *dump,
+			 void (*dumpfunc) (void *data, const char *str),
+			 void *dumpdata)
+{
+   dump->dumpfunc = dumpfunc;
+   dump->dumpdata = dumpdata;
+   dump->levels = NULL;
+   dump->depth = 0;
+   dump->size = 0;
+   dump->list = NULL;
+   dump->list_type = EET_G_LIST;
+   dump->indent = 0;
+   dump->comma = EINA_FALSE;
+   dump->len = 0;
+}
+
+static void
+_eet_data_text_dump_flush(Eet_Data_Text_Dump *dump)
+{
+   if (!dump->len) return ;
+
+   dump->buf[dump->len] = '\0';
+   dump->dumpfunc(dump->dumpdata, dump->buf);
+   dump->len = 0;
+}
+
+static void
+_eet_data_text_dump_shutdown(Eet_Data_Text_Dump *dump)
+{
+   _eet_data_text_dump_flush(dump);
+   free(dump->levels);
+}
+
+static void
+_eet_data_text_dump_write(Eet_Data_Text_Dump *dump, const char *str, int len)
+{
+   while (len > 0)
+     {
+	int n;
+
+	n = sizeof (dump->buf) - 1 - dump->len;
+	if (n > len) n = len;
+	memcpy(dump->buf + dump->len, str, n);
+	dump->len += n;
+	str += n;
+	len -= n;
+
+	if (dump->len == sizeof (dump->buf) - 1)
+	  _eet_data_text_dump_flush(dump);
+     }
+}
+
+#define EET_DATA_TEXT_DUMP_STR(Dump, Str) \
+  _eet_data_text_dump_write(Dump, Str, strlen(Str))
+
+static void
+_eet_data_text_dump_escape(Eet_Data_Text_Dump *dump, const char *str)
+{
+   const char *run;
+
+   for (run = str; *str; str++)
+     {
+	if (*str != '"' && *str != '\\' && *str != '\n') continue ;
+
+	_eet_data_text_dump_write(dump, run, str - run);
+	_eet_data_text_dump_write(dump, *str == '\n' ? "\\n" : "\\", *str == '\n' ? 2 : 1);
+	run = *str == '\n' ? str + 1 : str;
+     }
+   _eet_data_text_dump_write(dump, run, str - run);
+}
+
+static void
+_eet_data_text_dump_indent(Eet_Data_Text_Dump *dump)
+{
+   int i;
+
+   for (i = 0; i < dump->indent; i++)
+     _eet_data_text_dump_write(dump, "    ", 4);
+}
+
+static void
+_eet_data_text_dump_group_start(Eet_Data_Text_Dump *dump, const char *name, int group_type)
+{
+   if (group_type < EET_G_UNKNOWN || group_type > EET_G_HASH)
+     group_type = EET_G_LAST;
+
+   _eet_data_text_dump_indent(dump);
+   EET_DATA_TEXT_DUMP_STR(dump, "group \"");
+   _eet_data_text_dump_escape(dump, name);
+   EET_DATA_TEXT_DUMP_STR(dump, "\" ");
+   EET_DATA_TEXT_DUMP_STR(dump, _eet_node_dump_g_name[group_type - EET_G_UNKNOWN]);
+   EET_DATA_TEXT_DUMP_STR(dump, " {\n");
+   dump->indent++;
+}
+
+static void
+_eet_data_text_dump_group_end(Eet_Data_Text_Dump *dump)
+{
+   dump->indent--;
+   _eet_data_text_dump_indent(dump);
+   EET_DATA_TEXT_DUMP_STR(dump, "}\n");
+}
+
+static void
+_eet_data_text_dump_key(Eet_Data_Text_Dump *dump, const char *key)
+{
+   _eet_data_text_dump_indent(dump);
+   EET_DATA_TEXT_DUMP_STR(dump, "key \"");
+   _eet_data_text_dump_escape(dump, key);
+   EET_DATA_TEXT_DUMP_STR(dump, "\";\n");
+}
+
+/* open the list name belongs to, or close the one that is open */
+static void
+_eet_data_text_dump_list(Eet_Data_Text_Dump *dump, const char *name, int group_type)
+{
+   if (group_type == EET_G_LIST
+       && dump->list && !strcmp(dump->list, name))
+     return ;
+
+   if (dump->list)
+     {
+	_eet_data_text_dump_group_end(dump);
+	dump->list = NULL;
+     }
+
+   if (group_type == EET_G_LIST)
+     {
+	_eet_data_text_dump_group_start(dump, name, EET_G_LIST);
+	dump->list = name;
+     }
+}
+
+static Eina_Bool
+_eet_data_text_dump_push(Eet_Data_Text_Dump *dump, int group_type)
+{
+   if (dump->depth == dump->size)
+     {
+	Eet_Data_Text_Dump_Level *levels;
+	int size;
+
+	size = dump->size ? dump->size * 2 : 16;
+	levels = realloc(dump->levels, size * sizeof (Eet_Data_Text_Dump_Level));
+	if (!levels) return EINA_FALSE;
+
+	dump->levels = levels;
+	dump->size = size;
+     }
+
+   dump->levels[dump->depth].group_type = group_type;
+   dump->levels[dump->depth].list = dump->list;
+   dump->levels[dump->depth].list_type = dump->list_type;
+   dump->depth++;
+   dump->list = NULL;
+
+   return EINA_TRUE;
+}
+
+static int
+_eet_data_text_dump_pop(Eet_Data_Text_Dump *dump)
+{
+   _eet_data_text_dump_list(dump, NULL, EET_G_UNKNOWN);
+
+   dump->depth--;
+   dump->list = dump->levels[dump->depth].list;
+
+   return dump->levels[dump->depth].group_type;
+}
+
+static Eina_Bool
+_eet_data_text_dump_struct_begin(const char *name, int group_type, const char *key, const char *type, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   /* as with Eet_Node, unions and variants can't be dumped */
+   if (group_type == EET_G_UNION || group_type == EET_G_VARIANT)
+     return EINA_FALSE;
+
+   if (dump->depth)
+     {
+	_eet_data_text_dump_list(dump, name, group_type);
+
+	switch (group_type)
+	  {
+	   case EET_G_UNKNOWN:
+	      _eet_data_text_dump_group_start(dump, name, EET_G_UNKNOWN);
+	      break;
+	   case EET_G_HASH:
+	      _eet_data_text_dump_group_start(dump, name, EET_G_HASH);
+	      _eet_data_text_dump_key(dump, key);
+	      break;
+	   default:
+	      break;
+	  }
+     }
+   else
+     group_type = EET_G_LAST;
+
+   _eet_data_text_dump_group_start(dump, type, EET_G_UNKNOWN);
+
+   return _eet_data_text_dump_push(dump, group_type);
+}
+
+static Eina_Bool
+_eet_data_text_dump_struct_end(const char *name __UNUSED__, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+   int group_type;
+
+   group_type = _eet_data_text_dump_pop(dump);
+
+   _eet_data_text_dump_group_end(dump);
+   /* the member or hash item around the structure */
+   if (group_type == EET_G_UNKNOWN || group_type == EET_G_HASH)
+     _eet_data_text_dump_group_end(dump);
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_text_dump_array_begin(Eina_Bool variable, const char *name, int count, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+   char tbuf[64];
+
+   _eet_data_text_dump_list(dump, NULL, EET_G_UNKNOWN);
+   _eet_data_text_dump_group_start(dump, name, variable ? EET_G_VAR_ARRAY : EET_G_ARRAY);
+
+   _eet_data_text_dump_indent(dump);
+   EET_DATA_TEXT_DUMP_STR(dump, "count ");
+   eina_convert_itoa(count, tbuf);
+   EET_DATA_TEXT_DUMP_STR(dump, tbuf);
+   EET_DATA_TEXT_DUMP_STR(dump, ";\n");
+
+   return _eet_data_text_dump_push(dump, EET_G_ARRAY);
+}
+
+static Eina_Bool
+_eet_data_text_dump_array_end(const char *name __UNUSED__, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   _eet_data_text_dump_pop(dump);
+   _eet_data_text_dump_group_end(dump);
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_text_dump_simple(const char *name, int group_type, const char *key, int type, Eet_Node_Data *data, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+   char tbuf[256];
+
+   _eet_data_text_dump_list(dump, name, group_type);
+   if (group_type == EET_G_HASH)
+     {
+	_eet_data_text_dump_group_start(dump, name, EET_G_HASH);
+	_eet_data_text_dump_key(dump, key);
+     }
+
+   /* eet_node_dump() skips them too */
+   if (type != EET_T_NULL)
+     {
+	_eet_data_text_dump_indent(dump);
+	EET_DATA_TEXT_DUMP_STR(dump, "value \"");
+	_eet_data_text_dump_escape(dump, name);
+	EET_DATA_TEXT_DUMP_STR(dump, "\" ");
+
+#ifdef EET_T_TYPE
+# undef EET_T_TYPE
+#endif
+
+#define EET_T_TYPE(Eet_Type, Type)					\
+	case Eet_Type:							\
+	  EET_DATA_TEXT_DUMP_STR(dump, _eet_node_dump_t_name[Eet_Type][0]); \
+	  snprintf(tbuf, sizeof (tbuf), _eet_node_dump_t_name[Eet_Type][1], data->value.Type); \
+	  EET_DATA_TEXT_DUMP_STR(dump, tbuf);				\
+	  break;
+
+	switch (type)
+	  {
+	     EET_T_TYPE(EET_T_CHAR, c);
+	     EET_T_TYPE(EET_T_SHORT, s);
+	     EET_T_TYPE(EET_T_INT, i);
+	     EET_T_TYPE(EET_T_LONG_LONG, l);
+	     EET_T_TYPE(EET_T_FLOAT, f);
+	     EET_T_TYPE(EET_T_DOUBLE, d);
+	     EET_T_TYPE(EET_T_UCHAR, uc);
+	     EET_T_TYPE(EET_T_USHORT, us);
+	     EET_T_TYPE(EET_T_UINT, ui);
+	     EET_T_TYPE(EET_T_ULONG_LONG, ul);
+	   case EET_T_STRING:
+	   case EET_T_INLINED_STRING:
+	      EET_DATA_TEXT_DUMP_STR(dump, type == EET_T_STRING ? "string: \"" : "inlined: \"");
+	      _eet_data_text_dump_escape(dump, data->value.str);
+	      EET_DATA_TEXT_DUMP_STR(dump, "\"");
+	      break;
+	   default:
+	      EET_DATA_TEXT_DUMP_STR(dump, "???: ???");
+	      break;
+	  }
+
+	EET_DATA_TEXT_DUMP_STR(dump, ";\n");
+     }
+
+   if (group_type == EET_G_HASH)
+     _eet_data_text_dump_group_end(dump);
+
+   return EINA_TRUE;
+}
+
+static Eet_Data_Walk _eet_data_text_dump_walk = {
+  _eet_data_text_dump_struct_begin,
+  _eet_data_text_dump_struct_end,
+  _eet_data_text_dump_array_begin,
+  _eet_data_text_dump_array_end,
+  _eet_data_text_dump_simple
+};
+
+/*
+ * Json dump, written from the same walk as the text dump. Every value is
+ * an object with one member naming its type, so the text undumps to the
+ * same chunks:
+ *
+ *   {"int": 42}, {"string": "..."}, ... as the text dump names them
+ *   {"struct": {"Descriptor_Name": { "member": value, ... }}}
+ *   {"list": [ value, ... ]}, {"array": [ ... ]}, {"var_array": [ ... ]}
+ *   {"hash": { "key": value, ... }}
+ *
+ * Floats and doubles that aren't finite are written as strings. Nulls
+ * keep their place in arrays, anywhere else they are left out as in the
+ * text dump.
+ */
+static void
+_eet_data_json_dump_escape(Eet_Data_Text_Dump *dump, const char *str)
+{
+   const unsigned char *s;
+   const char *run;
+
+   _eet_data_text_dump_write(dump, "\"", 1);
+   for (run = str, s = (const unsigned char *) str; *s; s++)
+     {
+	char tbuf[8];
+
+	if (*s >= 0x20 && *s != '"' && *s != '\\') continue ;
+
+	_eet_data_text_dump_write(dump, run, (const char *) s - run);
+	switch (*s)
+	  {
+	   case '"': EET_DATA_TEXT_DUMP_STR(dump, "\\\""); break;
+	   case '\\': EET_DATA_TEXT_DUMP_STR(dump, "\\\\"); break;
+	   case '\n': EET_DATA_TEXT_DUMP_STR(dump, "\\n"); break;
+	   case '\t': EET_DATA_TEXT_DUMP_STR(dump, "\\t"); break;
+	   case '\r': EET_DATA_TEXT_DUMP_STR(dump, "\\r"); break;
+	   default:
+	      snprintf(tbuf, sizeof (tbuf), "\\u%04x", *s);
+	      EET_DATA_TEXT_DUMP_STR(dump, tbuf);
+	      break;
+	  }
+	run = (const char *) s + 1;
+     }
+   _eet_data_text_dump_write(dump, run, (const char *) s - run);
+   _eet_data_text_dump_write(dump, "\"", 1);
+}
+
+/* start an item of the object or the array open, named if name is given */
+static void
+_eet_data_json_dump_item(Eet_Data_Text_Dump *dump, const char *name)
+{
+   if (dump->comma) _eet_data_text_dump_write(dump, ",", 1);
+   _eet_data_text_dump_write(dump, "\n", 1);
+   _eet_data_text_dump_indent(dump);
+   dump->comma = EINA_TRUE;
+
+   if (!name) return ;
+   _eet_data_json_dump_escape(dump, name);
+   _eet_data_text_dump_write(dump, ": ", 2);
+}
+
+static void
+_eet_data_json_dump_open(Eet_Data_Text_Dump *dump, const char *type, const char *brace)
+{
+   EET_DATA_TEXT_DUMP_STR(dump, "{\"");
+   EET_DATA_TEXT_DUMP_STR(dump, type);
+   EET_DATA_TEXT_DUMP_STR(dump, "\": ");
+   EET_DATA_TEXT_DUMP_STR(dump, brace);
+   dump->indent++;
+   dump->comma = EINA_FALSE;
+}
+
+static void
+_eet_data_json_dump_close(Eet_Data_Text_Dump *dump, const char *braces)
+{
+   dump->indent--;
+   /* nothing written since it was opened, keep it on one line */
+   if (dump->comma)
+     {
+	_eet_data_text_dump_write(dump, "\n", 1);
+	_eet_data_text_dump_indent(dump);
+     }
+   EET_DATA_TEXT_DUMP_STR(dump, braces);
+   dump->comma = EINA_TRUE;
+}
+
+/* open the list or the hash name belongs to, or close the one that is open */
+static void
+_eet_data_json_dump_list(Eet_Data_Text_Dump *dump, const char *name, int group_type)
+{
+   if (group_type != EET_G_LIST && group_type != EET_G_HASH)
+     group_type = EET_G_UNKNOWN;
+
+   if (group_type != EET_G_UNKNOWN
+       && dump->list && dump->list_type == group_type
+       && !strcmp(dump->list, name))
+     return ;
+
+   if (dump->list)
+     {
+	_eet_data_json_dump_close(dump, dump->list_type == EET_G_LIST ? "]}" : "}}");
+	dump->list = NULL;
+     }
+
+   if (group_type != EET_G_UNKNOWN)
+     {
+	_eet_data_json_dump_item(dump, name);
+	if (group_type == EET_G_LIST)
+	  _eet_data_json_dump_open(dump, "list", "[");
+	else
+	  _eet_data_json_dump_open(dump, "hash", "{");
+	dump->list = name;
+	dump->list_type = group_type;
+     }
+}
+
+static int
+_eet_data_json_dump_pop(Eet_Data_Text_Dump *dump)
+{
+   _eet_data_json_dump_list(dump, NULL, EET_G_UNKNOWN);
+
+   dump->depth--;
+   dump->list = dump->levels[dump->depth].list;
+   dump->list_type = dump->levels[dump->depth].list_type;
+
+   return dump->levels[dump->depth].group_type;
+}
+
+/* the name of an item of group_type in the object or the array open */
+static const char *
+_eet_data_json_dump_item_name(const char *name, int group_type, const char *key)
+{
+   switch (group_type)
+     {
+      case EET_G_UNKNOWN: return name;
+      case EET_G_HASH: return key;
+      default: return NULL;
+     }
+}
+
+static Eina_Bool
+_eet_data_json_dump_struct_begin(const char *name, int group_type, const char *key, const char *type, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   if (group_type == EET_G_UNION || group_type == EET_G_VARIANT)
+     return EINA_FALSE;
+
+   if (dump->depth)
+     {
+	_eet_data_json_dump_list(dump, name, group_type);
+	_eet_data_json_dump_item(dump, _eet_data_json_dump_item_name(name, group_type, key));
+     }
+
+   _eet_data_json_dump_open(dump, "struct", "{");
+   _eet_data_json_dump_escape(dump, type);
+   EET_DATA_TEXT_DUMP_STR(dump, ": {");
+
+   return _eet_data_text_dump_push(dump, group_type);
+}
+
+static Eina_Bool
+_eet_data_json_dump_struct_end(const char *name __UNUSED__, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   _eet_data_json_dump_pop(dump);
+   _eet_data_json_dump_close(dump, "}}}");
+   if (!dump->depth) _eet_data_text_dump_write(dump, "\n", 1);
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_json_dump_array_begin(Eina_Bool variable, const char *name, int count __UNUSED__, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   _eet_data_json_dump_list(dump, NULL, EET_G_UNKNOWN);
+   _eet_data_json_dump_item(dump, name);
+   _eet_data_json_dump_open(dump, variable ? "var_array" : "array", "[");
+
+   return _eet_data_text_dump_push(dump, EET_G_ARRAY);
+}
+
+static Eina_Bool
+_eet_data_json_dump_array_end(const char *name __UNUSED__, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+
+   _eet_data_json_dump_pop(dump);
+   _eet_data_json_dump_close(dump, "]}");
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_json_dump_simple(const char *name, int group_type, const char *key, int type, Eet_Node_Data *data, void *user_data)
+{
+   Eet_Data_Text_Dump *dump = user_data;
+   const char *format = NULL;
+   char tbuf[64];
+   double d = 0;
+
+   _eet_data_json_dump_list(dump, name, group_type);
+   if (type == EET_T_NULL
+       && group_type != EET_G_ARRAY && group_type != EET_G_VAR_ARRAY)
+     return EINA_TRUE;
+
+   _eet_data_json_dump_item(dump, _eet_data_json_dump_item_name(name, group_type, key));
+   EET_DATA_TEXT_DUMP_STR(dump, "{\"");
+   EET_DATA_TEXT_DUMP_STR(dump, type == EET_T_NULL ? "null" : eet_basic_codec[type - 1].name);
+   EET_DATA_TEXT_DUMP_STR(dump, "\": ");
+
+#ifdef EET_T_TYPE
+# undef EET_T_TYPE
+#endif
+
+#define EET_T_TYPE(Eet_Type, Type, Format)				\
+   case Eet_Type:							\
+     snprintf(tbuf, sizeof (tbuf), Format, data->value.Type);		\
+     break;
+
+   switch (type)
+     {
+	EET_T_TYPE(EET_T_CHAR, c, "%hhi");
+	EET_T_TYPE(EET_T_SHORT, s, "%hi");
+	EET_T_TYPE(EET_T_INT, i, "%i");
+	EET_T_TYPE(EET_T_LONG_LONG, l, "%lli");
+	EET_T_TYPE(EET_T_UCHAR, uc, "%hhu");
+	EET_T_TYPE(EET_T_USHORT, us, "%hu");
+	EET_T_TYPE(EET_T_UINT, ui, "%u");
+	EET_T_TYPE(EET_T_ULONG_LONG, ul, "%llu");
+      /* enough digits to read the same value back, written below */
+      case EET_T_FLOAT:
+	 d = data->value.f;
+	 format = "%.9g";
+	 break;
+      case EET_T_DOUBLE:
+	 d = data->value.d;
+	 format = "%.17g";
+	 break;
+      case EET_T_STRING:
+      case EET_T_INLINED_STRING:
+	 _eet_data_json_dump_escape(dump, data->value.str);
+	 tbuf[0] = '\0';
+	 break;
+      default:
+	 strcpy(tbuf, "null");
+	 break;
+     }
+
+   if (format)
+     {
+	if (isnan(d)) strcpy(tbuf, "\"nan\"");
+	else if (isinf(d)) strcpy(tbuf, d < 0 ? "\"-inf\"" : "\"inf\"");
+	else snprintf(tbuf, sizeof (tbuf), format, d);
+     }
+
+   EET_DATA_TEXT_DUMP_STR(dump, tbuf);
+   _eet_data_text_dump_write(dump, "}", 1);
+
+   return EINA_TRUE;
+}
+
+static Eet_Data_Walk _eet_data_json_dump_walk = {
+  _eet_data_json_dump_struct_begin,
+  _eet_data_json_dump_struct_end,
+  _eet_data_json_dump_array_begin,
+  _eet_data_json_dump_array_end,
+  _eet_data_json_dump_simple
+};
+
+EAPI int
+eet_data_dump_cipher(Eet_File *ef,
+		     const char *name, const char *cipher_key,
+		     void (*dumpfunc) (void *data, const char *str),
+		     void *dumpdata)
+{
+   Eet_Data_Text_Dump dump;
+   Eina_Bool result;
+
+   _eet_data_text_dump_init(&dump, dumpfunc, dumpdata);
+   result = eet_data_walk_read_cipher(ef, name, cipher_key, &_eet_data_text_dump_walk, &dump);
+   _eet_data_text_dump_shutdown(&dump);
+
+   return result ? 1 : 0;
+}
+
+EAPI int
+eet_data_dump(Eet_File *ef,
+	      const char *name,
+	      void (*dumpfunc) (void *data, const char *str),
+	      void *dumpdata)
+{
+   return eet_data_dump_cipher(ef, name, NULL, dumpfunc, dumpdata);
+}
+
+
+EAPI int
+eet_data_text_dump_cipher(const void *data_in,
+			  const char *cipher_key, int size_in,
+			  void (*dumpfunc) (void *data, const char *str),
+			  void *dumpdata)
+{
+   Eet_Data_Text_Dump dump;
+   Eina_Bool result;
+
+   if (!data_in) return 0;
+
+   _eet_data_text_dump_init(&dump, dumpfunc, dumpdata);
+   result = eet_data_walk_decode_cipher(data_in, cipher_key, size_in, &_eet_data_text_dump_walk, &dump);
+   _eet_data_text_dump_shutdown(&dump);
+
+   return result ? 1 : 0;
+}
+
+EAPI int
+eet_data_text_dump(const void *data_in,
+		   int size_in,
+		   void (*dumpfunc) (void *data, const char *str),
+		   void *dumpdata)
+{
+   return eet_data_text_dump_cipher(data_in, NULL, size_in, dumpfunc, dumpdata);
+}
+
+EAPI void *
+eet_data_text_undump_cipher(const char *text,
+			    const char *cipher_key,
+			    int textlen,
+			    int *size_ret)
+{
+   void *ret = NULL;
+
+   ret = _eet_data_dump_parse(NULL, size_ret, text, textlen);
+   if (ret && cipher_key)
+     {
+	void *ciphered = NULL;
+	unsigned int ciphered_len;
+
+	if (eet_cipher(ret, *size_ret, cipher_key,
+		       strlen(cipher_key), &ciphered, &ciphered_len))
+	  {
+	     if (ciphered) free(ciphered);
+	     size_ret = 0;
+	     free(ret);
+	     return NULL;
+	  }
+	free(ret);
+	*size_ret = ciphered_len;
+	ret = ciphered;
+     }
+   return ret;
+}
+
+EAPI void *
+eet_data_text_undump(const char *text,
+		     int textlen,
+		     int *size_ret)
+{
+   return eet_data_text_undump_cipher(text, NULL, textlen, size_ret);
+}
+
+EAPI int
+eet_data_undump_cipher(Eet_File *ef,
+		       const char *name,
+		       const char *cipher_key,
+		       const char *text,
+		       int textlen,
+		       int compress)
+{
+   Eet_Dictionary       *ed;
+   void                 *data_enc;
+   int                   size;
+   int                   val;
+
+   ed = eet_dictionary_get(ef);
+
+   data_enc = _eet_data_dump_parse(ed, &size, text, textlen);
+   if (!data_enc) return 0;
+   val = eet_write_cipher(ef, name, data_enc, size, compress, cipher_key);
+   free(data_enc);
+   return val;
+}
+
+EAPI int
+eet_data_undump(Eet_File *ef,
+		const char *name,
+		const char *text,
+		int textlen,
+		int compress)
+{
+   return eet_data_undump_cipher(ef, name, NULL, text, textlen, compress);
+}
+
+EAPI int
+eet_data_json_dump_cipher(const void *data_in,
+			  const char *cipher_key, int size_in,
+			  void (*dumpfunc) (void *data, const char *str),
+			  void *dumpdata)
+{
+   Eet_Data_Text_Dump dump;
+   Eina_Bool result;
+
+   if (!data_in) return 0;
+
+   _eet_data_text_dump_init(&dump, dumpfunc, dumpdata);
+   result = eet_data_walk_decode_cipher(data_in, cipher_key, size_in, &_eet_data_json_dump_walk, &dump);
+   _eet_data_text_dump_shutdown(&dump);
+
+   return result ? 1 : 0;
+}
+
+EAPI int
+eet_data_json_dump(const void *data_in,
+		   int size_in,
+		   void (*dumpfunc) (void *data, const char *str),
+		   void *dumpdata)
+{
+   return eet_data_json_dump_cipher(data_in, NULL, size_in, dumpfunc, dumpdata);
+}
+
+EAPI void *
+eet_data_json_undump_cipher(const char *text,
+			    const char *cipher_key,
+			    int textlen,
+			    int *size_ret)
+{
+   void *ret = NULL;
+
+   ret = _eet_data_json_parse(NULL, size_ret, text, textlen);
+   if (ret && cipher_key)
+     {
+	void *ciphered = NULL;
+	unsigned int ciphered_len;
+
+	if (eet_cipher(ret, *size_ret, cipher_key,
+		       strlen(cipher_key), &ciphered, &ciphered_len))
+	  {
+	     if (ciphered) free(ciphered);
+	     *size_ret = 0;
+	     free(ret);
+	     return NULL;
+	  }
+	free(ret);
+	*size_ret = ciphered_len;
+	ret = ciphered;
+     }
+   return ret;
+}
+
+EAPI void *
+eet_data_json_undump(const char *text,
+		     int textlen,
+		     int *size_ret)
+{
+   return eet_data_json_undump_cipher(text, NULL, textlen, size_ret);
+}
+
+EAPI void *
+eet_data_descriptor_decode_cipher(Eet_Data_Descriptor *edd,
+				  const void *data_in,
+				  const char *cipher_key,
+				  int size_in)
+{
+   void *deciphered = (void*) data_in;
+   void *ret;
+   Eet_Free_Context context;
+   unsigned int deciphered_len = size_in;
+
+   if (cipher_key && data_in)
+     {
+       if (eet_decipher(data_in, size_in, cipher_key,
+			strlen(cipher_key), &deciphered, &deciphered_len))
+	 {
+	   if (deciphered) free(deciphered);
+	   return NULL;
+	 }
+     }
+
+   memset(&context, 0, sizeof (context));
+   ret = _eet_data_descriptor_decode(&context, NULL, edd, deciphered, deciphered_len);
+
+   if (data_in != deciphered) free(deciphered);
+
+   return ret;
+}
 
-   if (ede->group_type == EET_G_ARRAY)
-     count = ede->counter_offset;
-   else
-     count = *(int *)(((char *)data_in) + ede->count - ede->offset);
+EAPI void *
+eet_data_descriptor_decode(Eet_Data_Descriptor *edd,
+			   const void *data_in,
+			   int size_in)
+{
+   return eet_data_descriptor_decode_cipher(edd, data_in, NULL, size_in);
+}
 
-   if (count <= 0) return;
-   /* Store number of elements */
-   data = eet_data_put_type(ed, EET_T_INT, &count, &size);
-   if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
+EAPI void *
+eet_data_descriptor_decode_arena(Eet_Data_Descriptor *edd,
+				 const void *data_in,
+				 int size_in,
+				 Eet_Data_Arena *arena)
+{
+   Eet_Free_Context context;
 
-   if (IS_POINTER_TYPE(ede->type))
-     subsize = eet_basic_codec[ede->type].size;
-   else
-     subsize = ede->subtype->size;
+   if (!edd || !data_in || !arena) return NULL;
 
-   for (j = 0; j < count; j++)
-     {
-	void *d;
-	int pos = ds->pos;
+   memset(&context, 0, sizeof (context));
+   context.arena = arena;
+   return _eet_data_descriptor_decode(&context, NULL, edd, data_in, size_in);
+}
 
-	if (ede->group_type == EET_G_ARRAY)
-	  d = (void *)(((char *)data_in) + offset);
-	else
-	  d = *(((char **)data_in)) + offset;
+/*
+ * Lazy decoding leaves lists, hashes, variable arrays and sub structures of
+ * the outer structure out, recording the bytes of their chunks instead.
+ * They are decoded later, alone, by eet_data_lazy_member_decode().
+ */
+static Eina_Bool
+_eet_data_lazy_defer(Eet_Data_Lazy *lazy, Eet_Data_Element *ede,
+		     const char *start, const char *end)
+{
+   Eet_Data_Lazy_Member *elm;
+   Eina_List *l;
 
-	if (IS_POINTER_TYPE(ede->type))
-	  {
-	     if (*(char**) d)
-	       eet_data_put_unknown(ed, NULL, ede, ds, d);
-	  }
-	else
-	  {
-	     data = _eet_data_descriptor_encode(ed, ede->subtype, d, &size);
-	     if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
-	  }
+   /* the chunks of a member usually follow each other */
+   EINA_LIST_FOREACH(lazy->members, l, elm)
+     if (elm->ede == ede)
+       {
+	  elm->end = end;
+	  return EINA_TRUE;
+       }
 
-	if (pos == ds->pos)
-	  {
-	     /* Add a NULL element just to have the correct array layout. */
-	     eet_data_encode(ed, ds, NULL, ede->name, 0, EET_T_NULL, ede->group_type);
-	  }
+   elm = malloc(sizeof (Eet_Data_Lazy_Member));
+   if (!elm) return EINA_FALSE;
+   elm->ede = ede;
+   elm->start = start;
+   elm->end = end;
 
-	offset += subsize;
-     }
+   lazy->members = eina_list_prepend(lazy->members, elm);
+   return EINA_TRUE;
 }
 
-static void
-eet_data_put_unknown(Eet_Dictionary *ed, Eet_Data_Descriptor *edd __UNUSED__, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+static Eet_Data_Lazy *
+_eet_data_lazy_new(const Eet_Dictionary *ed, Eet_Data_Descriptor *edd,
+		   const void *data_in, int size_in)
 {
-   void *data = NULL;
-   int size;
+   Eet_Free_Context context;
+   Eet_Data_Lazy_Member *elm;
+   Eet_Data_Lazy *lazy;
 
-   if (IS_SIMPLE_TYPE(ede->type))
-     data = eet_data_put_type(ed, ede->type, data_in, &size);
-   else if (ede->subtype)
+   lazy = calloc(1, sizeof (Eet_Data_Lazy));
+   if (!lazy) return NULL;
+   lazy->edd = edd;
+   lazy->ed = ed;
+
+   memset(&context, 0, sizeof (context));
+   context.lazy = lazy;
+   lazy->data = _eet_data_descriptor_decode(&context, ed, edd, data_in, size_in);
+   if (!lazy->data)
      {
-	if (*((char **)data_in))
-	  data = _eet_data_descriptor_encode(ed,
-					     ede->subtype,
-					     *((char **)((char *)(data_in))),
-					     &size);
+	EINA_LIST_FREE(lazy->members, elm)
+	  free(elm);
+	free(lazy);
+	return NULL;
      }
-   if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
+
+   return lazy;
 }
 
-static void
-eet_data_put_list(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+EAPI Eet_Data_Lazy *
+eet_data_read_lazy(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name)
 {
-   void *data;
-   void *l;
+   Eet_Data_Lazy *lazy;
+   const void *data;
+   void *buffer = NULL;
    int size;
 
-   EET_ASSERT(!(((ede->type > EET_T_UNKNOW) && (ede->type < EET_T_STRING))
-		|| ((ede->type > EET_T_NULL) && (ede->type < EET_T_LAST))),
-	      return );
+   if (!edd) return NULL;
 
-   l = *((void **)(((char *)data_in)));
-   for (; l; l = edd->func.list_next(l))
+   data = eet_read_direct(ef, name, &size);
+   if (!data)
      {
-	if (IS_POINTER_TYPE(ede->type))
-	  {
-	     const void *str = edd->func.list_data(l);
-	     eet_data_put_unknown(ed, NULL, ede, ds, &str);
-	  }
-	else
-	  {
-	     data = _eet_data_descriptor_encode(ed,
-						ede->subtype,
-						edd->func.list_data(l),
-						&size);
-	     if (data) eet_data_encode(ed, ds, data, ede->name, size, ede->type, ede->group_type);
-	  }
+	buffer = eet_read(ef, name, &size);
+	if (!buffer) return NULL;
+	data = buffer;
+     }
+
+   lazy = _eet_data_lazy_new(eet_dictionary_get(ef), edd, data, size);
+   if (!lazy)
+     {
+	free(buffer);
+	return NULL;
      }
+
+   /* the dictionary, and maybe the data, belong to ef */
+   eet_file_borrow(ef, NULL);
+   lazy->ef = ef;
+   lazy->buffer = buffer;
+   return lazy;
 }
 
-static void
-eet_data_put_hash(Eet_Dictionary *ed, Eet_Data_Descriptor *edd, Eet_Data_Element *ede, Eet_Data_Stream *ds, void *data_in)
+EAPI Eet_Data_Lazy *
+eet_data_descriptor_decode_lazy(Eet_Data_Descriptor *edd,
+				const void *data_in,
+				int size_in)
 {
-   Eet_Data_Encode_Hash_Info fdata;
-   void *l;
+   if (!edd || !data_in) return NULL;
+   return _eet_data_lazy_new(NULL, edd, data_in, size_in);
+}
 
-   l = *((void **)(((char *)data_in)));
-   fdata.ds = ds;
-   fdata.ede = ede;
-   fdata.ed = ed;
-   edd->func.hash_foreach(l, eet_data_descriptor_encode_hash_cb, &fdata);
+EAPI void *
+eet_data_lazy_data_get(const Eet_Data_Lazy *lazy)
+{
+   if (!lazy) return NULL;
+   return lazy->data;
 }
 
-EAPI int
-eet_data_dump_cipher(Eet_File *ef,
-		     const char *name, const char *cipher_key,
-		     void (*dumpfunc) (void *data, const char *str),
-		     void *dumpdata)
+EAPI Eina_Bool
+eet_data_lazy_member_decode(Eet_Data_Lazy *lazy, const char *member)
 {
-   const Eet_Dictionary *ed = NULL;
-   const void		*data = NULL;
-   Eet_Node             *result;
-   Eet_Free_Context      context;
-   int			 required_free = 0;
-   int			 size;
+   Eet_Free_Context free_context;
+   Eet_Free_Context *context = &free_context;
+   Eet_Data_Lazy_Member *elm = NULL;
+   Eet_Data_Element *ede;
+   Eina_List *l;
+   void *dst;
+   char *p;
+   int size;
 
-   ed = eet_dictionary_get(ef);
+   if (!lazy || !member) return EINA_FALSE;
 
-   if (!cipher_key)
-     data = eet_read_direct(ef, name, &size);
-   if (!data)
+   EINA_LIST_FOREACH(lazy->members, l, elm)
+     if (!strcmp(elm->ede->name, member))
+       break ;
+   /* decoded already, or never left out */
+   if (!l) return EINA_TRUE;
+
+   lazy->members = eina_list_remove_list(lazy->members, l);
+   ede = elm->ede;
+   dst = ((char *)lazy->data) + ede->offset;
+
+   memset(context, 0, sizeof (Eet_Free_Context));
+   _eet_freelist_all_ref(context);
+
+   p = (char *)elm->start;
+   size = elm->end - elm->start;
+   while (size > 0)
      {
-	required_free = 1;
-	data = eet_read_cipher(ef, name, &size, cipher_key);
-	if (!data) return 0;
+	Eet_Data_Chunk echnk;
+
+	memset(&echnk, 0, sizeof (Eet_Data_Chunk));
+	eet_data_chunk_get(lazy->ed, &echnk, p, size);
+	if (!echnk.name) goto on_error;
+
+	/* other members may sit in between */
+	if (!strcmp(echnk.name, ede->name)
+	    && eet_group_codec[ede->group_type - 100].get(context, lazy->ed, lazy->edd, ede, &echnk,
+							  ede->type, ede->group_type, dst,
+							  &p, &size) <= 0)
+	  goto on_error;
+
+	NEXT_CHUNK(p, size, echnk, lazy->ed);
      }
 
-   memset(&context, 0, sizeof (context));
-   result = _eet_data_descriptor_decode(&context, ed, NULL, data, size);
+   _eet_freelist_all_unref(context);
+   _eet_freelist_reset(context);
+   _eet_freelist_str_reset(context);
+   _eet_freelist_list_reset(context);
+   _eet_freelist_hash_reset(context);
+   _eet_freelist_direct_str_reset(context);
 
-   eet_node_dump(result, 0, dumpfunc, dumpdata);
+   free(elm);
+   return EINA_TRUE;
 
-   eet_node_del(result);
+ on_error:
+   _eet_freelist_all_unref(context);
+   _eet_freelist_str_free(context, lazy->edd);
+   _eet_freelist_direct_str_free(context, lazy->edd);
+   _eet_freelist_list_free(context, lazy->edd);
+   _eet_freelist_hash_free(context, lazy->edd);
+   _eet_freelist_free(context, lazy->edd);
+
+   /* the member stays empty */
+   *(void **)dst = NULL;
+   if (ede->group_type == EET_G_VAR_ARRAY)
+     *(int *)(((char *)lazy->data) + ede->count) = 0;
+
+   free(elm);
+   return EINA_FALSE;
+}
 
-   if (required_free)
-     free((void*)data);
+EAPI void
+eet_data_lazy_free(Eet_Data_Lazy *lazy)
+{
+   Eet_Data_Lazy_Member *elm;
 
-   return result ? 1 : 0;
+   if (!lazy) return ;
+
+   EINA_LIST_FREE(lazy->members, elm)
+     free(elm);
+   if (lazy->buffer) free(lazy->buffer);
+   if (lazy->ef) eet_close(lazy->ef);
+   free(lazy);
 }
 
-EAPI int
-eet_data_dump(Eet_File *ef,
-	      const char *name,
-	      void (*dumpfunc) (void *data, const char *str),
-	      void *dumpdata)
+/*
+ * Record block, many structs of one descriptor in one entry:
+ *
+ *   "BLK" + version byte
+ *   int     number of records
+ *   int     end of each record, from the start of the first one
+ *   then the records, each as eet_data_descriptor_encode() writes it
+ *
+ * The records are encoded without the dictionary of the file and the
+ * entry is compressed as a whole: the names and strings repeated from one
+ * record to the next then cost next to nothing, where the dictionary would
+ * keep a string for every float or double written.
+ */
+#define EET_DATA_BLOCK_VERSION 1
+
+static Eet_Data_Block *
+_eet_data_block_new(Eet_File *ef, Eet_Data_Descriptor *edd)
 {
-   return eet_data_dump_cipher(ef, name, NULL, dumpfunc, dumpdata);
+   Eet_Data_Block *block;
+
+   block = calloc(1, sizeof (Eet_Data_Block));
+   if (!block) return NULL;
+
+   block->edd = edd;
+   /* the records read may be mapped by ef */
+   eet_file_borrow(ef, NULL);
+   block->ef = ef;
+
+   return block;
 }
 
+EAPI Eet_Data_Block *
+eet_data_block_new(Eet_File *ef, Eet_Data_Descriptor *edd)
+{
+   Eet_Data_Block *block;
+   Eet_File_Mode mode;
+
+   if (!edd) return NULL;
+   mode = eet_mode_get(ef);
+   if (mode != EET_FILE_MODE_WRITE && mode != EET_FILE_MODE_READ_WRITE)
+     return NULL;
 
-EAPI int
-eet_data_text_dump_cipher(const void *data_in,
-			  const char *cipher_key, int size_in,
-			  void (*dumpfunc) (void *data, const char *str),
-			  void *dumpdata)
+   block = _eet_data_block_new(ef, edd);
+   if (!block) return NULL;
+
+   block->ds = eet_data_stream_new();
+   if (!block->ds)
+     {
+	eet_data_block_free(block);
+	return NULL;
+     }
+
+   return block;
+}
+
+EAPI Eina_Bool
+eet_data_block_append(Eet_Data_Block *block, const void *data)
 {
-   void *ret = NULL;
-   Eet_Node *result;
-   Eet_Free_Context context;
-   unsigned int ret_len = 0;
+   int pos;
 
-   if (!data_in) return 0;
+   if (!block || !block->ds) return EINA_FALSE;
 
-   if (cipher_key)
+   if (block->count == block->size)
      {
-       if (eet_decipher(data_in, size_in, cipher_key,
-			strlen(cipher_key), &ret, &ret_len))
-	 {
-	   if (ret) free(ret);
-	   return 0;
-	 }
+	int *ends;
+	int size;
+
+	size = block->size ? block->size * 2 : 64;
+	ends = realloc(block->ends, size * sizeof (int));
+	if (!ends) return EINA_FALSE;
+	block->ends = ends;
+	block->size = size;
      }
-   else
+
+   pos = block->ds->pos;
+   if (!_eet_data_descriptor_encode_stream(NULL, block->edd, data, block->ds))
      {
-	ret = (void*) data_in;
-	ret_len = size_in;
+	block->ds->pos = pos;
+	return EINA_FALSE;
      }
 
-   memset(&context, 0, sizeof (context));
-   result = _eet_data_descriptor_decode(&context, NULL, NULL, ret, ret_len);
+   /* the stream lost every record if it could not grow */
+   if (!block->ds->data)
+     {
+	block->ds->pos = 0;
+	block->count = 0;
+	return EINA_FALSE;
+     }
 
-   eet_node_dump(result, 0, dumpfunc, dumpdata);
+   block->ends[block->count++] = block->ds->pos;
+   return EINA_TRUE;
+}
 
-   eet_node_del(result);
-   if (cipher_key) free(ret);
+EAPI int
+eet_data_block_write_cipher(Eet_Data_Block *block, const char *name, const char *cipher_key, int compress)
+{
+   unsigned char head[4] = { 'B', 'L', 'K', EET_DATA_BLOCK_VERSION };
+   char *data;
+   int *index;
+   int records;
+   int size;
+   int val;
+   int i;
 
-   return result ? 1 : 0;
+   if (!block || !block->ds) return 0;
+
+   records = block->count ? block->ends[block->count - 1] : 0;
+   size = sizeof (head) + sizeof (int) * (block->count + 1) + records;
+   data = malloc(size);
+   if (!data) return 0;
+
+   memcpy(data, head, sizeof (head));
+   index = (int *) (data + sizeof (head));
+   index[0] = block->count;
+   CONV32(index[0]);
+   for (i = 0; i < block->count; i++)
+     {
+	index[i + 1] = block->ends[i];
+	CONV32(index[i + 1]);
+     }
+   if (records)
+     memcpy(index + block->count + 1, block->ds->data, records);
+
+   val = eet_write_cipher(block->ef, name, data, size, compress, cipher_key);
+   free(data);
+   return val;
 }
 
 EAPI int
-eet_data_text_dump(const void *data_in,
-		   int size_in,
-		   void (*dumpfunc) (void *data, const char *str),
-		   void *dumpdata)
+eet_data_block_write(Eet_Data_Block *block, const char *name, int compress)
 {
-   return eet_data_text_dump_cipher(data_in, NULL, size_in, dumpfunc, dumpdata);
+   return eet_data_block_write_cipher(block, name, NULL, compress);
 }
 
-EAPI void *
-eet_data_text_undump_cipher(const char *text,
-			    const char *cipher_key,
-			    int textlen,
-			    int *size_ret)
+EAPI Eet_Data_Block *
+eet_data_block_read_cipher(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name, const char *cipher_key)
 {
-   void *ret = NULL;
+   Eet_Data_Block *block;
+   const char *data = NULL;
+   void *buffer = NULL;
+   int count;
+   int size;
+   int i;
 
-   ret = _eet_data_dump_parse(NULL, size_ret, text, textlen);
-   if (ret && cipher_key)
+   if (!edd) return NULL;
+
+   if (!cipher_key)
+     data = eet_read_direct(ef, name, &size);
+   if (!data)
      {
-	void *ciphered = NULL;
-	unsigned int ciphered_len;
+	buffer = eet_read_cipher(ef, name, &size, cipher_key);
+	if (!buffer) return NULL;
+	data = buffer;
+     }
 
-	if (eet_cipher(ret, *size_ret, cipher_key,
-		       strlen(cipher_key), &ciphered, &ciphered_len))
+   if (_eet_data_words_bigendian == -1)
+     {
+	unsigned long int v;
+
+	v = htonl(0x12345678);
+	if (v == 0x12345678) _eet_data_words_bigendian = 1;
+	else _eet_data_words_bigendian = 0;
+     }
+
+   if (size < 8 || data[0] != 'B' || data[1] != 'L' || data[2] != 'K'
+       || data[3] != EET_DATA_BLOCK_VERSION)
+     goto on_error;
+
+   memcpy(&count, data + 4, sizeof (int));
+   CONV32(count);
+   if (count < 0 || count > (size - 8) / (int) sizeof (int))
+     goto on_error;
+
+   block = _eet_data_block_new(ef, edd);
+   if (!block) goto on_error;
+
+   block->records = data + 8 + count * sizeof (int);
+   block->buffer = buffer;
+   if (count)
+     {
+	block->ends = malloc(count * sizeof (int));
+	if (!block->ends)
 	  {
-	     if (ciphered) free(ciphered);
-	     size_ret = 0;
-	     free(ret);
+	     eet_data_block_free(block);
 	     return NULL;
 	  }
-	free(ret);
-	*size_ret = ciphered_len;
-	ret = ciphered;
      }
-   return ret;
+   block->count = block->size = count;
+
+   /* the records must follow each other inside the entry */
+   size -= 8 + count * sizeof (int);
+   for (i = 0; i < count; i++)
+     {
+	memcpy(block->ends + i, data + 8 + i * sizeof (int), sizeof (int));
+	CONV32(block->ends[i]);
+	if (block->ends[i] < (i ? block->ends[i - 1] : 0)
+	    || block->ends[i] > size)
+	  {
+	     ERR("Record block '%s' has an invalid index.", name);
+	     eet_data_block_free(block);
+	     return NULL;
+	  }
+     }
+
+   return block;
+
+ on_error:
+   ERR("Entry '%s' is not a record block.", name);
+   free(buffer);
+   return NULL;
+}
+
+EAPI Eet_Data_Block *
+eet_data_block_read(Eet_File *ef, Eet_Data_Descriptor *edd, const char *name)
+{
+   return eet_data_block_read_cipher(ef, edd, name, NULL);
+}
+
+EAPI int
+eet_data_block_count_get(const Eet_Data_Block *block)
+{
+   if (!block) return 0;
+   return block->count;
 }
 
 EAPI void *
-eet_data_text_undump(const char *text,
-		     int textlen,
-		     int *size_ret)
+eet_data_block_record_get(const Eet_Data_Block *block, int index)
 {
-   return eet_data_text_undump_cipher(text, NULL, textlen, size_ret);
+   Eet_Free_Context context;
+   const char *records;
+   int start;
+
+   if (!block || index < 0 || index >= block->count) return NULL;
+
+   records = block->ds ? block->ds->data : block->records;
+   start = index ? block->ends[index - 1] : 0;
+
+   memset(&context, 0, sizeof (context));
+   return _eet_data_descriptor_decode(&context, NULL, block->edd,
+				      records + start, block->ends[index] - start);
 }
 
-EAPI int
-eet_data_undump_cipher(Eet_File *ef,
-		       const char *name,
-		       const char *cipher_key,
-		       const char *text,
-		       int textlen,
-		       int compress)
+EAPI Eina_Bool
+eet_data_block_foreach(const Eet_Data_Block *block, Eet_Data_Block_Cb *func, void *fdata)
 {
-   Eet_Dictionary       *ed;
-   void                 *data_enc;
-   int                   size;
-   int                   val;
+   void *data;
+   int i;
 
-   ed = eet_dictionary_get(ef);
+   if (!block || !func) return EINA_FALSE;
 
-   data_enc = _eet_data_dump_parse(ed, &size, text, textlen);
-   if (!data_enc) return 0;
-   val = eet_write_cipher(ef, name, data_enc, size, compress, cipher_key);
-   free(data_enc);
-   return val;
+   for (i = 0; i < block->count; i++)
+     {
+	data = eet_data_block_record_get(block, i);
+	if (!data) return EINA_FALSE;
+	if (!func(block, i, data, fdata)) break;
+     }
+
+   return EINA_TRUE;
 }
 
-EAPI int
-eet_data_undump(Eet_File *ef,
-		const char *name,
-		const char *text,
-		int textlen,
-		int compress)
+EAPI void
+eet_data_block_free(Eet_Data_Block *block)
 {
-   return eet_data_undump_cipher(ef, name, NULL, text, textlen, compress);
+   if (!block) return ;
+
+   eet_data_stream_free(block->ds);
+   free(block->buffer);
+   free(block->ends);
+   if (block->ef) eet_close(block->ef);
+   free(block);
 }
 
-EAPI void *
-eet_data_descriptor_decode_cipher(Eet_Data_Descriptor *edd,
-				  const void *data_in,
-				  const char *cipher_key,
-				  int size_in)
+EAPI Eet_Node *
+eet_data_node_decode_cipher(const void *data_in, const char *cipher_key, int size_in)
 {
    void *deciphered = (void*) data_in;
-   void *ret;
+   Eet_Node *ret;
    Eet_Free_Context context;
    unsigned int deciphered_len = size_in;
 
@@ -3669,59 +8184,310 @@ eet_data_descriptor_decode_cipher(Eet_Data_Descriptor *edd,
      }
 
    memset(&context, 0, sizeof (context));
-   ret = _eet_data_descriptor_decode(&context, NULL, edd, deciphered, deciphered_len);
+   ret = _eet_data_descriptor_decode(&context, NULL, NULL, deciphered, deciphered_len);
 
    if (data_in != deciphered) free(deciphered);
 
    return ret;
 }
 
-EAPI void *
-eet_data_descriptor_decode(Eet_Data_Descriptor *edd,
-			   const void *data_in,
-			   int size_in)
+EAPI Eina_Bool
+eet_data_walk_read_cipher(Eet_File *ef, const char *name, const char *cipher_key, Eet_Data_Walk *cb, void *user_data)
 {
-   return eet_data_descriptor_decode_cipher(edd, data_in, NULL, size_in);
+   const Eet_Dictionary *ed = NULL;
+   const void *data = NULL;
+   Eina_Bool result;
+   int required_free = 0;
+   int size;
+
+   if (!cb) return EINA_FALSE;
+
+   ed = eet_dictionary_get(ef);
+
+   if (!cipher_key)
+     data = eet_read_direct(ef, name, &size);
+   if (!data)
+     {
+	required_free = 1;
+	data = eet_read_cipher(ef, name, &size, cipher_key);
+	if (!data) return EINA_FALSE;
+     }
+
+   result = _eet_data_walk(ed, (char *) data, size, cb, user_data);
+   if (required_free)
+     free((void*)data);
+
+   return result;
 }
 
-EAPI Eet_Node *
-eet_data_node_decode_cipher(const void *data_in, const char *cipher_key, int size_in)
+EAPI Eina_Bool
+eet_data_walk_decode_cipher(const void *data_in, const char *cipher_key, int size_in, Eet_Data_Walk *cb, void *user_data)
 {
    void *deciphered = (void*) data_in;
-   Eet_Node *ret;
-   Eet_Free_Context context;
    unsigned int deciphered_len = size_in;
+   Eina_Bool result;
 
-   if (cipher_key && data_in)
+   if (!data_in || !cb) return EINA_FALSE;
+
+   if (cipher_key)
      {
        if (eet_decipher(data_in, size_in, cipher_key,
 			strlen(cipher_key), &deciphered, &deciphered_len))
 	 {
 	   if (deciphered) free(deciphered);
-	   return NULL;
+	   return EINA_FALSE;
 	 }
      }
 
-   memset(&context, 0, sizeof (context));
-   ret = _eet_data_descriptor_decode(&context, NULL, NULL, deciphered, deciphered_len);
+   result = _eet_data_walk(NULL, deciphered, deciphered_len, cb, user_data);
 
    if (data_in != deciphered) free(deciphered);
 
-   return ret;
+   return result;
 }
 
-static void *
-_eet_data_descriptor_encode(Eet_Dictionary *ed,
-                            Eet_Data_Descriptor *edd,
-                            const void *data_in,
-                            int *size_ret)
+/*
+ * Walking reports what the chunks hold as they come, without descriptor
+ * and without allocating: strings point in the dictionary or in the data.
+ * Any callback returning EINA_FALSE stops the walk.
+ */
+static Eina_Bool
+_eet_data_walk_value(const Eet_Dictionary *ed, Eet_Data_Chunk *echnk,
+		     int group_type, const char *key,
+		     Eet_Data_Walk *cb, void *user_data)
 {
-   Eet_Data_Stream      *ds;
-   Eet_Data_Chunk       *chnk;
-   void                 *cdata;
-   int                   csize;
-   int                   i;
+   Eet_Node_Data value;
+   int type;
+
+   if (!cb->simple) return EINA_TRUE;
+
+   /* Eet_Node_Data has no fixed point */
+   type = echnk->type;
+   if (type == EET_T_F32P32 || type == EET_T_F16P16 || type == EET_T_F8P24)
+     type = EET_T_DOUBLE;
+
+   memset(&value, 0, sizeof (value));
+   if (eet_data_chunk_value_get(ed, echnk, type, &value.value) <= 0)
+     return EINA_FALSE;
+
+   return cb->simple(echnk->name, group_type, key, type, &value, user_data);
+}
+
+/* data holds the chunk of a structure, named after its descriptor */
+static Eina_Bool
+_eet_data_walk_struct(const Eet_Dictionary *ed, const char *name,
+		      int group_type, const char *key,
+		      char *data, int size,
+		      Eet_Data_Walk *cb, void *user_data)
+{
+   Eet_Data_Chunk chnk;
+
+   memset(&chnk, 0, sizeof (Eet_Data_Chunk));
+   eet_data_chunk_get(ed, &chnk, data, size);
+   if (!chnk.name) return EINA_FALSE;
+
+   if (ed)
+     size -= 4 + sizeof(int) * 2;
+   else
+     size -= 4 + 4 + chnk.len;
+
+   /* compact members can't be told apart without their descriptor */
+   if (EET_DATA_COMPACT_IS((char *) chnk.data, size))
+     {
+	ERR("Compact data for '%s' can't be walked.", chnk.name);
+	return EINA_FALSE;
+     }
+
+   if (cb->struct_begin && !cb->struct_begin(name, group_type, key, chnk.name, user_data))
+     return EINA_FALSE;
+   if (!_eet_data_walk_chunks(ed, chnk.data, size, cb, user_data))
+     return EINA_FALSE;
+   if (cb->struct_end && !cb->struct_end(name, user_data))
+     return EINA_FALSE;
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_walk_item(const Eet_Dictionary *ed, Eet_Data_Chunk *echnk,
+		    int group_type, const char *key,
+		    Eet_Data_Walk *cb, void *user_data)
+{
+   if (IS_SIMPLE_TYPE(echnk->type))
+     return _eet_data_walk_value(ed, echnk, group_type, key, cb, user_data);
+   /* like compact data, columns need their descriptor */
+   if (EET_DATA_COLUMNS_IS((char *) echnk->data, echnk->size))
+     {
+	ERR("Columns of '%s' can't be walked.", echnk->name);
+	return EINA_FALSE;
+     }
+   return _eet_data_walk_struct(ed, echnk->name, group_type, key,
+				echnk->data, echnk->size, cb, user_data);
+}
+
+/* Unions hold a structure, variants a structure or the chunks of a group. */
+static Eina_Bool
+_eet_data_walk_union(const Eet_Dictionary *ed, Eet_Data_Chunk *echnk,
+		     int group_type, const char *type,
+		     Eet_Data_Walk *cb, void *user_data)
+{
+   Eet_Data_Chunk chnk;
+
+   if (echnk->type != EET_T_NULL && echnk->size > 0)
+     {
+	memset(&chnk, 0, sizeof (Eet_Data_Chunk));
+	eet_data_chunk_get(ed, &chnk, echnk->data, echnk->size);
+	if (!chnk.name) return EINA_FALSE;
+
+	if (chnk.group_type == EET_G_UNKNOWN)
+	  return _eet_data_walk_struct(ed, echnk->name, group_type, type,
+				       echnk->data, echnk->size, cb, user_data);
+     }
+
+   if (cb->struct_begin && !cb->struct_begin(echnk->name, group_type, type, NULL, user_data))
+     return EINA_FALSE;
+   if (echnk->type != EET_T_NULL
+       && !_eet_data_walk_chunks(ed, echnk->data, echnk->size, cb, user_data))
+     return EINA_FALSE;
+   if (cb->struct_end && !cb->struct_end(echnk->name, user_data))
+     return EINA_FALSE;
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_walk_packed(Eet_Data_Chunk *echnk, int group_type, int count,
+		      Eet_Data_Walk *cb, void *user_data)
+{
+   const char *src;
+   int type;
+   int width;
+   int size;
+   int i;
+
+   src = ((const char *)echnk->data) + sizeof (int);
+   size = echnk->size - sizeof (int) - 1;
+
+   type = (unsigned char) *src++;
+   if (!IS_PACKED_TYPE(type)) return EINA_FALSE;
+
+   width = eet_basic_codec[type - 1].size;
+   if (count <= 0 || count > size / width || count * width != size)
+     return EINA_FALSE;
+
+   if (!cb->simple) return EINA_TRUE;
+
+   for (i = 0; i < count; i++, src += width)
+     {
+	Eet_Node_Data value;
+
+	memset(&value, 0, sizeof (value));
+	eet_data_packed_copy(&value.value, src, 1, width);
+	if (!cb->simple(echnk->name, group_type, NULL, type, &value, user_data))
+	  return EINA_FALSE;
+     }
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_data_walk_chunks(const Eet_Dictionary *ed, char *p, int size,
+		      Eet_Data_Walk *cb, void *user_data)
+{
+   while (size > 0)
+     {
+	Eet_Data_Chunk echnk;
+	const char *name;
+	const char *key;
+	int group_type;
+	int count;
+	int i;
+
+	memset(&echnk, 0, sizeof (Eet_Data_Chunk));
+	eet_data_chunk_get(ed, &echnk, p, size);
+	if (!echnk.name) return EINA_FALSE;
+
+	group_type = echnk.group_type;
+	switch (group_type)
+	  {
+	   case EET_G_UNKNOWN:
+	   case EET_G_LIST:
+	      if (!_eet_data_walk_item(ed, &echnk, group_type, NULL, cb, user_data))
+		return EINA_FALSE;
+	      break;
+	   case EET_G_HASH:
+	   case EET_G_UNION:
+	   case EET_G_VARIANT:
+	      /* the key or the type, then the value in the next chunk */
+	      if (eet_data_get_type(ed, EET_T_STRING, echnk.data,
+				    ((char *)echnk.data) + echnk.size, &key) <= 0)
+		return EINA_FALSE;
+
+	      NEXT_CHUNK(p, size, echnk, ed);
+	      memset(&echnk, 0, sizeof (Eet_Data_Chunk));
+	      eet_data_chunk_get(ed, &echnk, p, size);
+	      if (!echnk.name) return EINA_FALSE;
+
+	      if (group_type == EET_G_HASH)
+		{
+		   if (!_eet_data_walk_item(ed, &echnk, group_type, key, cb, user_data))
+		     return EINA_FALSE;
+		}
+	      else if (!_eet_data_walk_union(ed, &echnk, group_type, key, cb, user_data))
+		return EINA_FALSE;
+	      break;
+	   case EET_G_ARRAY:
+	   case EET_G_VAR_ARRAY:
+	      if (eet_data_get_type(ed, EET_T_INT, echnk.data,
+				    ((char *)echnk.data) + echnk.size, &count) <= 0)
+		return EINA_FALSE;
+
+	      name = echnk.name;
+	      if (cb->array_begin
+		  && !cb->array_begin(group_type == EET_G_VAR_ARRAY, name, count, user_data))
+		return EINA_FALSE;
+
+	      if (echnk.size > (int) sizeof(int)
+		  && EET_DATA_COLUMNS_IS(((char *)echnk.data) + sizeof (int), echnk.size - (int) sizeof (int)))
+		{
+		   ERR("Columns of '%s' can't be walked.", echnk.name);
+		   return EINA_FALSE;
+		}
+	      else if (echnk.size > (int) sizeof(int))
+		{
+		   if (!_eet_data_walk_packed(&echnk, group_type, count, cb, user_data))
+		     return EINA_FALSE;
+		}
+	      else
+		for (i = 0; i < count; i++)
+		  {
+		     NEXT_CHUNK(p, size, echnk, ed);
+		     memset(&echnk, 0, sizeof (Eet_Data_Chunk));
+		     eet_data_chunk_get(ed, &echnk, p, size);
+		     if (!echnk.name || strcmp(echnk.name, name) != 0)
+		       return EINA_FALSE;
+
+		     if (!_eet_data_walk_item(ed, &echnk, group_type, NULL, cb, user_data))
+		       return EINA_FALSE;
+		  }
+
+	      if (cb->array_end && !cb->array_end(name, user_data))
+		return EINA_FALSE;
+	      break;
+	   default:
+	      return EINA_FALSE;
+	  }
+
+	NEXT_CHUNK(p, size, echnk, ed);
+     }
+
+   return EINA_TRUE;
+}
 
+static Eina_Bool
+_eet_data_walk(const Eet_Dictionary *ed, char *data, int size,
+	       Eet_Data_Walk *cb, void *user_data)
+{
    if (_eet_data_words_bigendian == -1)
      {
 	unsigned long int v;
@@ -3731,31 +8497,74 @@ _eet_data_descriptor_encode(Eet_Dictionary *ed,
 	else _eet_data_words_bigendian = 0;
      }
 
-   ds = eet_data_stream_new();
-   for (i = 0; i < edd->elements.num; i++)
+   return _eet_data_walk_struct(ed, NULL, EET_G_UNKNOWN, NULL, data, size, cb, user_data);
+}
+
+static Eina_Bool
+_eet_data_descriptor_encode_stream(Eet_Dictionary *ed,
+				   Eet_Data_Descriptor *edd,
+				   const void *data_in,
+				   Eet_Data_Stream *ds)
+{
+   int                   start;
+   int                   i;
+
+   if (_eet_data_words_bigendian == -1)
      {
-	Eet_Data_Element *ede;
+	unsigned long int v;
 
-	ede = &(edd->elements.set[i]);
-	eet_group_codec[ede->group_type - 100].put(ed, edd, ede, ds, ((char *)data_in) + ede->offset);
+	v = htonl(0x12345678);
+	if (v == 0x12345678) _eet_data_words_bigendian = 1;
+	else _eet_data_words_bigendian = 0;
+     }
+
+   /* the elements are written right after the struct chunk head */
+   start = eet_data_chunk_open(ed, ds, edd->name, EET_T_UNKNOW, EET_G_UNKNOWN);
+   if (start < 0) return EINA_FALSE;
+
+   if (edd->compact)
+     {
+	if (!_eet_data_compact_encode(ed, edd, data_in, ds))
+	  {
+	     ds->pos = start;
+	     return EINA_FALSE;
+	  }
      }
-   chnk = eet_data_chunk_new(ds->data, ds->pos, edd->name, EET_T_UNKNOW, EET_G_UNKNOWN);
-   ds->data = NULL;
-   ds->size = 0;
-   eet_data_stream_free(ds);
+   else
+     for (i = 0; i < edd->elements.num; i++)
+       {
+	  Eet_Data_Element *ede;
+
+	  ede = &(edd->elements.set[i]);
+	  eet_group_codec[ede->group_type - 100].put(ed, edd, ede, ds, ((char *)data_in) + ede->offset);
+       }
+   eet_data_chunk_close(ds, start);
+
+   return EINA_TRUE;
+}
+
+static void *
+_eet_data_descriptor_encode(Eet_Dictionary *ed,
+                            Eet_Data_Descriptor *edd,
+                            const void *data_in,
+                            int *size_ret)
+{
+   Eet_Data_Stream      *ds;
+   void                 *cdata;
 
    ds = eet_data_stream_new();
-   eet_data_chunk_put(ed, chnk, ds);
-   cdata = ds->data;
-   csize = ds->pos;
+   if (!ds) return NULL;
+
+   if (!_eet_data_descriptor_encode_stream(ed, edd, data_in, ds))
+     {
+	eet_data_stream_free(ds);
+	return NULL;
+     }
 
-   ds->data = NULL;
-   ds->size = 0;
-   eet_data_stream_free(ds);
-   *size_ret = csize;
+   cdata = ds->data;
+   *size_ret = ds->pos;
 
-   free(chnk->data);
-   eet_data_chunk_free(chnk);
+   eet_data_stream_flush(ds);
 
    return cdata;
 }
@@ -3845,3 +8654,23 @@ eet_data_descriptor_encode(Eet_Data_Descriptor *edd,
 {
    return eet_data_descriptor_encode_cipher(edd, data_in, NULL, size_ret);
 }
+
+EAPI int
+eet_data_descriptor_encode_stream(Eet_Data_Descriptor *edd,
+				  const void *data_in,
+				  Eet_Data_Stream *ds)
+{
+   int pos;
+
+   if (!edd || !ds) return 0;
+
+   pos = ds->pos;
+   if (!_eet_data_descriptor_encode_stream(NULL, edd, data_in, ds))
+     return 0;
+
+   /* the stream lost everything if it could not grow */
+   if (!ds->data || ds->pos <= pos)
+     return 0;
+
+   return ds->pos - pos;
+}
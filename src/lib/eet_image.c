@@ -218,6 +218,7 @@ static void *eet_data_image_lossless_convert(int *size, const void *data, unsign
 static void *eet_data_image_lossless_compressed_convert(int *size, const void *data, unsigned int w, unsigned int h, int alpha, int compression);
 static void *eet_data_image_jpeg_convert(int *size, const void *data, unsigned int w, unsigned int h, int alpha, int quality);
 static void *eet_data_image_jpeg_alpha_convert(int *size, const void *data, unsigned int w, unsigned int h, int alpha, int quality);
+static int   _eet_data_image_decode_inside(const void *data, int size, unsigned int src_x, unsigned int src_y, unsigned int src_w, unsigned int src_h, unsigned int *d, unsigned int w, unsigned int h, unsigned int row_stride, int alpha, int comp, int quality, int lossy);
 
 /*---*/
 
@@ -225,23 +226,9 @@ static int _eet_image_words_bigendian = -1;
 
 /*---*/
 
-#define SWAP64(x) (x) = \
-   ((((unsigned long long)(x) & 0x00000000000000ffULL ) << 56) |\
-       (((unsigned long long)(x) & 0x000000000000ff00ULL ) << 40) |\
-       (((unsigned long long)(x) & 0x0000000000ff0000ULL ) << 24) |\
-       (((unsigned long long)(x) & 0x00000000ff000000ULL ) << 8) |\
-       (((unsigned long long)(x) & 0x000000ff00000000ULL ) >> 8) |\
-       (((unsigned long long)(x) & 0x0000ff0000000000ULL ) >> 24) |\
-       (((unsigned long long)(x) & 0x00ff000000000000ULL ) >> 40) |\
-       (((unsigned long long)(x) & 0xff00000000000000ULL ) >> 56))
-#define SWAP32(x) (x) = \
-   ((((int)(x) & 0x000000ff ) << 24) |\
-       (((int)(x) & 0x0000ff00 ) << 8) |\
-       (((int)(x) & 0x00ff0000 ) >> 8) |\
-       (((int)(x) & 0xff000000 ) >> 24))
-#define SWAP16(x) (x) = \
-   ((((short)(x) & 0x00ff ) << 8) |\
-       (((short)(x) & 0xff00 ) >> 8))
+#define SWAP64(x) (x) = EET_BSWAP64(x)
+#define SWAP32(x) (x) = EET_BSWAP32(x)
+#define SWAP16(x) (x) = EET_BSWAP16(x)
 
 #ifdef CONV8
 # undef CONV8
@@ -586,14 +573,14 @@ eet_data_image_lossless_convert(int *size, const void *data, unsigned int w, uns
 	header[2] = h;
 	header[3] = alpha;
 
-	memcpy(d + 32, data, w * h * 4);
-
+	/* the pixels are swapped on the way in */
 	if (_eet_image_words_bigendian)
 	  {
-	     unsigned int i;
-
-	     for (i = 0; i < ((w * h) + 8); i++) SWAP32(header[i]);
+	     eet_swap32(header, header, 8);
+	     eet_swap32(d + 32, data, w * h);
 	  }
+	else
+	  memcpy(d + 32, data, w * h * 4);
 	*size = ((w * h * 4) + (8 * 4));
 	return d;
      }
@@ -635,14 +622,14 @@ eet_data_image_lossless_compressed_convert(int *size, const void *data, unsigned
 	header[2] = h;
 	header[3] = alpha;
 	header[4] = compression;
-	memcpy(d + 32, data, w * h * 4);
-
+	/* the pixels are swapped on the way in */
 	if (_eet_image_words_bigendian)
 	  {
-	     unsigned int i;
-
-	     for (i = 0; i < ((w * h) + 8); i++) SWAP32(header[i]);
+	     eet_swap32(header, header, 8);
+	     eet_swap32(d + 32, data, w * h);
 	  }
+	else
+	  memcpy(d + 32, data, w * h * 4);
 	ret = compress2((Bytef *)comp, &buflen,
 			(Bytef *)(d + 32),
 			(uLong)(w * h * 4),
@@ -972,6 +959,65 @@ eet_data_image_read(Eet_File *ef, const char *name,
    return eet_data_image_read_cipher(ef, name, NULL, w, h, alpha, comp, quality, lossy);
 }
 
+EAPI int
+eet_data_image_read_cipher_into(Eet_File *ef, const char *name, const char *cipher_key,
+				unsigned int *d, int buffer_size,
+				unsigned int *w, unsigned int *h, int *alpha,
+				int *comp, int *quality, int *lossy)
+{
+   unsigned int  iw, ih;
+   int		 ialpha, icompress, iquality, ilossy;
+   void		*data = NULL;
+   int		 free_data = 0;
+   int		 needed = 0;
+   int		 size;
+
+   if (!cipher_key)
+     data = (void *)eet_read_direct(ef, name, &size);
+   if (!data)
+     {
+        data = eet_read_cipher(ef, name, &size, cipher_key);
+	free_data = 1;
+	if (!data) return 0;
+     }
+
+   /* All check are done during header decode, this simplify the code a lot. */
+   if (!eet_data_image_header_decode(data, size, &iw, &ih, &ialpha, &icompress, &iquality, &ilossy))
+     goto on_error;
+
+   needed = iw * ih * 4;
+   if (d && needed <= buffer_size)
+     {
+	if (!_eet_data_image_decode_inside(data, size, 0, 0, iw, ih, d, iw, ih, iw * 4, ialpha, icompress, iquality, ilossy))
+	  {
+	     needed = 0;
+	     goto on_error;
+	  }
+     }
+
+   if (w) *w = iw;
+   if (h) *h = ih;
+   if (alpha) *alpha = ialpha;
+   if (comp) *comp = icompress;
+   if (quality) *quality = iquality;
+   if (lossy) *lossy = ilossy;
+
+ on_error:
+   if (free_data)
+     free(data);
+
+   return needed;
+}
+
+EAPI int
+eet_data_image_read_into(Eet_File *ef, const char *name,
+			 unsigned int *d, int buffer_size,
+			 unsigned int *w, unsigned int *h, int *alpha,
+			 int *comp, int *quality, int *lossy)
+{
+   return eet_data_image_read_cipher_into(ef, name, NULL, d, buffer_size, w, h, alpha, comp, quality, lossy);
+}
+
 EAPI int
 eet_data_image_read_to_surface_cipher(Eet_File *ef, const char *name, const char *cipher_key, unsigned int src_x, unsigned int src_y,
 				      unsigned int *d, unsigned int w, unsigned int h, unsigned int row_stride,
@@ -1257,11 +1303,7 @@ _eet_data_image_decode_inside(const void *data, int size, unsigned int src_x, un
 
 	/* Fix swapiness. */
 	if (_eet_image_words_bigendian)
-	  {
-	     unsigned int x;
-
-	     for (x = 0; x < (w * h); x++) SWAP32(d[x]);
-	  }
+	  eet_swap32(d, d, w * h);
      }
    else if (comp == 0 && lossy == 1)
      {
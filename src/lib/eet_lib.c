@@ -84,6 +84,8 @@ EAPI Eet_Version *eet_version = &_version;
 typedef struct _Eet_File_Header         Eet_File_Header;
 typedef struct _Eet_File_Node           Eet_File_Node;
 typedef struct _Eet_File_Directory      Eet_File_Directory;
+typedef struct _Eet_Read_Stream         Eet_Read_Stream;
+typedef struct _Eet_Read_Into           Eet_Read_Into;
 
 struct _Eet_File
 {
@@ -96,6 +98,7 @@ struct _Eet_File
    const void           *x509_der;
    const void           *signature;
    void                 *sha1;
+   Eina_List            *borrowed;
 
    Eet_File_Mode         mode;
 
@@ -105,9 +108,16 @@ struct _Eet_File
    int                   data_size;
    int                   x509_length;
    unsigned int          signature_length;
+   /* bytes covered by the signature, 0 when the file isn't signed */
+   unsigned int          signed_length;
    int                   sha1_length;
 
    time_t                mtime;
+   time_t                ctime;
+   long                  mtime_nsec;
+   long                  ctime_nsec;
+   dev_t                 dev;
+   ino_t                 ino;
 
 #ifdef EFL_HAVE_PTHREAD
    pthread_mutex_t	 file_lock;
@@ -115,6 +125,27 @@ struct _Eet_File
 
    unsigned char         writes_pending : 1;
    unsigned char         delete_me_now : 1;
+   unsigned char         checksum : 1;
+};
+
+struct _Eet_Read_Stream
+{
+   unsigned char        *data;
+   unsigned int          length;
+
+   /* where the copy gets its memory once the clear size is known */
+   Eet_Read_Alloc_Callback alloc_cb;
+   void                 *alloc_data;
+
+   z_stream              zstream;
+   int                   status;
+};
+
+struct _Eet_Read_Into
+{
+   void                 *buffer;
+   int                   buffer_size;
+   int                   needed;
 };
 
 struct _Eet_File_Header
@@ -143,9 +174,13 @@ struct _Eet_File_Node
    int                   size;
    int                   data_size;
 
+   unsigned int          crc32c;
+
    unsigned char         free_name : 1;
    unsigned char         compression : 1;
    unsigned char         ciphered : 1;
+   unsigned char         checksummed : 1;
+   unsigned char         checksum_checked : 1;
 };
 
 #if 0
@@ -181,7 +216,7 @@ struct
   int data_size; /* size of the (uncompressed) data chunk */
   int name_offset; /* bytes offset into file for name string */
   int name_size; /* length in bytes of the name field */
-  int flags; /* flags - for now 0 = uncompressed, 1 = compressed */
+  int flags; /* flags - 0x1 = compressed, 0x2 = ciphered, 0x4 = checksummed */
 } directory[num_directory_entries];
 struct
 {
@@ -191,6 +226,9 @@ struct
   int prev;
   int next;
 } dictionary[num_dictionary_entries];
+/* Optional, only if one directory flags has 0x4 set. Older readers skip it */
+/* as every offset is absolute. */
+int crc32c[num_directory_entries]; /* CRC32C of the stored data chunk. */
 /* now start the string stream. */
 /* and right after them the data stream. */
 int magic_sign; /* Optional, only if the eet file is signed. */
@@ -204,6 +242,33 @@ char x509[x509_length]; /* The public certificate. */
 #define EET_FILE2_DIRECTORY_ENTRY_COUNT         6
 #define EET_FILE2_DICTIONARY_ENTRY_COUNT        5
 
+#define EET_MAGIC_IDENTITY_CACHE        0x1ee7c4c8
+
+#define EET_IDENTITY_FINGERPRINT_SIZE   20
+
+typedef struct _Eet_Identity_Cache_Key  Eet_Identity_Cache_Key;
+typedef struct _Eet_Identity_Cache_Node Eet_Identity_Cache_Node;
+
+/* this is also the on disk record, stored in host order after the magic */
+struct _Eet_Identity_Cache_Key
+{
+   unsigned long long    dev;
+   unsigned long long    ino;
+   long long             mtime;
+   long long             mtime_nsec;
+   long long             ctime;
+   long long             ctime_nsec;
+   long long             size;
+   unsigned char         fingerprint[EET_IDENTITY_FINGERPRINT_SIZE];
+   unsigned char         padding[4];
+};
+
+struct _Eet_Identity_Cache_Node
+{
+   Eet_Identity_Cache_Key   key;
+   Eet_Identity_Cache_Node *next;
+};
+
 #define EET_FILE2_HEADER_SIZE                   (sizeof(int) * EET_FILE2_HEADER_COUNT)
 #define EET_FILE2_DIRECTORY_ENTRY_SIZE          (sizeof(int) * EET_FILE2_DIRECTORY_ENTRY_COUNT)
 #define EET_FILE2_DICTIONARY_ENTRY_SIZE         (sizeof(int) * EET_FILE2_DICTIONARY_ENTRY_COUNT)
@@ -221,6 +286,14 @@ static Eet_File_Node	*find_node_by_name(Eet_File *ef, const char *name);
 static int		read_data_from_disk(Eet_File *ef, Eet_File_Node *efn, void *buf, int len);
 
 static Eet_Error        eet_internal_close(Eet_File *ef, Eina_Bool locked);
+static Eina_Bool        eet_node_checksum_verify(Eet_File *ef, Eet_File_Node *efn, const void *src, Eina_Bool force);
+
+#ifdef HAVE_SIGNATURE
+static Eina_Bool        eet_identity_cache_key_set(Eet_Identity_Cache_Key *key, const Eet_File *ef, const void *x509_der, int x509_length);
+static Eina_Bool        eet_identity_cache_find(const Eet_Identity_Cache_Key *key);
+static void             eet_identity_cache_add(const Eet_Identity_Cache_Key *key, Eina_Bool store);
+static void             eet_identity_cache_flush(void);
+#endif
 
 #ifdef EFL_HAVE_PTHREAD
 static pthread_mutex_t eet_cache_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -254,6 +327,15 @@ static int        eet_readers_alloc   = 0;
 static Eet_File **eet_readers         = NULL;
 static int        eet_init_count       = 0;
 
+static Eet_Checksum_Verify eet_checksum_verify = EET_CHECKSUM_VERIFY_FIRST_TOUCH;
+
+/* verified signatures, only used when enabled */
+#ifdef HAVE_SIGNATURE
+static Eina_Bool                 eet_identity_cache_enabled = EINA_FALSE;
+static char                     *eet_identity_cache_path    = NULL;
+static Eet_Identity_Cache_Node  *eet_identity_cache[256];
+#endif
+
 /* log domain variable */
 int _eet_log_dom_global = -1;
 
@@ -411,6 +493,105 @@ eet_cache_del(Eet_File *ef, Eet_File ***cache, int *cache_num, int *cache_alloc)
    *cache_alloc = new_cache_alloc;
 }
 
+#ifdef HAVE_SIGNATURE
+/* the verified signature cache should only be used when the cache lock is already held */
+static int
+eet_identity_cache_hash(const Eet_Identity_Cache_Key *key)
+{
+   return (int) ((key->ino ^ (key->ino >> 8) ^ key->size) & 0xff);
+}
+
+static Eina_Bool
+eet_identity_cache_key_set(Eet_Identity_Cache_Key *key, const Eet_File *ef,
+			   const void *x509_der, int x509_length)
+{
+   void *fingerprint;
+   int fingerprint_length;
+
+   /* only files opened from disk have an identity */
+   if (!ef->path) return EINA_FALSE;
+
+   fingerprint = eet_identity_compute_sha1(x509_der, x509_length, &fingerprint_length);
+   if (!fingerprint) return EINA_FALSE;
+   if (fingerprint_length != EET_IDENTITY_FINGERPRINT_SIZE)
+     {
+	free(fingerprint);
+	return EINA_FALSE;
+     }
+
+   memset(key, 0, sizeof (Eet_Identity_Cache_Key));
+   key->dev = ef->dev;
+   key->ino = ef->ino;
+   key->mtime = ef->mtime;
+   key->mtime_nsec = ef->mtime_nsec;
+   key->ctime = ef->ctime;
+   key->ctime_nsec = ef->ctime_nsec;
+   key->size = ef->data_size;
+   memcpy(key->fingerprint, fingerprint, EET_IDENTITY_FINGERPRINT_SIZE);
+
+   free(fingerprint);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+eet_identity_cache_find(const Eet_Identity_Cache_Key *key)
+{
+   Eet_Identity_Cache_Node *node;
+
+   for (node = eet_identity_cache[eet_identity_cache_hash(key)]; node; node = node->next)
+     if (!memcmp(&node->key, key, sizeof (Eet_Identity_Cache_Key)))
+       return EINA_TRUE;
+
+   return EINA_FALSE;
+}
+
+static void
+eet_identity_cache_add(const Eet_Identity_Cache_Key *key, Eina_Bool store)
+{
+   Eet_Identity_Cache_Node *node;
+   int hash;
+
+   if (eet_identity_cache_find(key)) return ;
+
+   node = malloc(sizeof (Eet_Identity_Cache_Node));
+   if (!node) return ;
+
+   hash = eet_identity_cache_hash(key);
+   memcpy(&node->key, key, sizeof (Eet_Identity_Cache_Key));
+   node->next = eet_identity_cache[hash];
+   eet_identity_cache[hash] = node;
+
+   if (store && eet_identity_cache_path)
+     {
+	FILE *fp;
+
+	fp = fopen(eet_identity_cache_path, "ab");
+	if (!fp) return ;
+
+	if (fwrite(key, sizeof (Eet_Identity_Cache_Key), 1, fp) != 1)
+	  WRN("Unable to store verified signature in '%s'.", eet_identity_cache_path);
+	fclose(fp);
+     }
+}
+
+static void
+eet_identity_cache_flush(void)
+{
+   int i;
+
+   for (i = 0; i < 256; i++)
+     {
+	Eet_Identity_Cache_Node *node;
+
+	while ((node = eet_identity_cache[i]))
+	  {
+	     eet_identity_cache[i] = node->next;
+	     free(node);
+	  }
+     }
+}
+#endif
+
 /* internal string match. null friendly, catches same ptr */
 static int
 eet_string_match(const char *s1, const char *s2)
@@ -433,6 +614,7 @@ eet_flush2(Eet_File *ef)
    int num_dictionary_entries = 0;
    int bytes_directory_entries = 0;
    int bytes_dictionary_entries = 0;
+   int bytes_checksums = 0;
    int bytes_strings = 0;
    int data_offset = 0;
    int strings_offset = 0;
@@ -483,10 +665,12 @@ eet_flush2(Eet_File *ef)
    /* calculate section bytes size */
    bytes_directory_entries = EET_FILE2_DIRECTORY_ENTRY_SIZE * num_directory_entries + EET_FILE2_HEADER_SIZE;
    bytes_dictionary_entries = EET_FILE2_DICTIONARY_ENTRY_SIZE * num_dictionary_entries;
+   if (ef->checksum)
+     bytes_checksums = sizeof(int) * num_directory_entries;
 
    /* calculate per entry offset */
-   strings_offset = bytes_directory_entries + bytes_dictionary_entries;
-   data_offset = bytes_directory_entries + bytes_dictionary_entries + bytes_strings;
+   strings_offset = bytes_directory_entries + bytes_dictionary_entries + bytes_checksums;
+   data_offset = strings_offset + bytes_strings;
 
    for (i = 0; i < num; ++i)
      {
@@ -497,6 +681,12 @@ eet_flush2(Eet_File *ef)
 
              efn->name_offset = strings_offset;
              strings_offset += efn->name_size;
+
+             /* what we write is what we checked */
+             efn->checksummed = ef->checksum;
+             efn->checksum_checked = ef->checksum;
+             if (ef->checksum)
+               efn->crc32c = eet_crc32c(efn->data, efn->size);
           }
      }
 
@@ -521,7 +711,7 @@ eet_flush2(Eet_File *ef)
 	     unsigned int flag;
              int ibuf[EET_FILE2_DIRECTORY_ENTRY_COUNT];
 
-	     flag = (efn->ciphered << 1) | efn->compression;
+	     flag = (efn->checksummed << 2) | (efn->ciphered << 1) | efn->compression;
 
              ibuf[0] = (int) htonl ((unsigned int) efn->offset);
              ibuf[1] = (int) htonl ((unsigned int) efn->size);
@@ -557,6 +747,22 @@ eet_flush2(Eet_File *ef)
           }
      }
 
+   /* write checksums */
+   if (ef->checksum)
+     {
+        for (i = 0; i < num; i++)
+          {
+             for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+               {
+                  int crc;
+
+                  crc = (int) htonl(efn->crc32c);
+                  if (fwrite(&crc, sizeof (crc), 1, fp) != 1)
+                    goto write_error;
+               }
+          }
+     }
+
    /* write directories name */
    for (i = 0; i < num; i++)
      {
@@ -662,6 +868,9 @@ eet_init(void)
 	goto unregister_log_domain;
      }
 
+   eet_crc32c_init();
+   eet_cipher_context_init();
+
 #ifdef HAVE_GNUTLS
    /* Before the library can be used, it must initialize itself if needed. */
    if (gcry_control (GCRYCTL_ANY_INITIALIZATION_P) == 0)
@@ -691,6 +900,7 @@ eet_init(void)
    return eet_init_count;
 
  shutdown_eet:
+   eet_cipher_context_shutdown();
    eet_node_shutdown();
  unregister_log_domain:
    eina_log_domain_unregister(_eet_log_dom_global);
@@ -707,6 +917,10 @@ eet_shutdown(void)
      return eet_init_count;
 
    eet_clearcache();
+#ifdef HAVE_SIGNATURE
+   eet_identity_cache_set(EINA_FALSE);
+#endif
+   eet_cipher_context_shutdown();
    eet_node_shutdown();
 #ifdef HAVE_GNUTLS
    gnutls_global_deinit();
@@ -806,6 +1020,7 @@ eet_internal_read2(Eet_File *ef)
 {
    const int    *data = (const int*) ef->data;
    const char   *start = (const char*) ef->data;
+   const int    *checksums;
    int           idx = 0;
    int           num_directory_entries;
    int           bytes_directory_entries;
@@ -863,6 +1078,9 @@ eet_internal_read2(Eet_File *ef)
 
    signature_base_offset = 0;
 
+   /* checksums, when there are some, follow the dictionary */
+   checksums = (const int*) (start + bytes_directory_entries + bytes_dictionary_entries);
+
    /* actually read the directory block - all of it, into ram */
    for (i = 0; i < num_directory_entries; ++i)
      {
@@ -889,6 +1107,9 @@ eet_internal_read2(Eet_File *ef)
 
 	efn->compression = flag & 0x1 ? 1 : 0;
 	efn->ciphered = flag & 0x2 ? 1 : 0;
+	efn->checksummed = flag & 0x4 ? 1 : 0;
+	efn->checksum_checked = 0;
+	efn->crc32c = 0;
 
 #define EFN_TEST(Test, Ef, Efn)                 \
         if (eet_test_close(Test, Ef))           \
@@ -912,6 +1133,16 @@ eet_internal_read2(Eet_File *ef)
         /* check '\0' at the end of name string */
         EFN_TEST(name[name_size - 1] != '\0', ef, efn);
 
+        if (efn->checksummed)
+          {
+             EFN_TEST((int) (bytes_directory_entries + bytes_dictionary_entries
+                             + sizeof(int) * num_directory_entries) > ef->data_size, ef, efn);
+
+             efn->crc32c = ntohl(checksums[i]);
+             /* keep them when rewriting this file */
+             ef->checksum = 1;
+          }
+
         efn->free_name = 0;
         efn->name = (char*) name;
         efn->name_size = name_size;
@@ -1007,13 +1238,39 @@ eet_internal_read2(Eet_File *ef)
      {
 #ifdef HAVE_SIGNATURE
 	const unsigned char *buffer = ((const unsigned char*) ef->data) + signature_base_offset;
-	ef->x509_der = eet_identity_check(ef->data, signature_base_offset,
-					  &ef->sha1, &ef->sha1_length,
-					  buffer, ef->data_size - signature_base_offset,
-					  &ef->signature, &ef->signature_length,
-					  &ef->x509_length);
+	Eet_Identity_Cache_Key key;
+	Eina_Bool cacheable = EINA_FALSE;
+
+	ef->signed_length = signature_base_offset;
+
+	if (eet_identity_cache_enabled)
+	  {
+	     const void *x509_der;
+
+	     x509_der = eet_identity_parse(buffer, ef->data_size - signature_base_offset,
+					   &ef->signature, &ef->signature_length,
+					   &ef->x509_length);
+	     if (x509_der)
+	       cacheable = eet_identity_cache_key_set(&key, ef, x509_der, ef->x509_length);
+
+	     /* this exact file has already been verified, skip the full check */
+	     if (cacheable && eet_identity_cache_find(&key))
+	       ef->x509_der = x509_der;
+	  }
 
-	if (eet_test_close(ef->x509_der == NULL, ef)) return NULL;
+	if (!ef->x509_der)
+	  {
+	     ef->x509_der = eet_identity_check(ef->data, signature_base_offset,
+					       &ef->sha1, &ef->sha1_length,
+					       buffer, ef->data_size - signature_base_offset,
+					       &ef->signature, &ef->signature_length,
+					       &ef->x509_length);
+
+	     if (eet_test_close(ef->x509_der == NULL, ef)) return NULL;
+
+	     if (cacheable)
+	       eet_identity_cache_add(&key, EINA_TRUE);
+	  }
 #else
 	ERR("This file could be signed but you didn't compile the necessary code to check the signature.");
 #endif
@@ -1120,6 +1377,8 @@ eet_internal_read1(Eet_File *ef)
 
         efn->name_size = name_size;
 	efn->ciphered = 0;
+	efn->checksummed = 0;
+	efn->checksum_checked = 0;
 
 	/* invalid size */
 	if (eet_test_close(efn->size <= 0, ef))
@@ -1227,6 +1486,7 @@ static Eet_Error
 eet_internal_close(Eet_File *ef, Eina_Bool locked)
 {
    Eet_Error err;
+   void *buffer;
 
    /* check to see its' an eet file pointer */
    if (eet_check_pointer(ef))
@@ -1238,6 +1498,9 @@ eet_internal_close(Eet_File *ef, Eina_Bool locked)
    ef->references--;
    /* if its still referenced - dont go any further */
    if (ef->references > 0) goto on_error;
+   /* nobody holds strings borrowed from these buffers anymore */
+   EINA_LIST_FREE(ef->borrowed, buffer)
+     free(buffer);
    /* flush any writes */
    err = eet_flush2(ef);
 
@@ -1332,12 +1595,20 @@ eet_memopen_read(const void *data, size_t size)
    ef->mode = EET_FILE_MODE_READ;
    ef->header = NULL;
    ef->mtime = 0;
+   ef->ctime = 0;
+   ef->mtime_nsec = 0;
+   ef->ctime_nsec = 0;
+   ef->dev = 0;
+   ef->ino = 0;
    ef->delete_me_now = 1;
+   ef->checksum = 0;
    ef->readfp = NULL;
    ef->data = data;
    ef->data_size = size;
    ef->sha1 = NULL;
+   ef->borrowed = NULL;
    ef->sha1_length = 0;
+   ef->signed_length = 0;
 
    /* eet_internal_read expects the cache lock to be held when it is called */
    LOCK_CACHE;
@@ -1454,12 +1725,25 @@ eet_open(const char *file, Eet_File_Mode mode)
    ef->mode = mode;
    ef->header = NULL;
    ef->mtime = file_stat.st_mtime;
+   ef->ctime = file_stat.st_ctime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+   ef->mtime_nsec = file_stat.st_mtim.tv_nsec;
+   ef->ctime_nsec = file_stat.st_ctim.tv_nsec;
+#else
+   ef->mtime_nsec = 0;
+   ef->ctime_nsec = 0;
+#endif
+   ef->dev = file_stat.st_dev;
+   ef->ino = file_stat.st_ino;
    ef->writes_pending = 0;
    ef->delete_me_now = 0;
+   ef->checksum = 0;
    ef->data = NULL;
    ef->data_size = 0;
    ef->sha1 = NULL;
+   ef->borrowed = NULL;
    ef->sha1_length = 0;
+   ef->signed_length = 0;
 
    ef->ed = (mode == EET_FILE_MODE_WRITE)
      || (ef->readfp == NULL && mode == EET_FILE_MODE_READ_WRITE) ?
@@ -1537,13 +1821,94 @@ eet_identity_signature(Eet_File *ef, int *signature_length)
 EAPI const void *
 eet_identity_sha1(Eet_File *ef, int *sha1_length)
 {
+   /* a file found in the identity cache skipped eet_identity_check(), so
+    * hash what it would have */
    if (!ef->sha1)
-     ef->sha1 = eet_identity_compute_sha1(ef->data, ef->data_size, &ef->sha1_length);
+     ef->sha1 = eet_identity_file_sha1(ef->data, ef->data_size,
+				       ef->signed_length ? ef->signed_length : (unsigned int) ef->data_size,
+				       &ef->sha1_length);
 
    if (sha1_length) *sha1_length = ef->sha1_length;
    return ef->sha1;
 }
 
+EAPI Eina_Bool
+eet_identity_cache_set(Eina_Bool enabled)
+{
+#ifdef HAVE_SIGNATURE
+   LOCK_CACHE;
+   eet_identity_cache_enabled = enabled;
+   if (!enabled)
+     {
+	eet_identity_cache_flush();
+	free(eet_identity_cache_path);
+	eet_identity_cache_path = NULL;
+     }
+   UNLOCK_CACHE;
+   return EINA_TRUE;
+#else
+   (void) enabled;
+   return EINA_FALSE;
+#endif
+}
+
+EAPI Eina_Bool
+eet_identity_cache_file_set(const char *path)
+{
+#ifdef HAVE_SIGNATURE
+   Eet_Identity_Cache_Key key;
+   FILE *fp;
+   char *tmp;
+   int magic;
+
+   LOCK_CACHE;
+   free(eet_identity_cache_path);
+   eet_identity_cache_path = NULL;
+   if (!path) goto on_success;
+
+   fp = fopen(path, "a+b");
+   if (!fp) goto on_error;
+
+   /* a new file, give it a magic so that we only ever trust our own records */
+   if (fseek(fp, 0, SEEK_END) || ftell(fp) == 0)
+     {
+	magic = EET_MAGIC_IDENTITY_CACHE;
+	if (fwrite(&magic, sizeof (int), 1, fp) != 1)
+	  goto on_file_error;
+     }
+   else
+     {
+	rewind(fp);
+	if (fread(&magic, sizeof (int), 1, fp) != 1
+	    || magic != EET_MAGIC_IDENTITY_CACHE)
+	  goto on_file_error;
+
+	while (fread(&key, sizeof (Eet_Identity_Cache_Key), 1, fp) == 1)
+	  eet_identity_cache_add(&key, EINA_FALSE);
+     }
+   fclose(fp);
+
+   tmp = strdup(path);
+   if (!tmp) goto on_error;
+   eet_identity_cache_path = tmp;
+
+ on_success:
+   eet_identity_cache_enabled = EINA_TRUE;
+   UNLOCK_CACHE;
+   return EINA_TRUE;
+
+ on_file_error:
+   ERR("'%s' is not a valid signature cache.", path);
+   fclose(fp);
+ on_error:
+   UNLOCK_CACHE;
+   return EINA_FALSE;
+#else
+   (void) path;
+   return EINA_FALSE;
+#endif
+}
+
 EAPI Eet_Error
 eet_identity_set(Eet_File *ef, Eet_Key *key)
 {
@@ -1567,10 +1932,97 @@ eet_close(Eet_File *ef)
    return eet_internal_close(ef, EINA_FALSE);
 }
 
-EAPI void *
-eet_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key)
+/* called with the file lock held, src being the stored bytes of efn */
+static Eina_Bool
+eet_node_checksum_verify(Eet_File *ef, Eet_File_Node *efn, const void *src, Eina_Bool force)
+{
+   if (!efn->checksummed) return EINA_TRUE;
+   if (!force)
+     {
+	if (eet_checksum_verify == EET_CHECKSUM_VERIFY_OFF) return EINA_TRUE;
+	if (eet_checksum_verify == EET_CHECKSUM_VERIFY_FIRST_TOUCH
+	    && efn->checksum_checked)
+	  return EINA_TRUE;
+     }
+
+   if (eet_crc32c(src, efn->size) != efn->crc32c)
+     {
+	ERR("Entry '%s' of '%s' does not match its checksum.",
+	    efn->name, ef->path ? ef->path : "(memory)");
+	return EINA_FALSE;
+     }
+
+   efn->checksum_checked = 1;
+   return EINA_TRUE;
+}
+
+/* where the stored bytes of an entry are, if they are reachable without a copy */
+static const void *
+eet_node_data_get(Eet_File *ef, Eet_File_Node *efn)
+{
+   if (efn->data) return efn->data;
+   if (efn->offset < 0 || !ef->data) return NULL;
+   if ((efn->offset + efn->size) > ef->data_size) return NULL;
+
+   return ef->data + efn->offset;
+}
+
+static Eina_Bool
+eet_read_copy_cb(void *data, const void *clear, unsigned int clear_length, unsigned int total)
+{
+   Eet_Read_Stream *stream = data;
+
+   if (!stream->data)
+     {
+	stream->data = stream->alloc_cb ?
+	  stream->alloc_cb(stream->alloc_data, total) : malloc(total ? total : 1);
+	if (!stream->data) return EINA_FALSE;
+     }
+
+   memcpy(stream->data + stream->length, clear, clear_length);
+   stream->length += clear_length;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+eet_read_inflate_cb(void *data, const void *clear, unsigned int clear_length, unsigned int total __UNUSED__)
+{
+   Eet_Read_Stream *stream = data;
+
+   if (stream->status == Z_STREAM_END) return EINA_TRUE;
+
+   stream->zstream.next_in = (Bytef *) clear;
+   stream->zstream.avail_in = clear_length;
+   stream->status = inflate(&stream->zstream, Z_NO_FLUSH);
+
+   if (stream->status == Z_STREAM_END) return EINA_TRUE;
+   if (stream->status == Z_BUF_ERROR && clear_length == 0) return EINA_TRUE;
+   if (stream->status != Z_OK) return EINA_FALSE;
+
+   /* all the input must fit in the output */
+   return stream->zstream.avail_in == 0;
+}
+
+static void *
+eet_read_into_alloc_cb(void *data, int size)
+{
+   Eet_Read_Into *into = data;
+
+   into->needed = size;
+   if (size > into->buffer_size) return NULL;
+   /* an empty entry needs no room, but NULL would abort the read */
+   if (!into->buffer) return into;
+   return into->buffer;
+}
+
+/* alloc_cb NULL means malloc, and that we own the result on error */
+static void *
+eet_internal_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key,
+			 Eet_Read_Alloc_Callback alloc_cb, void *alloc_data)
 {
    void			*data = NULL;
+   void			*tmp_data = NULL;
+   const void		*src;
    int			size = 0;
    Eet_File_Node	*efn;
 
@@ -1599,82 +2051,84 @@ eet_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *ciphe
    /* get size (uncompressed, if compressed at all) */
    size = efn->data_size;
 
-   /* allocate data */
-   data = malloc(size);
-   if (!data) goto on_error;
+   /* read straight from ram or from the mapping when we can */
+   src = eet_node_data_get(ef, efn);
+   if (!src)
+     {
+	tmp_data = malloc(efn->size);
+	if (!tmp_data) goto on_error;
+	if (!read_data_from_disk(ef, efn, tmp_data, efn->size))
+	  goto on_error;
+	src = tmp_data;
+     }
+
+   if (!eet_node_checksum_verify(ef, efn, src, EINA_FALSE))
+     goto on_error;
 
    /* uncompressed data */
    if (efn->compression == 0)
      {
-        void *data_deciphered = NULL;
-	unsigned int data_deciphered_sz = 0;
-	/* if we alreayd have the data in ram... copy that */
-	if (efn->data)
-	  memcpy(data, efn->data, efn->size);
-	else
-	  if (!read_data_from_disk(ef, efn, data, size))
-	    goto on_error;
         if (efn->ciphered && cipher_key)
 	  {
-	    if (eet_decipher(data, size, cipher_key, strlen(cipher_key), &data_deciphered, &data_deciphered_sz))
-	      {
-		if (data_deciphered) free(data_deciphered);
-		goto on_error;
-	      }
-	    free(data);
-	    data = data_deciphered;
-	    size = data_deciphered_sz;
+	     Eet_Read_Stream stream;
+
+	     /* the clear size is only known once the first window is
+	      * deciphered, that is when the memory is asked for */
+	     memset(&stream, 0, sizeof (Eet_Read_Stream));
+	     stream.alloc_cb = alloc_cb;
+	     stream.alloc_data = alloc_data;
+	     if (eet_decipher_stream(src, efn->size, cipher_key, strlen(cipher_key),
+				     eet_read_copy_cb, &stream))
+	       {
+		  data = stream.data;
+		  goto on_error;
+	       }
+	     data = stream.data;
+	     size = stream.length;
+	  }
+	else
+	  {
+	     data = alloc_cb ? alloc_cb(alloc_data, size) : malloc(size);
+	     if (!data) goto on_error;
+	     memcpy(data, src, efn->size < size ? efn->size : size);
 	  }
      }
    /* compressed data */
    else
      {
-	void	*tmp_data;
-	void	*data_deciphered = NULL;
-	unsigned int data_deciphered_sz = 0;
-	int	free_tmp = 0;
-	int	compr_size = efn->size;
 	uLongf	dlen;
 
-	/* if we already have the data in ram... copy that */
-	if (efn->data)
-	  tmp_data = efn->data;
-	else
+	data = alloc_cb ? alloc_cb(alloc_data, size) : malloc(size);
+	if (!data) goto on_error;
+
+	if (efn->ciphered && cipher_key)
 	  {
-	     tmp_data = malloc(compr_size);
-	     if (!tmp_data)
-	       goto on_error;
+	     Eet_Read_Stream stream;
 
-	     free_tmp = 1;
+	     /* decipher by window, each one directly inflated in place */
+	     memset(&stream, 0, sizeof (Eet_Read_Stream));
+	     stream.zstream.next_out = data;
+	     stream.zstream.avail_out = size;
+	     if (inflateInit(&stream.zstream) != Z_OK)
+	       goto on_error;
 
-	     if (!read_data_from_disk(ef, efn, tmp_data, compr_size))
+	     if (eet_decipher_stream(src, efn->size, cipher_key, strlen(cipher_key),
+				     eet_read_inflate_cb, &stream)
+		 || stream.status != Z_STREAM_END)
 	       {
-		  free(tmp_data);
+		  inflateEnd(&stream.zstream);
 		  goto on_error;
 	       }
+	     inflateEnd(&stream.zstream);
 	  }
-
-	if (efn->ciphered && cipher_key)
+	else
 	  {
-	    if (eet_decipher(tmp_data, compr_size, cipher_key, strlen(cipher_key), &data_deciphered, &data_deciphered_sz))
-	      {
-		if (free_tmp) free(tmp_data);
-		if (data_deciphered) free(data_deciphered);
-		goto on_error;
-	      }
-	    free(tmp_data);
-	    tmp_data = data_deciphered;
-	    compr_size = data_deciphered_sz;
+	     /* decompress it */
+	     dlen = size;
+	     if (uncompress((Bytef *)data, &dlen,
+			    (Bytef *)src, (uLongf)efn->size))
+	       goto on_error;
 	  }
-
-	/* decompress it */
-	dlen = size;
-	if (uncompress((Bytef *)data, &dlen,
-		 tmp_data, (uLongf)compr_size))
-	  goto on_error;
-
-	if (free_tmp)
-	  free(tmp_data);
      }
 
    /* fill in return values */
@@ -1683,14 +2137,69 @@ eet_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *ciphe
 
    UNLOCK_FILE(ef);
 
+   if (tmp_data) free(tmp_data);
+
    return data;
 
  on_error:
    UNLOCK_FILE(ef);
-   free(data);
+   if (tmp_data) free(tmp_data);
+   if (!alloc_cb) free(data);
    return NULL;
 }
 
+EAPI void *
+eet_read_cipher(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key)
+{
+   return eet_internal_read_cipher(ef, name, size_ret, cipher_key, NULL, NULL);
+}
+
+EAPI void *
+eet_read_cipher_alloc(Eet_File *ef, const char *name, int *size_ret, const char *cipher_key,
+		      Eet_Read_Alloc_Callback alloc_cb, void *data)
+{
+   if (!alloc_cb)
+     {
+	if (size_ret) *size_ret = 0;
+	return NULL;
+     }
+
+   return eet_internal_read_cipher(ef, name, size_ret, cipher_key, alloc_cb, data);
+}
+
+EAPI void *
+eet_read_alloc(Eet_File *ef, const char *name, int *size_ret,
+	       Eet_Read_Alloc_Callback alloc_cb, void *data)
+{
+   return eet_read_cipher_alloc(ef, name, size_ret, NULL, alloc_cb, data);
+}
+
+EAPI int
+eet_read_cipher_into(Eet_File *ef, const char *name, void *buffer, int buffer_size, const char *cipher_key)
+{
+   Eet_Read_Into into;
+   int size;
+
+   into.buffer = buffer;
+   into.buffer_size = buffer ? buffer_size : 0;
+   into.needed = 0;
+
+   if (eet_internal_read_cipher(ef, name, &size, cipher_key, eet_read_into_alloc_cb, &into))
+     return size;
+
+   /* too small, tell how much is needed */
+   if (into.needed > into.buffer_size)
+     return into.needed;
+
+   return -1;
+}
+
+EAPI int
+eet_read_into(Eet_File *ef, const char *name, void *buffer, int buffer_size)
+{
+   return eet_read_cipher_into(ef, name, buffer, buffer_size, NULL);
+}
+
 EAPI void *
 eet_read(Eet_File *ef, const char *name, int *size_ret)
 {
@@ -1740,6 +2249,9 @@ eet_read_direct(Eet_File *ef, const char *name, int *size_ret)
    else
      data = NULL;
 
+   if (data && !eet_node_checksum_verify(ef, efn, data, EINA_FALSE))
+     goto on_error;
+
    /* fill in return values */
    if (size_ret)
      *size_ret = size;
@@ -1875,6 +2387,8 @@ eet_write_cipher(Eet_File *ef, const char *name, const void *data, int size, int
 	  {
 	     free(efn->data);
 	     efn->ciphered = cipher_key ? 1 : 0;
+	     efn->checksummed = 0;
+	     efn->checksum_checked = 0;
 	     efn->compression = !!comp;
 	     efn->size = data_size;
 	     efn->data_size = size;
@@ -1900,6 +2414,8 @@ eet_write_cipher(Eet_File *ef, const char *name, const void *data, int size, int
 	ef->header->directory->nodes[hash] = efn;
 	efn->offset = -1;
 	efn->ciphered = cipher_key ? 1 : 0;
+	efn->checksummed = 0;
+	efn->checksum_checked = 0;
 	efn->compression = !!comp;
 	efn->size = data_size;
 	efn->data_size = size;
@@ -1980,6 +2496,20 @@ eet_delete(Eet_File *ef, const char *name)
    return exists_already;
 }
 
+void
+eet_file_borrow(Eet_File *ef, void *buffer)
+{
+   LOCK_CACHE;
+   ef->references++;
+   UNLOCK_CACHE;
+
+   if (!buffer) return ;
+
+   LOCK_FILE(ef);
+   ef->borrowed = eina_list_prepend(ef->borrowed, buffer);
+   UNLOCK_FILE(ef);
+}
+
 EAPI Eet_Dictionary *
 eet_dictionary_get(Eet_File *ef)
 {
@@ -2095,6 +2625,86 @@ eet_num_entries(Eet_File *ef)
    return ret;
 }
 
+EAPI Eet_Error
+eet_checksum_set(Eet_File *ef, Eina_Bool enabled)
+{
+   if (eet_check_pointer(ef))
+     return EET_ERROR_BAD_OBJECT;
+   if ((ef->mode != EET_FILE_MODE_WRITE) &&
+       (ef->mode != EET_FILE_MODE_READ_WRITE))
+     return EET_ERROR_NOT_WRITABLE;
+
+   LOCK_FILE(ef);
+
+   enabled = !!enabled;
+   if (ef->checksum != enabled)
+     {
+	ef->checksum = enabled;
+	/* the file needs to be written again to add or drop them */
+	ef->writes_pending = 1;
+     }
+
+   UNLOCK_FILE(ef);
+
+   return EET_ERROR_NONE;
+}
+
+EAPI void
+eet_checksum_verify_set(Eet_Checksum_Verify verify)
+{
+   eet_checksum_verify = verify;
+}
+
+EAPI Eet_Checksum_Verify
+eet_checksum_verify_get(void)
+{
+   return eet_checksum_verify;
+}
+
+EAPI Eet_Error
+eet_checksum_check(Eet_File *ef, const char *name)
+{
+   Eet_File_Node *efn;
+   const void *src;
+   void *tmp_data = NULL;
+   Eet_Error err = EET_ERROR_BAD_OBJECT;
+
+   if (eet_check_pointer(ef) || eet_check_header(ef) || !name)
+     return EET_ERROR_BAD_OBJECT;
+   if ((ef->mode != EET_FILE_MODE_READ) &&
+       (ef->mode != EET_FILE_MODE_READ_WRITE))
+     return EET_ERROR_BAD_OBJECT;
+
+   LOCK_FILE(ef);
+
+   efn = find_node_by_name(ef, name);
+   if (!efn) goto on_error;
+
+   err = EET_ERROR_NOT_CHECKSUMMED;
+   if (!efn->checksummed) goto on_error;
+
+   err = EET_ERROR_BAD_OBJECT;
+   src = eet_node_data_get(ef, efn);
+   if (!src)
+     {
+	tmp_data = malloc(efn->size);
+	if (!tmp_data) goto on_error;
+	if (!read_data_from_disk(ef, efn, tmp_data, efn->size))
+	  goto on_error;
+	src = tmp_data;
+     }
+
+   if (eet_node_checksum_verify(ef, efn, src, EINA_TRUE))
+     err = EET_ERROR_NONE;
+   else
+     err = EET_ERROR_CHECKSUM_FAILED;
+
+ on_error:
+   UNLOCK_FILE(ef);
+   if (tmp_data) free(tmp_data);
+   return err;
+}
+
 static Eet_File_Node *
 find_node_by_name(Eet_File *ef, const char *name)
 {
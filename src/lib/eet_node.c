@@ -346,7 +346,7 @@ eet_node_del(Eet_Node *n)
    eet_node_free(n);
 }
 
-static const char *eet_node_dump_g_name[6] = {
+const char *_eet_node_dump_g_name[6] = {
   "struct",
   "array",
   "var_array",
@@ -355,7 +355,7 @@ static const char *eet_node_dump_g_name[6] = {
   "???"
 };
 
-static const char *eet_node_dump_t_name[14][2] = {
+const char *_eet_node_dump_t_name[14][2] = {
   { "???: ", "???" },
   { "char: ", "%hhi" },
   { "short: ", "%hi" },
@@ -441,8 +441,8 @@ eet_node_dump_simple_type(Eet_Node *n, int level,
 #define EET_T_TYPE(Eet_Type, Type)					\
    case Eet_Type:							\
      {									\
-	dumpfunc(dumpdata, eet_node_dump_t_name[Eet_Type][0]);		\
-	snprintf(tbuf, sizeof (tbuf), eet_node_dump_t_name[Eet_Type][1], n->data.value.Type); \
+	dumpfunc(dumpdata, _eet_node_dump_t_name[Eet_Type][0]);		\
+	snprintf(tbuf, sizeof (tbuf), _eet_node_dump_t_name[Eet_Type][1], n->data.value.Type); \
 	dumpfunc(dumpdata, tbuf);					\
 	break;								\
      }
@@ -493,7 +493,7 @@ eet_node_dump_group_start(int level, void (*dumpfunc) (void *data, const char *s
    eet_node_dump_string_escape(dumpdata, dumpfunc, name);
    dumpfunc(dumpdata, "\" ");
 
-   dumpfunc(dumpdata, eet_node_dump_g_name[chnk_type - EET_G_UNKNOWN]);
+   dumpfunc(dumpdata, _eet_node_dump_g_name[chnk_type - EET_G_UNKNOWN]);
    dumpfunc(dumpdata, " {\n");
 }
 
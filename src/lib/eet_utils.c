@@ -7,8 +7,17 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
+#if defined(__ARM_FEATURE_CRC32)
+# include <arm_acle.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define EET_SWAP_NEON 1
+#endif
+
 #include "Eet.h"
 #include "Eet_private.h"
 
@@ -36,3 +45,203 @@ _eet_hash_gen(const char *key, int hash_size)
    return hash_num;
 }
 
+/*
+ * Bulk byte swapping, for the runs of fixed width values stored in little
+ * (data) or big (images) endian whatever the host is. The loops go through
+ * memcpy, so neither buffer needs to be aligned, and compilers turn them
+ * into vector code. NEON, which big endian ARM hosts have, gets it
+ * explicitly.
+ */
+void
+eet_swap16(void *dst, const void *src, unsigned int count)
+{
+   unsigned char *d = dst;
+   const unsigned char *s = src;
+
+#ifdef EET_SWAP_NEON
+   for (; count >= 8; count -= 8, s += 16, d += 16)
+     vst1q_u8(d, vrev16q_u8(vld1q_u8(s)));
+#endif
+
+   for (; count > 0; count--, s += 2, d += 2)
+     {
+	unsigned short v;
+
+	memcpy(&v, s, sizeof (v));
+	v = EET_BSWAP16(v);
+	memcpy(d, &v, sizeof (v));
+     }
+}
+
+void
+eet_swap32(void *dst, const void *src, unsigned int count)
+{
+   unsigned char *d = dst;
+   const unsigned char *s = src;
+
+#ifdef EET_SWAP_NEON
+   for (; count >= 4; count -= 4, s += 16, d += 16)
+     vst1q_u8(d, vrev32q_u8(vld1q_u8(s)));
+#endif
+
+   for (; count > 0; count--, s += 4, d += 4)
+     {
+	unsigned int v;
+
+	memcpy(&v, s, sizeof (v));
+	v = EET_BSWAP32(v);
+	memcpy(d, &v, sizeof (v));
+     }
+}
+
+void
+eet_swap64(void *dst, const void *src, unsigned int count)
+{
+   unsigned char *d = dst;
+   const unsigned char *s = src;
+
+#ifdef EET_SWAP_NEON
+   for (; count >= 2; count -= 2, s += 16, d += 16)
+     vst1q_u8(d, vrev64q_u8(vld1q_u8(s)));
+#endif
+
+   for (; count > 0; count--, s += 8, d += 8)
+     {
+	unsigned long long v;
+
+	memcpy(&v, s, sizeof (v));
+	v = EET_BSWAP64(v);
+	memcpy(d, &v, sizeof (v));
+     }
+}
+
+/* CRC32C (Castagnoli), slicing by 8 unless the cpu has an instruction for it */
+#define EET_CRC32C_POLY 0x82f63b78
+
+typedef unsigned int (*Eet_Crc32c_Update)(unsigned int crc, const unsigned char *p, unsigned int length);
+
+static unsigned int      eet_crc32c_table[8][256];
+static Eet_Crc32c_Update eet_crc32c_update = NULL;
+
+static unsigned int
+_eet_crc32c_table_update(unsigned int crc, const unsigned char *p, unsigned int length)
+{
+   while (length >= 8)
+     {
+	unsigned int lo;
+	unsigned int hi;
+
+	lo = (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24)) ^ crc;
+	hi = p[4] | (p[5] << 8) | (p[6] << 16) | ((unsigned int) p[7] << 24);
+
+	crc = eet_crc32c_table[7][lo & 0xff]
+	  ^ eet_crc32c_table[6][(lo >> 8) & 0xff]
+	  ^ eet_crc32c_table[5][(lo >> 16) & 0xff]
+	  ^ eet_crc32c_table[4][lo >> 24]
+	  ^ eet_crc32c_table[3][hi & 0xff]
+	  ^ eet_crc32c_table[2][(hi >> 8) & 0xff]
+	  ^ eet_crc32c_table[1][(hi >> 16) & 0xff]
+	  ^ eet_crc32c_table[0][hi >> 24];
+
+	p += 8;
+	length -= 8;
+     }
+
+   while (length--)
+     crc = eet_crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+   return crc;
+}
+
+#ifdef HAVE_CRC32C_SSE42
+__attribute__((target("sse4.2"))) static unsigned int
+_eet_crc32c_sse42_update(unsigned int crc, const unsigned char *p, unsigned int length)
+{
+# ifdef __x86_64__
+   unsigned long long crc64 = crc;
+
+   while (length >= 8)
+     {
+	unsigned long long v;
+
+	memcpy(&v, p, sizeof (v));
+	crc64 = __builtin_ia32_crc32di(crc64, v);
+	p += 8;
+	length -= 8;
+     }
+   crc = (unsigned int) crc64;
+# endif
+
+   while (length >= 4)
+     {
+	unsigned int v;
+
+	memcpy(&v, p, sizeof (v));
+	crc = __builtin_ia32_crc32si(crc, v);
+	p += 4;
+	length -= 4;
+     }
+
+   while (length--)
+     crc = __builtin_ia32_crc32qi(crc, *p++);
+
+   return crc;
+}
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+static unsigned int
+_eet_crc32c_armv8_update(unsigned int crc, const unsigned char *p, unsigned int length)
+{
+   while (length >= 8)
+     {
+	unsigned long long v;
+
+	memcpy(&v, p, sizeof (v));
+	crc = __crc32cd(crc, v);
+	p += 8;
+	length -= 8;
+     }
+
+   while (length--)
+     crc = __crc32cb(crc, *p++);
+
+   return crc;
+}
+#endif
+
+void
+eet_crc32c_init(void)
+{
+   unsigned int i;
+   unsigned int j;
+
+   for (i = 0; i < 256; ++i)
+     {
+	unsigned int crc = i;
+
+	for (j = 0; j < 8; ++j)
+	  crc = (crc & 1) ? (crc >> 1) ^ EET_CRC32C_POLY : crc >> 1;
+	eet_crc32c_table[0][i] = crc;
+     }
+
+   for (i = 0; i < 256; ++i)
+     for (j = 1; j < 8; ++j)
+       eet_crc32c_table[j][i] = (eet_crc32c_table[j - 1][i] >> 8)
+	 ^ eet_crc32c_table[0][eet_crc32c_table[j - 1][i] & 0xff];
+
+   eet_crc32c_update = _eet_crc32c_table_update;
+#ifdef HAVE_CRC32C_SSE42
+   if (__builtin_cpu_supports("sse4.2"))
+     eet_crc32c_update = _eet_crc32c_sse42_update;
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+   eet_crc32c_update = _eet_crc32c_armv8_update;
+#endif
+}
+
+unsigned int
+eet_crc32c(const void *data, unsigned int length)
+{
+   return ~eet_crc32c_update(0xffffffff, data, length);
+}
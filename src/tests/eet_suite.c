@@ -7,6 +7,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <utime.h>
 
 #include <check.h>
 
@@ -17,6 +18,7 @@
 #include <Eina.h>
 
 #include "eet_suite.h"
+#include "Eet_private.h"
 
 START_TEST(eet_test_init)
 {
@@ -556,6 +558,70 @@ START_TEST(eet_test_data_type_encoding_decoding)
 }
 END_TEST
 
+START_TEST(eet_test_data_stream)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Stream *ds;
+   Eet_Test_Ex_Type etbt;
+   Eet_Test_Ex_Type *result;
+   const char *data;
+   void *transfert;
+   int first;
+   int second;
+   int size;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "test";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert || size <= 0);
+
+   ds = eet_data_stream_new();
+   fail_if(!ds);
+
+   /* Two records back to back, each identical to a standalone encode. */
+   first = eet_data_descriptor_encode_stream(edd, &etbt, ds);
+   second = eet_data_descriptor_encode_stream(edd, &etbt, ds);
+   fail_if(first != size || second != size);
+
+   data = eet_data_stream_data_get(ds, &size);
+   fail_if(!data || size != first + second);
+   fail_if(memcmp(data, transfert, first) != 0);
+   fail_if(memcmp(data + first, transfert, second) != 0);
+
+   result = eet_data_descriptor_decode(edd, data + first, second);
+   fail_if(!result);
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(strcmp(result->charray[0], "test") != 0);
+
+   /* Reset keeps the buffer but starts over. */
+   eet_data_stream_reset(ds);
+   eet_data_stream_data_get(ds, &size);
+   fail_if(size != 0);
+   fail_if(eet_data_descriptor_encode_stream(edd, &etbt, ds) != first);
+
+   eet_data_stream_free(ds);
+   free(transfert);
+
+   eet_shutdown();
+}
+END_TEST
+
 static void
 append_string(void *data, const char *str)
 {
@@ -570,40 +636,1799 @@ append_string(void *data, const char *str)
    memcpy((*string) + length, str, strlen(str) + 1);
 }
 
-START_TEST(eet_test_data_type_dump_undump)
+START_TEST(eet_test_data_compact)
 {
    Eet_Data_Descriptor *edd;
-   Eet_Test_Ex_Type *result;
    Eet_Data_Descriptor_Class eddc;
    Eet_Test_Ex_Type etbt;
-   char *transfert1;
-   char *transfert2;
-   char *string1;
-   char *string2;
-   int size1;
-   int size2;
+   Eet_Test_Ex_Type *result;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   void *tagged;
+   void *compact;
+   char *broken;
+   int tagged_size;
+   int compact_size;
    int test;
+   int i;
+   int j;
 
    eet_init();
 
    _eet_test_ex_set(&etbt, 0);
    etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.slist = eina_list_prepend(NULL, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "test";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   tagged = eet_data_descriptor_encode(edd, &etbt, &tagged_size);
+   fail_if(!tagged);
+
+   fail_if(eet_data_descriptor_compact_get(edd));
+   eet_data_descriptor_compact_set(edd, EINA_TRUE);
+   fail_if(!eet_data_descriptor_compact_get(edd));
+
+   compact = eet_data_descriptor_encode(edd, &etbt, &compact_size);
+   fail_if(!compact);
+   fail_if(compact_size >= tagged_size);
+
+   /* Both encodings decode whatever the setting. */
+   for (i = 0; i < 2; ++i)
+     {
+	result = eet_data_descriptor_decode(edd, i ? tagged : compact, i ? tagged_size : compact_size);
+	fail_if(!result);
+
+	fail_if(_eet_test_ex_check(result, 0) != 0);
+	fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+	fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
+	fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+	fail_if(strcmp(result->charray[0], "test") != 0);
+	fail_if(result->charray[1] != NULL);
+
+	test = 0;
+	if (result->hash) eina_hash_foreach(result->hash, func, &test);
+	fail_if(test != 0);
+     }
+
+   /* A member chunk of another group type or larger than the member is
+    * refused. */
+   for (i = 0; i + 16 <= compact_size; i++)
+     if (!memcmp((char *)compact + i, "CHK", 3)
+	 && !memcmp((char *)compact + i + 8, "sarray1", 8))
+       break;
+   fail_if(i + 16 > compact_size);
+   for (j = 0; j + 13 <= compact_size; j++)
+     if (!memcmp((char *)compact + j, "CHK", 3)
+	 && !memcmp((char *)compact + j + 8, "list", 5))
+       break;
+   fail_if(j + 13 > compact_size);
+
+   broken = malloc(compact_size);
+   fail_if(!broken);
+
+   memcpy(broken, compact, compact_size);
+   broken[i + 3] = broken[j + 3];
+   fail_if(eet_data_descriptor_decode(edd, broken, compact_size) != NULL);
+
+   memcpy(broken, compact, compact_size);
+   memcpy(broken + i + 4, "\xfc\xff\xff\x7f", 4);
+   fail_if(eet_data_descriptor_decode(edd, broken, compact_size) != NULL);
+
+   free(broken);
+
+   /* Strings go to the dictionary in a file. */
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
+   fail_if(!result);
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(!eet_dictionary_string_check(eet_dictionary_get(ef), result->str));
+   eet_close(ef);
+
+   /* Another version of the descriptor refuses compact data. */
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Ex_Type, "plouf", uc, EET_T_UCHAR);
+   fail_if(eet_data_descriptor_decode(edd, compact, compact_size) != NULL);
+   fail_if(eet_data_descriptor_decode(edd, tagged, tagged_size) == NULL);
+
+   free(tagged);
+   free(compact);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+typedef struct _Eet_Test_Version1 Eet_Test_Version1;
+struct _Eet_Test_Version1
+{
+   int            i;
+   float          f;
+   const char    *s;
+   short          gone;
+   unsigned char  uc;
+   char           c;
+   Eina_List     *slist;
+   Eina_List     *old;
+};
+
+typedef struct _Eet_Test_Version2 Eet_Test_Version2;
+struct _Eet_Test_Version2
+{
+   unsigned int   added;
+   const char    *s;
+   Eina_List     *slist;
+   long long      i;
+   double         f;
+   unsigned int   uc;
+   int            c;
+   char          *old; /* was a list */
+};
+
+START_TEST(eet_test_data_previous_version)
+{
+   Eet_Data_Descriptor *edd1;
+   Eet_Data_Descriptor *edd2;
+   Eet_Data_Descriptor *other;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Version1 v1;
+   Eet_Test_Version2 layout;
+   Eet_Test_Version2 *v2;
+   void *blob;
+   int size;
+   int i;
+
+   eet_init();
+
+   memset(&v1, 0, sizeof (v1));
+   v1.i = -42;
+   v1.f = 0.5;
+   v1.s = "version";
+   v1.gone = 7;
+   v1.uc = 200;
+   v1.c = -5;
+   v1.slist = eina_list_append(NULL, "first");
+   v1.old = eina_list_append(NULL, "dropped");
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Version";
+   eddc.size = sizeof (Eet_Test_Version1);
+   edd1 = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd1);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "i", i, EET_T_INT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "f", f, EET_T_FLOAT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "s", s, EET_T_STRING);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "gone", gone, EET_T_SHORT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "uc", uc, EET_T_UCHAR);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd1, Eet_Test_Version1, "c", c, EET_T_CHAR);
+   eet_data_descriptor_element_add(edd1, "slist", EET_T_STRING, EET_G_LIST,
+				   (char *)(&(v1.slist)) - (char *)(&(v1)), 0, NULL, NULL);
+   eet_data_descriptor_element_add(edd1, "old", EET_T_STRING, EET_G_LIST,
+				   (char *)(&(v1.old)) - (char *)(&(v1)), 0, NULL, NULL);
+
+   eddc.size = sizeof (Eet_Test_Version2);
+   edd2 = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd2);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "added", added, EET_T_UINT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "s", s, EET_T_STRING);
+   eet_data_descriptor_element_add(edd2, "slist", EET_T_STRING, EET_G_LIST,
+				   (char *)(&(layout.slist)) - (char *)(&(layout)), 0, NULL, NULL);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "i", i, EET_T_LONG_LONG);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "f", f, EET_T_DOUBLE);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "uc", uc, EET_T_UINT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "c", c, EET_T_INT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "old", old, EET_T_STRING);
+   eet_data_descriptor_compact_set(edd2, EINA_TRUE);
+
+   eddc.name = "Eet_Test_Other";
+   other = eet_data_descriptor_stream_new(&eddc);
+   fail_if(eet_data_descriptor_previous_add(other, edd1));
+   eet_data_descriptor_free(other);
+
+   /* Tagged data first, then compact data once the version is known. */
+   for (i = 0; i < 2; i++)
+     {
+	eet_data_descriptor_compact_set(edd1, i);
+	blob = eet_data_descriptor_encode(edd1, &v1, &size);
+	fail_if(!blob);
+
+	if (i)
+	  {
+	     fail_if(eet_data_descriptor_decode(edd2, blob, size) != NULL);
+	     fail_if(!eet_data_descriptor_previous_add(edd2, edd1));
+	     fail_if(!eet_data_descriptor_previous_add(edd2, edd1));
+	  }
+
+	v2 = eet_data_descriptor_decode(edd2, blob, size);
+	fail_if(!v2);
+	fail_if(v2->added != 0);
+	fail_if(v2->i != -42);
+	fail_if(v2->f != 0.5);
+	fail_if(v2->uc != 200);
+	/* char is signed whatever the platform default */
+	fail_if(v2->c != -5);
+	fail_if(!v2->s || strcmp(v2->s, "version") != 0);
+	fail_if(eina_list_count(v2->slist) != 1);
+	fail_if(strcmp(eina_list_data_get(v2->slist), "first") != 0);
+	/* tagged data reads the items of the former list into the string */
+	fail_if(i && v2->old != NULL);
+
+	free(blob);
+     }
+
+   /* Members added afterward are mapped too. */
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd2, Eet_Test_Version2, "gone", added, EET_T_INT);
+   blob = eet_data_descriptor_encode(edd1, &v1, &size);
+   v2 = eet_data_descriptor_decode(edd2, blob, size);
+   fail_if(!v2);
+   fail_if(v2->added != 7);
+   fail_if(v2->i != -42);
+   free(blob);
+
+   eet_data_descriptor_free(edd1);
+   eet_data_descriptor_free(edd2);
+
+   eet_shutdown();
+}
+END_TEST
+
+typedef struct _Eet_Test_Packed Eet_Test_Packed;
+struct _Eet_Test_Packed
+{
+   float f[4];
+   short s[3];
+   unsigned int d_count;
+   double *d;
+};
+
+static Eet_Data_Descriptor *
+_eet_test_packed_descriptor(Eet_Data_Descriptor *implicit)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Packed etp;
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Packed";
+   eddc.size = sizeof(Eet_Test_Packed);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   eet_data_descriptor_element_add(edd, "f", EET_T_FLOAT, EET_G_ARRAY,
+				   (char *)(&(etp.f)) - (char *)(&(etp)),
+				   sizeof(etp.f)/sizeof(etp.f[0]), NULL, NULL);
+   eet_data_descriptor_element_add(edd, "s", EET_T_SHORT, EET_G_ARRAY,
+				   (char *)(&(etp.s)) - (char *)(&(etp)),
+				   sizeof(etp.s)/sizeof(etp.s[0]), NULL, NULL);
+   if (implicit)
+     {
+	EET_DATA_DESCRIPTOR_ADD_VAR_ARRAY(edd, Eet_Test_Packed, "d", d, implicit);
+     }
+   else
+     {
+	eet_data_descriptor_element_add(edd, "d", EET_T_DOUBLE, EET_G_VAR_ARRAY,
+					(char *)(&(etp.d)) - (char *)(&(etp)),
+					(char *)(&(etp.d_count)) - (char *)(&(etp)),
+					NULL, NULL);
+     }
+
+   return edd;
+}
+
+static void
+_eet_test_packed_check(const Eet_Test_Packed *a, const Eet_Test_Packed *b)
+{
+   fail_if(memcmp(a->f, b->f, sizeof(a->f)) != 0);
+   fail_if(memcmp(a->s, b->s, sizeof(a->s)) != 0);
+   fail_if(a->d_count != b->d_count);
+   fail_if(memcmp(a->d, b->d, a->d_count * sizeof(double)) != 0);
+}
+
+START_TEST(eet_test_data_packed_array)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *implicit;
+   Eet_Data_Descriptor *legacy;
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Packed etp;
+   Eet_Test_Packed *result;
+   char *string = NULL;
+   void *data;
+   void *undump;
+   int size;
+   int legacy_size;
+   unsigned int i;
+
+   eet_init();
+
+   etp.f[0] = 1.0; etp.f[1] = -0.5; etp.f[2] = 3.14159; etp.f[3] = 1e30;
+   etp.s[0] = -1; etp.s[1] = 0x1234; etp.s[2] = 7;
+   etp.d_count = 1000;
+   etp.d = malloc(sizeof (double) * etp.d_count);
+   fail_if(!etp.d);
+   for (i = 0; i < etp.d_count; i++)
+     etp.d[i] = i / 3.0;
+
+   edd = _eet_test_packed_descriptor(NULL);
+
+   data = eet_data_descriptor_encode(edd, &etp, &size);
+   fail_if(!data);
+   /* one chunk per array, not one per value */
+   fail_if(size > (int) (etp.d_count * sizeof (double)) + 200);
+
+   result = eet_data_descriptor_decode(edd, data, size);
+   fail_if(!result);
+   _eet_test_packed_check(&etp, result);
+
+   /* packed arrays go through text dump and undump */
+   eet_data_text_dump(data, size, append_string, &string);
+   fail_if(!string);
+
+   undump = eet_data_text_undump(string, strlen(string), &size);
+   fail_if(!undump);
+
+   result = eet_data_descriptor_decode(edd, undump, size);
+   fail_if(!result);
+   fail_if(memcmp(etp.s, result->s, sizeof(etp.s)) != 0);
+   fail_if(result->d_count != etp.d_count);
+
+   free(undump);
+   free(string);
+   free(data);
+
+   /* arrays written as one implicit structure per value still decode */
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "implicit";
+   eddc.size = sizeof(double);
+
+   implicit = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!implicit);
+   eet_data_descriptor_element_add(implicit, "double", EET_T_DOUBLE, EET_G_UNKNOWN,
+				   0, 0, NULL, NULL);
+   legacy = _eet_test_packed_descriptor(implicit);
+
+   data = eet_data_descriptor_encode(legacy, &etp, &legacy_size);
+   fail_if(!data);
+   fail_if(legacy_size <= size);
+
+   result = eet_data_descriptor_decode(edd, data, legacy_size);
+   fail_if(!result);
+   fail_if(result->d_count != etp.d_count);
+   for (i = 0; i < etp.d_count; i++)
+     fail_if(result->d[i] - etp.d[i] > 1e-9 || result->d[i] - etp.d[i] < -1e-9);
+
+   free(data);
+   free(etp.d);
+
+   eet_data_descriptor_free(legacy);
+   eet_data_descriptor_free(implicit);
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_swap)
+{
+   unsigned char src[8 * 11 + 1];
+   unsigned char dst[8 * 11 + 1];
+   unsigned int widths[3] = { 2, 4, 8 };
+   unsigned int w;
+   unsigned int i;
+   unsigned int j;
+
+   for (i = 0; i < sizeof (src); i++)
+     src[i] = i * 7 + 1;
+
+   for (w = 0; w < 3; w++)
+     {
+	unsigned int width = widths[w];
+	/* a full vector and a tail whatever the width */
+	unsigned int count = 16 / width + 3;
+
+	/* unaligned on both sides */
+	memset(dst, 0, sizeof (dst));
+	switch (width)
+	  {
+	   case 2: eet_swap16(dst + 1, src + 1, count); break;
+	   case 4: eet_swap32(dst + 1, src + 1, count); break;
+	   default: eet_swap64(dst + 1, src + 1, count); break;
+	  }
+
+	for (i = 0; i < count; i++)
+	  for (j = 0; j < width; j++)
+	    fail_if(dst[1 + i * width + j] != src[1 + i * width + width - 1 - j]);
+	/* nothing written past the last value */
+	fail_if(dst[1 + count * width] != 0);
+
+	/* in place, twice gives the values back */
+	memcpy(dst, src, sizeof (src));
+	switch (width)
+	  {
+	   case 2: eet_swap16(dst + 1, dst + 1, count); eet_swap16(dst + 1, dst + 1, count); break;
+	   case 4: eet_swap32(dst + 1, dst + 1, count); eet_swap32(dst + 1, dst + 1, count); break;
+	   default: eet_swap64(dst + 1, dst + 1, count); eet_swap64(dst + 1, dst + 1, count); break;
+	  }
+	fail_if(memcmp(dst, src, sizeof (src)) != 0);
+     }
+}
+END_TEST
+
+typedef struct _Eet_Test_Row Eet_Test_Row;
+struct _Eet_Test_Row
+{
+   int id;
+   char level;
+   const char *tag;
+   double value;
+   float ratio;
+   Eina_List *notes;
+};
+
+typedef struct _Eet_Test_Row_Value Eet_Test_Row_Value;
+struct _Eet_Test_Row_Value
+{
+   long long id;
+   double value;
+};
+
+typedef struct _Eet_Test_Table Eet_Test_Table;
+struct _Eet_Test_Table
+{
+   Eina_List *rows;
+   Eet_Test_Row *arr;
+   int arr_count;
+   Eet_Test_Row fixed[3];
+};
+
+typedef struct _Eet_Test_Table_Value Eet_Test_Table_Value;
+struct _Eet_Test_Table_Value
+{
+   Eina_List *rows;
+   Eet_Test_Row_Value *arr;
+   int arr_count;
+};
+
+static Eet_Data_Descriptor *
+_eet_test_table_descriptor(Eet_Data_Descriptor **row)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Row etr;
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Row";
+   eddc.size = sizeof(Eet_Test_Row);
+
+   *row = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!*row);
+
+   EET_DATA_DESCRIPTOR_ADD_BASIC(*row, Eet_Test_Row, "id", id, EET_T_INT);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(*row, Eet_Test_Row, "level", level, EET_T_CHAR);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(*row, Eet_Test_Row, "tag", tag, EET_T_STRING);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(*row, Eet_Test_Row, "value", value, EET_T_DOUBLE);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(*row, Eet_Test_Row, "ratio", ratio, EET_T_FLOAT);
+   eet_data_descriptor_element_add(*row, "notes", EET_T_STRING, EET_G_LIST,
+				   (char *)(&(etr.notes)) - (char *)(&(etr)),
+				   0, NULL, NULL);
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Table";
+   eddc.size = sizeof(Eet_Test_Table);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   EET_DATA_DESCRIPTOR_ADD_LIST(edd, Eet_Test_Table, "rows", rows, *row);
+   EET_DATA_DESCRIPTOR_ADD_VAR_ARRAY(edd, Eet_Test_Table, "arr", arr, *row);
+   EET_DATA_DESCRIPTOR_ADD_ARRAY(edd, Eet_Test_Table, "fixed", fixed, *row);
+
+   return edd;
+}
+
+static void
+_eet_test_row_set(Eet_Test_Row *etr, int i)
+{
+   static const char *tags[] = { "red", "green", NULL, "blue" };
+
+   etr->id = 1000 + i * 3;
+   etr->level = i / 10;
+   etr->tag = tags[i % 4];
+   etr->value = i * 0.25 - 7;
+   etr->ratio = 1.0f / (i + 1);
+   etr->notes = NULL;
+   if (i % 7 == 0)
+     etr->notes = eina_list_append(etr->notes, "seventh");
+}
+
+static void
+_eet_test_row_check(const Eet_Test_Row *etr, int i)
+{
+   Eet_Test_Row expected;
+
+   _eet_test_row_set(&expected, i);
+   fail_if(etr->id != expected.id);
+   fail_if(etr->level != expected.level);
+   if (expected.tag)
+     fail_if(!etr->tag || strcmp(etr->tag, expected.tag) != 0);
+   else
+     fail_if(etr->tag != NULL);
+   fail_if(etr->value != expected.value);
+   fail_if(etr->ratio != expected.ratio);
+   fail_if(eina_list_count(etr->notes) != eina_list_count(expected.notes));
+   if (expected.notes)
+     fail_if(strcmp(eina_list_data_get(etr->notes), "seventh") != 0);
+   eina_list_free(expected.notes);
+}
+
+START_TEST(eet_test_data_columnar)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_Data_Descriptor *row;
+   Eet_Data_Descriptor *value_edd;
+   Eet_Data_Descriptor *value_row;
+   Eet_Test_Table ett;
+   Eet_Test_Table *result;
+   Eet_Test_Table_Value *values;
+   Eet_Test_Row_Value *rv;
+   Eet_Test_Row *etr;
+   Eina_List *l;
+   char *string = NULL;
+   void *data;
+   int tagged_size;
+   int size;
+   int i;
+
+   eet_init();
+
+   edd = _eet_test_table_descriptor(&row);
+
+   memset(&ett, 0, sizeof (ett));
+   for (i = 0; i < 500; i++)
+     {
+	etr = malloc(sizeof (Eet_Test_Row));
+	fail_if(!etr);
+	_eet_test_row_set(etr, i);
+	ett.rows = eina_list_append(ett.rows, etr);
+     }
+   ett.arr_count = 200;
+   ett.arr = calloc(ett.arr_count, sizeof (Eet_Test_Row));
+   fail_if(!ett.arr);
+   for (i = 0; i < ett.arr_count; i++)
+     _eet_test_row_set(ett.arr + i, i);
+   for (i = 0; i < 3; i++)
+     _eet_test_row_set(ett.fixed + i, i);
+
+   data = eet_data_descriptor_encode(edd, &ett, &tagged_size);
+   fail_if(!data);
+   free(data);
+
+   fail_if(eet_data_descriptor_columnar_get(row));
+   eet_data_descriptor_columnar_set(row, EINA_TRUE);
+   fail_if(!eet_data_descriptor_columnar_get(row));
+
+   data = eet_data_descriptor_encode(edd, &ett, &size);
+   fail_if(!data);
+   fail_if(size * 2 > tagged_size);
+
+   result = eet_data_descriptor_decode(edd, data, size);
+   fail_if(!result);
+   fail_if(eina_list_count(result->rows) != 500);
+   i = 0;
+   EINA_LIST_FOREACH(result->rows, l, etr)
+     _eet_test_row_check(etr, i++);
+   fail_if(result->arr_count != 200);
+   for (i = 0; i < result->arr_count; i++)
+     _eet_test_row_check(result->arr + i, i);
+   for (i = 0; i < 3; i++)
+     _eet_test_row_check(result->fixed + i, i);
+
+   /* columns need their descriptor */
+   fail_if(eet_data_text_dump(data, size, append_string, &string));
+   free(string);
+   fail_if(eet_data_node_decode_cipher(data, NULL, size) != NULL);
+
+   /* a descriptor with some of the members only reads their columns */
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Row";
+   eddc.size = sizeof(Eet_Test_Row_Value);
+
+   value_row = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!value_row);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(value_row, Eet_Test_Row_Value, "id", id, EET_T_LONG_LONG);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(value_row, Eet_Test_Row_Value, "value", value, EET_T_DOUBLE);
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Table";
+   eddc.size = sizeof(Eet_Test_Table_Value);
+
+   value_edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!value_edd);
+   EET_DATA_DESCRIPTOR_ADD_LIST(value_edd, Eet_Test_Table_Value, "rows", rows, value_row);
+   EET_DATA_DESCRIPTOR_ADD_VAR_ARRAY(value_edd, Eet_Test_Table_Value, "arr", arr, value_row);
+
+   values = eet_data_descriptor_decode(value_edd, data, size);
+   fail_if(!values);
+   fail_if(eina_list_count(values->rows) != 500);
+   i = 0;
+   EINA_LIST_FOREACH(values->rows, l, rv)
+     {
+	fail_if(rv->id != 1000 + i * 3);
+	fail_if(rv->value != i * 0.25 - 7);
+	i++;
+     }
+   fail_if(values->arr_count != 200);
+   fail_if(values->arr[199].id != 1000 + 199 * 3);
+
+   /* broken columns are refused */
+   for (i = size / 2; i < size; i += 97)
+     {
+	char *broken;
+
+	broken = malloc(size);
+	fail_if(!broken);
+	memcpy(broken, data, size);
+	broken[i] ^= 0x5A;
+	eet_data_descriptor_decode(edd, broken, size);
+	free(broken);
+     }
+
+   free(data);
+
+   /* rows that no column holds aren't allocated on trust */
+   EINA_LIST_FREE(ett.rows, etr)
+     {
+	eina_list_free(etr->notes);
+	free(etr);
+     }
+   etr = malloc(sizeof (Eet_Test_Row));
+   fail_if(!etr);
+   _eet_test_row_set(etr, 1);
+   ett.rows = eina_list_append(NULL, etr);
+   ett.arr_count = 0;
+
+   data = eet_data_descriptor_encode(edd, &ett, &size);
+   fail_if(!data);
+
+   for (i = 0; i + 6 <= size; i++)
+     if (!memcmp((char *)data + i, "COL\1\1", 5))
+       break;
+   fail_if(i + 6 > size);
+   ((char *)data)[i + 4] = 0x7f;
+   ((char *)data)[i + 5] = 0;
+   fail_if(eet_data_descriptor_decode(edd, data, size) != NULL);
+
+   free(data);
+
+   eet_data_descriptor_free(value_edd);
+   eet_data_descriptor_free(value_row);
+   eet_data_descriptor_free(edd);
+   eet_data_descriptor_free(row);
+
+   eet_shutdown();
+}
+END_TEST
+
+typedef struct _Eet_Test_Ieee Eet_Test_Ieee;
+struct _Eet_Test_Ieee
+{
+   float f;
+   double d;
+   Eina_List *fl;
+};
+
+static Eet_Data_Descriptor *
+_eet_test_ieee_descriptor(int d_type)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ieee eti;
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ieee";
+   eddc.size = sizeof(Eet_Test_Ieee);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Ieee, "f", f, EET_T_FLOAT);
+   eet_data_descriptor_element_add(edd, "d", d_type, EET_G_UNKNOWN,
+				   (char *)(&(eti.d)) - (char *)(&(eti)),
+				   0, NULL, NULL);
+   eet_data_descriptor_element_add(edd, "fl", EET_T_FLOAT, EET_G_LIST,
+				   (char *)(&(eti.fl)) - (char *)(&(eti)),
+				   0, NULL, NULL);
+
+   return edd;
+}
+
+static void
+_eet_test_ieee_free(Eet_Test_Ieee *eti)
+{
+   float *f;
+
+   EINA_LIST_FREE(eti->fl, f)
+     free(f);
+   free(eti);
+}
+
+START_TEST(eet_test_data_float_ieee)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Data_Descriptor *text;
+   Eet_Data_Descriptor *fp;
+   Eet_Test_Ieee eti;
+   Eet_Test_Ieee *result;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   char *string = NULL;
+   Eina_F32p32 fp32;
+   float f = 1.0f / 3.0f;
+   void *data;
+   int size;
+
+   eet_init();
+
+   eti.f = 2.0f / 3.0f;
+   eti.d = 1.0 / 3.0;
+   eti.fl = eina_list_append(NULL, &f);
+
+   edd = _eet_test_ieee_descriptor(EET_T_DOUBLE);
+   text = _eet_test_ieee_descriptor(EET_T_DOUBLE);
+
+   fail_if(eet_data_descriptor_float_ieee_get(edd));
+   eet_data_descriptor_float_ieee_set(edd, EINA_TRUE);
+   fail_if(!eet_data_descriptor_float_ieee_get(edd));
+
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, "ieee", &eti, 0));
+   fail_if(!eet_data_write(ef, text, "text", &eti, 0));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   /* the values come back bit for bit, whatever the reader setting */
+   result = eet_data_read(ef, edd, "ieee");
+   fail_if(!result);
+   fail_if(result->f != eti.f);
+   fail_if(result->d != eti.d);
+   fail_if(eina_list_count(result->fl) != 1);
+   fail_if(*(float *)eina_list_data_get(result->fl) != f);
+   _eet_test_ieee_free(result);
+
+   result = eet_data_read(ef, text, "ieee");
+   fail_if(!result);
+   fail_if(result->d != eti.d);
+   _eet_test_ieee_free(result);
+
+   /* text encoded floating points still decode */
+   result = eet_data_read(ef, edd, "text");
+   fail_if(!result);
+   fail_if(result->f - eti.f > 1e-6 || result->f - eti.f < -1e-6);
+   fail_if(eina_list_count(result->fl) != 1);
+   _eet_test_ieee_free(result);
+
+   /* and convert to the member type, the fixed point lands where d is */
+   fp = _eet_test_ieee_descriptor(EET_T_F32P32);
+   result = eet_data_read(ef, fp, "ieee");
+   fail_if(!result);
+   memcpy(&fp32, &result->d, sizeof (fp32));
+   fail_if(fp32 != eina_f32p32_double_from(eti.d));
+   _eet_test_ieee_free(result);
+
+   eet_close(ef);
+
+   data = eet_data_descriptor_encode(edd, &eti, &size);
+   fail_if(!data);
+   eet_data_text_dump(data, size, append_string, &string);
+   fail_if(!string);
+   fail_if(!strstr(string, "double: "));
+
+   free(string);
+   free(data);
+   eina_list_free(eti.fl);
+
+   eet_data_descriptor_free(fp);
+   eet_data_descriptor_free(text);
+   eet_data_descriptor_free(edd);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_data_lazy)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   Eet_Data_Lazy *lazy;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   void *transfert;
+   int size;
+   int test;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.slist = eina_list_prepend(NULL, "test");
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert || size <= 0);
+
+   lazy = eet_data_descriptor_decode_lazy(edd, transfert, size);
+   fail_if(!lazy);
+   result = eet_data_lazy_data_get(lazy);
+   fail_if(!result);
+
+   /* Only the simple members are there. */
+   fail_if(result->i != EET_TEST_INT);
+   fail_if(strcmp(result->str, EET_TEST_STRING) != 0);
+   fail_if(result->sarray2[1] != 43);
+   fail_if(result->list || result->hash || result->slist);
+   fail_if(result->varray1 || result->varray1_count);
+
+   fail_if(!eet_data_lazy_member_decode(lazy, "list"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "hash"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "slist"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "varray1"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "varray2"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "list"));
+   fail_if(!eet_data_lazy_member_decode(lazy, "i"));
+   eet_data_lazy_free(lazy);
+   free(transfert);
+
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(eina_list_count(result->list) != 2);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+   test = 0;
+   eina_hash_foreach(result->hash, func, &test);
+   fail_if(test != 0);
+
+   /* From a compressed entry. */
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 1));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   lazy = eet_data_read_lazy(ef, edd, EET_TEST_FILE_KEY1);
+   eet_close(ef);
+   fail_if(!lazy);
+
+   result = eet_data_lazy_data_get(lazy);
+   fail_if(result->list);
+   fail_if(!eet_data_lazy_member_decode(lazy, "list"));
+   eet_data_lazy_free(lazy);
+
+   fail_if(eina_list_count(result->list) != 2);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+static Eina_Bool
+_eet_test_block_cb(__UNUSED__ const Eet_Data_Block *block, int index, void *data, void *fdata)
+{
+   int *count = fdata;
+
+   fail_if(index != *count);
+   _eet_test_basic_check(data, index + 1);
+   free(data);
+   (*count)++;
+
+   return EINA_TRUE;
+}
+
+START_TEST(eet_test_data_block)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Basic_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Basic_Type etbt;
+   Eet_Data_Block *block;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   int count;
+   int i;
+
+   eet_init();
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Basic_Type";
+   eddc.size = sizeof(Eet_Test_Basic_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_basic_descriptor(edd);
+
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+
+   block = eet_data_block_new(ef, edd);
+   fail_if(!block);
+   for (i = 1; i <= 100; i++)
+     {
+	_eet_test_basic_set(&etbt, i);
+	fail_if(!eet_data_block_append(block, &etbt));
+     }
+   fail_if(eet_data_block_count_get(block) != 100);
+
+   /* Records are there before the block is written. */
+   result = eet_data_block_record_get(block, 41);
+   fail_if(!result);
+   _eet_test_basic_check(result, 42);
+   free(result);
+
+   fail_if(!eet_data_block_write(block, EET_TEST_FILE_KEY1, 1));
+   eet_data_block_free(block);
+
+   _eet_test_basic_set(&etbt, 1);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY2, &etbt, 1));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   fail_if(eet_data_block_new(ef, edd) != NULL);
+   fail_if(eet_data_block_read(ef, edd, EET_TEST_FILE_KEY2) != NULL);
+
+   block = eet_data_block_read(ef, edd, EET_TEST_FILE_KEY1);
+   fail_if(!block);
+   eet_close(ef);
+
+   fail_if(eet_data_block_count_get(block) != 100);
+   fail_if(eet_data_block_append(block, &etbt));
+   fail_if(eet_data_block_record_get(block, 100) != NULL);
+
+   result = eet_data_block_record_get(block, 99);
+   fail_if(!result);
+   _eet_test_basic_check(result, 100);
+   free(result);
+
+   count = 0;
+   fail_if(!eet_data_block_foreach(block, _eet_test_block_cb, &count));
+   fail_if(count != 100);
+
+   eet_data_block_free(block);
+
+   fail_if(unlink(file) != 0);
+
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+#define EET_TEST_MANY 300
+
+typedef struct _Eet_Test_Many Eet_Test_Many;
+struct _Eet_Test_Many
+{
+   int v[EET_TEST_MANY];
+};
+
+static char eet_test_many_names[EET_TEST_MANY][8];
+
+static Eet_Data_Descriptor *
+_eet_test_many_descriptor(Eina_Bool reverse)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   int i;
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Many";
+   eddc.size = sizeof(Eet_Test_Many);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   for (i = 0; i < EET_TEST_MANY; ++i)
+     {
+	int j = reverse ? EET_TEST_MANY - 1 - i : i;
+
+	snprintf(eet_test_many_names[j], sizeof (eet_test_many_names[j]), "m%i", j);
+	eet_data_descriptor_element_add(edd, eet_test_many_names[j], EET_T_INT, EET_G_UNKNOWN,
+					j * sizeof (int), 0, NULL, NULL);
+     }
+
+   return edd;
+}
+
+START_TEST(eet_test_data_many_members)
+{
+   Eet_Data_Descriptor *edd_in;
+   Eet_Data_Descriptor *edd_out;
+   Eet_Test_Many etm;
+   Eet_Test_Many *result;
+   void *transfert;
+   int size;
+   int i;
+
+   eet_init();
+
+   for (i = 0; i < EET_TEST_MANY; ++i)
+     etm.v[i] = i * 7;
+
+   /* Written in the opposite order, every member is looked up by name. */
+   edd_in = _eet_test_many_descriptor(EINA_FALSE);
+   edd_out = _eet_test_many_descriptor(EINA_TRUE);
+
+   transfert = eet_data_descriptor_encode(edd_in, &etm, &size);
+   fail_if(!transfert || size <= 0);
+
+   result = eet_data_descriptor_decode(edd_out, transfert, size);
+   fail_if(!result);
+   for (i = 0; i < EET_TEST_MANY; ++i)
+     fail_if(result->v[i] != i * 7);
+
+   free(result);
+   free(transfert);
+   eet_data_descriptor_free(edd_in);
+   eet_data_descriptor_free(edd_out);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_data_decode_error)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   char *transfert;
+   int size;
+   int i;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.slist = eina_list_prepend(NULL, "test");
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert || size <= 0);
+
+   /* Break the last chunk, everything decoded before it is rolled back. */
+   for (i = size - 3; i > 0; --i)
+     if (!memcmp(transfert + i, "CHK", 3))
+       break ;
+   fail_if(i <= 0);
+   transfert[i] = 'X';
+
+   fail_if(eet_data_descriptor_decode(edd, transfert, size) != NULL);
+
+   free(transfert);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_data_type_dump_undump)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   char *transfert1;
+   char *transfert2;
+   char *string1;
+   char *string2;
+   int size1;
+   int size2;
+   int test;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY2, _eet_test_ex_set(NULL, 2));
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.ihash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
+   etbt.ihash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.ihash, EET_TEST_KEY2, &i7);
+   etbt.slist = eina_list_prepend(NULL, "test");
+   etbt.shash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.shash, EET_TEST_KEY1, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "test";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert1 = eet_data_descriptor_encode(edd, &etbt, &size1);
+   fail_if(!transfert1 || size1 <= 0);
+
+   string1 = NULL;
+   eet_data_text_dump(transfert1, size1, append_string, &string1);
+   fail_if(!string1);
+
+   transfert2 = eet_data_text_undump(string1, string1 ? strlen(string1) : 0, &size2);
+   fail_if(!transfert2 && size2 <= 0);
+
+   string2 = NULL;
+   eet_data_text_dump(transfert2, size2, append_string, &string2);
+   fail_if(!string2);
+
+   fail_if(strlen(string2) != strlen(string1));
+
+   result = eet_data_descriptor_decode(edd, transfert2, size2);
+   fail_if(!result);
+
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(eina_list_data_get(result->ilist) == NULL);
+   fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
+   fail_if(eina_list_data_get(result->slist) == NULL);
+   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+   fail_if(eina_hash_find(result->shash, EET_TEST_KEY1) == NULL);
+   fail_if(strcmp(eina_hash_find(result->shash, EET_TEST_KEY1), "test") != 0);
+   fail_if(strcmp(result->charray[0], "test") != 0);
+
+   test = 0;
+   if (result->hash) eina_hash_foreach(result->hash, func, &test);
+   fail_if(test != 0);
+   if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
+   fail_if(test != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+typedef struct _Eet_Test_Dump Eet_Test_Dump;
+struct _Eet_Test_Dump
+{
+   char *string;
+   int calls;
+};
+
+static void
+append_block(void *data, const char *str)
+{
+   Eet_Test_Dump *dump = data;
+
+   dump->calls++;
+   append_string(&dump->string, str);
+}
+
+START_TEST(eet_test_data_text_dump_stream)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   Eet_Test_Dump dump;
+   const char *s;
+   void *transfert;
+   int size;
+   int lists;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.slist = eina_list_prepend(NULL, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "a\n\"b\"";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert);
+
+   memset(&dump, 0, sizeof (dump));
+   fail_if(eet_data_text_dump(transfert, size, append_block, &dump) != 1);
+   fail_if(!dump.string);
+   free(transfert);
+
+   /* The text comes in large blocks, not token by token. */
+   fail_if(dump.calls * 1024 > (int) strlen(dump.string));
+
+   /* Items of a list share one group. */
+   for (lists = 0, s = dump.string; (s = strstr(s, "group \"list\" list {")); s++)
+     lists++;
+   fail_if(lists != 1);
+   fail_if(!strstr(dump.string, "string: \"a\\n\\\"b\\\"\";"));
+
+   transfert = eet_data_text_undump(dump.string, strlen(dump.string), &size);
+   fail_if(!transfert);
+
+   result = eet_data_descriptor_decode(edd, transfert, size);
+   fail_if(!result);
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(eina_list_count(result->list) != 2);
+   fail_if(strcmp(result->charray[0], "a\n\"b\"") != 0);
+   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+
+   free(transfert);
+   free(dump.string);
+
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_data_text_undump_parse)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Basic_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   const char *text =
+     "group \"Eet_Test_Basic_Type\" struct {\n"
+     "    value \"str\" null;\n"
+     "    value \"i\" int: 0x2a;\n"
+     "    value \"istr\" inlined: \"a\\\\b\\n\";\n"
+     "    group \"with\" struct {\n"
+     "        group \"Eet_Test_Basic_Type\" struct {\n"
+     "            value \"ul\" ulong_long: 18446744073709551615;\n"
+     "        }\n"
+     "    }\n"
+     "}\n";
+   const char *broken[] = {
+     "group \"a\" struct {\n    value \"i\" int: 1;\n",
+     "group \"a\" struct {\n    value \"i\" int: one;\n}\n",
+     "group \"a\" struct {\n    value \"s\" string: \"open;\n}\n",
+     "group \"a\" struct {\n    value \"i\" word: 1;\n}\n",
+     "group \"a\" hash {\n    value \"i\" int: 1;\n}\n",
+     "group \"a\" struct {\n}\n}\n",
+     "group \"a\" struct {\n    group \"v\" array {\n        count 2;\n"
+     "        value \"v\" int: 1;\n        value \"v\" string: \"b\";\n    }\n}\n",
+     "group \"a\" struct {\n    group \"v\" array {\n        count 2;\n"
+     "        value \"v\" int: 1;\n        group \"v\" struct {\n        }\n    }\n}\n",
+     ""
+   };
+   void *transfert;
+   unsigned int i;
+   int size;
+
+   eet_init();
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Basic_Type";
+   eddc.size = sizeof(Eet_Test_Basic_Type);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_basic_descriptor(edd);
+
+   /* A null value has no token of its own, the next line is still read. */
+   transfert = eet_data_text_undump(text, strlen(text), &size);
+   fail_if(!transfert);
+
+   result = eet_data_descriptor_decode(edd, transfert, size);
+   fail_if(!result);
+   fail_if(result->str != NULL);
+   fail_if(result->i != 42);
+   fail_if(strcmp(result->istr, "a\\b\n") != 0);
+   fail_if(!result->with);
+   fail_if(result->with->ul != 18446744073709551615ULL);
+
+   free(result->with);
+   free(result);
+   free(transfert);
+
+   for (i = 0; i < sizeof (broken) / sizeof (broken[0]); i++)
+     fail_if(eet_data_text_undump(broken[i], strlen(broken[i]), &size) != NULL);
+
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_test_data_json_dump_undump)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   Eet_Test_Dump dump;
+   const char *broken[] = {
+     "{\"int\": 1}",
+     "{\"struct\": {\"a\": {\"i\": {\"int\": 1.5}}}}",
+     "{\"struct\": {\"a\": {\"s\": {\"string\": \"\\q\"}}}}",
+     "{\"struct\": {\"a\": {\"i\": {\"int\": 1},}}}",
+     "{\"struct\": {\"a\": {}}} {}",
+     ""
+   };
+   void *transfert;
+   unsigned int i;
+   int size;
+   int test;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.slist = eina_list_prepend(NULL, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[1] = "tab\t\"quoted\"";
+   etbt.charray[5] = "plouf";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_stream_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert);
+
+   memset(&dump, 0, sizeof (dump));
+   fail_if(eet_data_json_dump(transfert, size, append_block, &dump) != 1);
+   fail_if(!dump.string);
+   free(transfert);
+
+   fail_if(strncmp(dump.string, "{\"struct\": {\"Eet_Test_Ex_Type\": {", 33) != 0);
+   fail_if(!strstr(dump.string, "{\"string\": \"tab\\t\\\"quoted\\\"\"}"));
+
+   transfert = eet_data_json_undump(dump.string, strlen(dump.string), &size);
+   fail_if(!transfert);
+
+   result = eet_data_descriptor_decode(edd, transfert, size);
+   fail_if(!result);
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+
+   /* Nulls keep their place in arrays. */
+   fail_if(result->charray[0] != NULL);
+   fail_if(strcmp(result->charray[1], "tab\t\"quoted\"") != 0);
+   fail_if(strcmp(result->charray[5], "plouf") != 0);
+
+   test = 0;
+   fail_if(!result->hash);
+   eina_hash_foreach(result->hash, func, &test);
+   fail_if(test != 0);
+
+   free(transfert);
+   free(dump.string);
+
+   for (i = 0; i < sizeof (broken) / sizeof (broken[0]); i++)
+     fail_if(eet_data_json_undump(broken[i], strlen(broken[i]), &size) != NULL);
+
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+static void *
+_eet_test_alloc(void *data, int size)
+{
+   fail_if(size > 64);
+   return data;
+}
+
+START_TEST(eet_file_simple_write)
+{
+   const char *buffer = "Here is a string of data to save !";
+   char into[64];
+   Eet_File *ef;
+   char *test;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   int size;
+
+   eet_init();
+
+   fail_if(!(file = tmpnam(file)));
+
+   fail_if(eet_mode_get(NULL) != EET_FILE_MODE_INVALID);
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_write(ef, "keys/tests", buffer, strlen(buffer) + 1, 1));
+
+   fail_if(eet_mode_get(ef) != EET_FILE_MODE_WRITE);
+
+   fail_if(eet_list(ef, "*", &size) != NULL);
+   fail_if(eet_num_entries(ef) != -1);
+
+   eet_close(ef);
+
+   /* Test read of simple file */
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   test = eet_read(ef, "keys/tests", &size);
+   fail_if(!test);
+   fail_if(size != (int) strlen(buffer) + 1);
+
+   fail_if(memcmp(test, buffer, strlen(buffer) + 1) != 0);
+
+   fail_if(eet_mode_get(ef) != EET_FILE_MODE_READ);
+   fail_if(eet_num_entries(ef) != 1);
+
+   /* Test read into a caller buffer */
+   fail_if(eet_read_into(ef, "keys/tests", NULL, 0) != (int) strlen(buffer) + 1);
+   fail_if(eet_read_into(ef, "keys/tests", into, 4) != (int) strlen(buffer) + 1);
+   fail_if(eet_read_into(ef, "keys/tests", into, sizeof (into)) != (int) strlen(buffer) + 1);
+   fail_if(memcmp(into, buffer, strlen(buffer) + 1) != 0);
+   fail_if(eet_read_into(ef, "keys/none", into, sizeof (into)) != -1);
+
+   memset(into, 0, sizeof (into));
+   fail_if(eet_read_alloc(ef, "keys/tests", &size, _eet_test_alloc, into) != into);
+   fail_if(size != (int) strlen(buffer) + 1);
+   fail_if(memcmp(into, buffer, strlen(buffer) + 1) != 0);
+
+   eet_close(ef);
+
+   /* Test eet cache system */
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   test = eet_read(ef, "keys/tests", &size);
+   fail_if(!test);
+   fail_if(size != (int) strlen(buffer) + 1);
+
+   fail_if(memcmp(test, buffer, strlen(buffer) + 1) != 0);
+
+   eet_close(ef);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_file_data_test)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Dictionary *ed;
+   Eet_File *ef;
+   char **list;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   int size;
+   int test;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY2, _eet_test_ex_set(NULL, 2));
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.ihash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
+   etbt.ihash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.ihash, EET_TEST_KEY2, &i7);
+   etbt.slist = eina_list_prepend(NULL, "test");
+   etbt.shash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.shash, EET_TEST_KEY1, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "test";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   fail_if(!(file = tmpnam(file)));
+
+   /* Insert an error in etbt. */
+   etbt.i = 0;
+
+   /* Save the encoded data in a file. */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+
+   result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
+   fail_if(!result);
+
+   fail_if(eet_mode_get(ef) != EET_FILE_MODE_READ_WRITE);
+
+   /* Test string space. */
+   ed = eet_dictionary_get(ef);
+
+   fail_if(!eet_dictionary_string_check(ed, result->str));
+   fail_if(eet_dictionary_string_check(ed, result->istr));
+
+   eet_close(ef);
+
+   /* Attempt to replace etbt by the correct one. */
+   etbt.i = EET_TEST_INT;
+
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+
+   eet_close(ef);
+
+   /* Read back the data. */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY2, &etbt, 0));
+
+   result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
+   fail_if(!result);
+
+   /* Test string space. */
+   ed = eet_dictionary_get(ef);
+   fail_if(!ed);
+
+   fail_if(!eet_dictionary_string_check(ed, result->str));
+   fail_if(eet_dictionary_string_check(ed, result->istr));
+
+   /* Test the resulting data. */
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(eina_list_data_get(result->ilist) == NULL);
+   fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
+   fail_if(eina_list_data_get(result->slist) == NULL);
+   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+   fail_if(eina_hash_find(result->shash, EET_TEST_KEY1) == NULL);
+   fail_if(strcmp(eina_hash_find(result->shash, EET_TEST_KEY1), "test") != 0);
+   fail_if(strcmp(result->charray[0], "test") != 0);
+
+   test = 0;
+   if (result->hash) eina_hash_foreach(result->hash, func, &test);
+   fail_if(test != 0);
+   if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
+   fail_if(test != 0);
+
+   list = eet_list(ef, "keys/*", &size);
+   fail_if(eet_num_entries(ef) != 2);
+   fail_if(size != 2);
+   fail_if(!(strcmp(list[0], EET_TEST_FILE_KEY1) == 0 && strcmp(list[1], EET_TEST_FILE_KEY2) == 0)
+	   && !(strcmp(list[0], EET_TEST_FILE_KEY2) == 0 && strcmp(list[1], EET_TEST_FILE_KEY1) == 0));
+   free(list);
+
+   fail_if(eet_delete(ef, NULL) != 0);
+   fail_if(eet_delete(NULL, EET_TEST_FILE_KEY1) != 0);
+   fail_if(eet_delete(ef, EET_TEST_FILE_KEY1) == 0);
+
+   list = eet_list(ef, "keys/*", &size);
+   fail_if(size != 1);
+   fail_if(eet_num_entries(ef) != 1);
+
+   /* Test some more wrong case */
+   fail_if(eet_data_read(ef, edd, "plop") != NULL);
+   fail_if(eet_data_read(ef, edd, EET_TEST_FILE_KEY1) != NULL);
+
+   /* Reinsert and reread data */
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   fail_if(eet_data_read(ef, edd, EET_TEST_FILE_KEY1) == NULL);
+   fail_if(eet_read_direct(ef, EET_TEST_FILE_KEY1, &size) == NULL);
+
+   eet_close(ef);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_file_data_arena)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result;
+   Eet_Data_Arena *arena;
+   Eet_Dictionary *ed;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   void *transfert;
+   int size;
+   int test;
+   int i;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.hash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
+   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
+   etbt.ihash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
+   etbt.slist = eina_list_prepend(NULL, "test");
+   etbt.shash = eina_hash_string_superfast_new(NULL);
+   eina_hash_add(etbt.shash, EET_TEST_KEY1, "test");
+   memset(&etbt.charray, 0, sizeof(etbt.charray));
+   etbt.charray[0] = "test";
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY2, &etbt, 1));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   ed = eet_dictionary_get(ef);
+   arena = eet_data_arena_new();
+   fail_if(!arena);
+
+   /* Stored raw and compressed, both end up in the same arena. */
+   for (i = 0; i < 2; ++i)
+     {
+	result = eet_data_read_arena(ef, edd, i ? EET_TEST_FILE_KEY2 : EET_TEST_FILE_KEY1, arena);
+	fail_if(!result);
+
+	fail_if(_eet_test_ex_check(result, 0) != 0);
+	fail_if(eina_list_count(result->list) != 2);
+	fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+	fail_if(eina_list_data_get(result->ilist) == NULL);
+	fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
+	fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
+	fail_if(strcmp(eina_hash_find(result->shash, EET_TEST_KEY1), "test") != 0);
+	fail_if(strcmp(result->charray[0], "test") != 0);
+
+	/* Dictionary strings are not copied. */
+	fail_if(!eet_dictionary_string_check(ed, result->str));
+
+	test = 0;
+	if (result->hash) eina_hash_foreach(result->hash, func, &test);
+	fail_if(test != 0);
+	if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
+	fail_if(test != 0);
+     }
+
+   eet_data_arena_free(arena);
+   eet_close(ef);
+
+   /* Decoding from memory copies the strings. */
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert || size <= 0);
+
+   arena = eet_data_arena_new();
+   result = eet_data_descriptor_decode_arena(edd, transfert, size, arena);
+   fail_if(!result);
+   memset(transfert, 0, size);
+   free(transfert);
+
+   fail_if(_eet_test_ex_check(result, 0) != 0);
+   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
+   fail_if(strcmp(result->charray[0], "test") != 0);
+
+   eet_data_arena_free(arena);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_file_data_borrow)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Test_Ex_Type *result[2];
+   Eet_Dictionary *ed;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   const char *raw;
+   int size;
+   int i;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
    etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
-   etbt.hash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
-   etbt.hash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.hash, EET_TEST_KEY2, _eet_test_ex_set(NULL, 2));
-   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
-   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
-   etbt.ihash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
-   etbt.ihash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.ihash, EET_TEST_KEY2, &i7);
    etbt.slist = eina_list_prepend(NULL, "test");
-   etbt.shash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.shash, EET_TEST_KEY1, "test");
-   memset(&etbt.charray, 0, sizeof(etbt.charray));
-   etbt.charray[0] = "test";
 
    eet_test_setup_eddc(&eddc);
    eddc.name = "Eet_Test_Ex_Type";
@@ -613,98 +2438,148 @@ START_TEST(eet_test_data_type_dump_undump)
    fail_if(!edd);
 
    _eet_build_ex_descriptor(edd);
+   fail_if(eet_data_descriptor_borrow_get(edd));
+   eet_data_descriptor_borrow_set(edd, EINA_TRUE);
+   fail_if(!eet_data_descriptor_borrow_get(edd));
 
-   transfert1 = eet_data_descriptor_encode(edd, &etbt, &size1);
-   fail_if(!transfert1 || size1 <= 0);
-
-   string1 = NULL;
-   eet_data_text_dump(transfert1, size1, append_string, &string1);
-   fail_if(!string1);
+   fail_if(!(file = tmpnam(file)));
 
-   transfert2 = eet_data_text_undump(string1, string1 ? strlen(string1) : 0, &size2);
-   fail_if(!transfert2 && size2 <= 0);
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY2, &etbt, 1));
+   eet_close(ef);
 
-   string2 = NULL;
-   eet_data_text_dump(transfert2, size2, append_string, &string2);
-   fail_if(!string2);
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
 
-   fail_if(strlen(string2) != strlen(string1));
+   ed = eet_dictionary_get(ef);
+   raw = eet_read_direct(ef, EET_TEST_FILE_KEY1, &size);
+   fail_if(!raw);
 
-   result = eet_data_descriptor_decode(edd, transfert2, size2);
-   fail_if(!result);
+   /* Stored raw and compressed, the later stays in memory. */
+   for (i = 0; i < 2; ++i)
+     {
+	result[i] = eet_data_read(ef, edd, i ? EET_TEST_FILE_KEY2 : EET_TEST_FILE_KEY1);
+	fail_if(!result[i]);
+	fail_if(!eet_dictionary_string_check(ed, result[i]->str));
+	fail_if(eet_dictionary_string_check(ed, result[i]->istr));
+     }
+   fail_if(result[0]->istr < raw || result[0]->istr >= raw + size);
 
-   fail_if(_eet_test_ex_check(result, 0) != 0);
-   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
-   fail_if(eina_list_data_get(result->ilist) == NULL);
-   fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
-   fail_if(eina_list_data_get(result->slist) == NULL);
-   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
-   fail_if(eina_hash_find(result->shash, EET_TEST_KEY1) == NULL);
-   fail_if(strcmp(eina_hash_find(result->shash, EET_TEST_KEY1), "test") != 0);
-   fail_if(strcmp(result->charray[0], "test") != 0);
+   /* The reads hold the file and its buffers. */
+   eet_close(ef);
+   for (i = 0; i < 2; ++i)
+     {
+	fail_if(_eet_test_ex_check(result[i], 0) != 0);
+	fail_if(_eet_test_ex_check(eina_list_data_get(result[i]->list), 1) != 0);
+	fail_if(strcmp(eina_list_data_get(result[i]->slist), "test") != 0);
+	eet_close(ef);
+     }
 
-   test = 0;
-   if (result->hash) eina_hash_foreach(result->hash, func, &test);
-   fail_if(test != 0);
-   if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
-   fail_if(test != 0);
+   fail_if(unlink(file) != 0);
 
    eet_shutdown();
 }
 END_TEST
 
-START_TEST(eet_file_simple_write)
+typedef struct _Eet_Test_Order Eet_Test_Order;
+struct _Eet_Test_Order
 {
-   const char *buffer = "Here is a string of data to save !";
+   int a;
+   const char *b;
+   double c;
+   int d;
+};
+
+static Eet_Data_Descriptor *
+_eet_test_order_descriptor(Eina_Bool reverse)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+
+   EET_EINA_FILE_DATA_DESCRIPTOR_CLASS_SET(&eddc, Eet_Test_Order);
+   edd = eet_data_descriptor_file_new(&eddc);
+
+   if (!reverse)
+     {
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "a", a, EET_T_INT);
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "b", b, EET_T_STRING);
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "c", c, EET_T_DOUBLE);
+     }
+   else
+     {
+	/* Other order and one more element. */
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "d", d, EET_T_INT);
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "c", c, EET_T_DOUBLE);
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "b", b, EET_T_STRING);
+	EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Test_Order, "a", a, EET_T_INT);
+     }
+
+   return edd;
+}
+
+START_TEST(eet_file_data_order)
+{
+   Eet_Data_Descriptor *writer;
+   Eet_Data_Descriptor *reader;
+   Eet_Test_Order order = { 42, "plouf", 3.5, 0 };
+   Eet_Test_Order *result;
    Eet_File *ef;
-   char *test;
    char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   void *transfert;
    int size;
+   int i;
 
    eet_init();
 
-   fail_if(!(file = tmpnam(file)));
+   writer = _eet_test_order_descriptor(EINA_FALSE);
+   reader = _eet_test_order_descriptor(EINA_TRUE);
 
-   fail_if(eet_mode_get(NULL) != EET_FILE_MODE_INVALID);
+   fail_if(!(file = tmpnam(file)));
 
    ef = eet_open(file, EET_FILE_MODE_WRITE);
    fail_if(!ef);
-
-   fail_if(!eet_write(ef, "keys/tests", buffer, strlen(buffer) + 1, 1));
-
-   fail_if(eet_mode_get(ef) != EET_FILE_MODE_WRITE);
-
-   fail_if(eet_list(ef, "*", &size) != NULL);
-   fail_if(eet_num_entries(ef) != -1);
-
+   fail_if(!eet_data_write(ef, writer, EET_TEST_FILE_KEY1, &order, 0));
    eet_close(ef);
 
-   /* Test read of simple file */
+   transfert = eet_data_descriptor_encode(writer, &order, &size);
+   fail_if(!transfert);
+
    ef = eet_open(file, EET_FILE_MODE_READ);
    fail_if(!ef);
 
-   test = eet_read(ef, "keys/tests", &size);
-   fail_if(!test);
-   fail_if(size != (int) strlen(buffer) + 1);
+   /* Decode several times so both descriptors have seen the stream. */
+   for (i = 0; i < 6; ++i)
+     {
+	if (i & 1)
+	  result = eet_data_descriptor_decode(i & 2 ? writer : reader, transfert, size);
+	else
+	  result = eet_data_read(ef, i & 2 ? writer : reader, EET_TEST_FILE_KEY1);
+	fail_if(!result);
 
-   fail_if(memcmp(test, buffer, strlen(buffer) + 1) != 0);
+	fail_if(result->a != 42);
+	fail_if(strcmp(result->b, "plouf") != 0);
+	fail_if(result->c != 3.5);
+	fail_if(result->d != 0);
 
-   fail_if(eet_mode_get(ef) != EET_FILE_MODE_READ);
-   fail_if(eet_num_entries(ef) != 1);
+	if (i & 1) eina_stringshare_del(result->b);
+	free(result);
+     }
 
    eet_close(ef);
 
-   /* Test eet cache system */
-   ef = eet_open(file, EET_FILE_MODE_READ);
-   fail_if(!ef);
-
-   test = eet_read(ef, "keys/tests", &size);
-   fail_if(!test);
-   fail_if(size != (int) strlen(buffer) + 1);
+   /* A member chunk claiming almost INT_MAX bytes is refused. */
+   i = 8 + strlen("Eet_Test_Order") + 1 + 4;
+   fail_if(i + 4 > size);
+   memcpy((char *)transfert + i, "\xfc\xff\xff\x7f", 4);
+   fail_if(eet_data_descriptor_decode(writer, transfert, size) != NULL);
+   fail_if(eet_data_descriptor_decode(reader, transfert, size) != NULL);
 
-   fail_if(memcmp(test, buffer, strlen(buffer) + 1) != 0);
+   free(transfert);
 
-   eet_close(ef);
+   eet_data_descriptor_free(writer);
+   eet_data_descriptor_free(reader);
 
    fail_if(unlink(file) != 0);
 
@@ -712,17 +2587,15 @@ START_TEST(eet_file_simple_write)
 }
 END_TEST
 
-START_TEST(eet_file_data_test)
+START_TEST(eet_file_data_dump_test)
 {
    Eet_Data_Descriptor *edd;
    Eet_Test_Ex_Type *result;
-   Eet_Dictionary *ed;
-   Eet_File *ef;
-   char **list;
-   char *file = strdup("/tmp/eet_suite_testXXXXXX");
    Eet_Data_Descriptor_Class eddc;
    Eet_Test_Ex_Type etbt;
-   int size;
+   Eet_File *ef;
+   char *string1;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
    int test;
 
    eet_init();
@@ -732,13 +2605,11 @@ START_TEST(eet_file_data_test)
    etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
    etbt.hash = eina_hash_string_superfast_new(NULL);
    eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
-   etbt.hash = eina_hash_string_superfast_new(NULL);
    eina_hash_add(etbt.hash, EET_TEST_KEY2, _eet_test_ex_set(NULL, 2));
    etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
    etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
    etbt.ihash = eina_hash_string_superfast_new(NULL);
    eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
-   etbt.ihash = eina_hash_string_superfast_new(NULL);
    eina_hash_add(etbt.ihash, EET_TEST_KEY2, &i7);
    etbt.slist = eina_list_prepend(NULL, "test");
    etbt.shash = eina_hash_string_superfast_new(NULL);
@@ -746,9 +2617,7 @@ START_TEST(eet_file_data_test)
    memset(&etbt.charray, 0, sizeof(etbt.charray));
    etbt.charray[0] = "test";
 
-   eet_test_setup_eddc(&eddc);
-   eddc.name = "Eet_Test_Ex_Type";
-   eddc.size = sizeof(Eet_Test_Ex_Type);
+   eet_eina_file_data_descriptor_class_set(&eddc, "Eet_Test_Ex_Type", sizeof(Eet_Test_Ex_Type));
 
    edd = eet_data_descriptor_file_new(&eddc);
    fail_if(!edd);
@@ -757,53 +2626,33 @@ START_TEST(eet_file_data_test)
 
    fail_if(!(file = tmpnam(file)));
 
-   /* Insert an error in etbt. */
-   etbt.i = 0;
-
    /* Save the encoded data in a file. */
-   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
    fail_if(!ef);
 
    fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
 
-   result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
-   fail_if(!result);
-
-   fail_if(eet_mode_get(ef) != EET_FILE_MODE_READ_WRITE);
-
-   /* Test string space. */
-   ed = eet_dictionary_get(ef);
-
-   fail_if(!eet_dictionary_string_check(ed, result->str));
-   fail_if(eet_dictionary_string_check(ed, result->istr));
-
    eet_close(ef);
 
-   /* Attempt to replace etbt by the correct one. */
-   etbt.i = EET_TEST_INT;
-
+   /* Use dump/undump in the middle */
    ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
    fail_if(!ef);
 
-   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   string1 = NULL;
+   fail_if(eet_data_dump(ef, EET_TEST_FILE_KEY1, append_string, &string1) != 1);
+   fail_if(eet_delete(ef, EET_TEST_FILE_KEY1) == 0);
+   fail_if(!eet_data_undump(ef, EET_TEST_FILE_KEY1, string1, strlen(string1), 1));
 
    eet_close(ef);
 
-   /* Read back the data. */
-   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   /* Test the correctness of the reinsertion. */
+   ef = eet_open(file, EET_FILE_MODE_READ);
    fail_if(!ef);
 
-   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY2, &etbt, 0));
-
    result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
    fail_if(!result);
 
-   /* Test string space. */
-   ed = eet_dictionary_get(ef);
-   fail_if(!ed);
-
-   fail_if(!eet_dictionary_string_check(ed, result->str));
-   fail_if(eet_dictionary_string_check(ed, result->istr));
+   eet_close(ef);
 
    /* Test the resulting data. */
    fail_if(_eet_test_ex_check(result, 0) != 0);
@@ -822,121 +2671,268 @@ START_TEST(eet_file_data_test)
    if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
    fail_if(test != 0);
 
-   list = eet_list(ef, "keys/*", &size);
-   fail_if(eet_num_entries(ef) != 2);
-   fail_if(size != 2);
-   fail_if(!(strcmp(list[0], EET_TEST_FILE_KEY1) == 0 && strcmp(list[1], EET_TEST_FILE_KEY2) == 0)
-	   && !(strcmp(list[0], EET_TEST_FILE_KEY2) == 0 && strcmp(list[1], EET_TEST_FILE_KEY1) == 0));
-   free(list);
+   fail_if(unlink(file) != 0);
 
-   fail_if(eet_delete(ef, NULL) != 0);
-   fail_if(eet_delete(NULL, EET_TEST_FILE_KEY1) != 0);
-   fail_if(eet_delete(ef, EET_TEST_FILE_KEY1) == 0);
+   eet_shutdown();
+}
+END_TEST
 
-   list = eet_list(ef, "keys/*", &size);
-   fail_if(size != 1);
-   fail_if(eet_num_entries(ef) != 1);
+typedef struct _Eet_Test_Walk Eet_Test_Walk;
+struct _Eet_Test_Walk
+{
+   int depth;
+   int structs;
+   int str;
+   int i;
+   int slist;
+   int hash;
+   int sarray2;
+   int stop;
+};
 
-   /* Test some more wrong case */
-   fail_if(eet_data_read(ef, edd, "plop") != NULL);
-   fail_if(eet_data_read(ef, edd, EET_TEST_FILE_KEY1) != NULL);
+static Eina_Bool
+_eet_test_walk_struct_begin(const char *name, int group_type, const char *key, const char *type, void *user_data)
+{
+   Eet_Test_Walk *walk = user_data;
 
-   /* Reinsert and reread data */
-   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
-   fail_if(eet_data_read(ef, edd, EET_TEST_FILE_KEY1) == NULL);
-   fail_if(eet_read_direct(ef, EET_TEST_FILE_KEY1, &size) == NULL);
+   if (group_type == EET_G_HASH && name && !strcmp(name, "hash")
+       && key && !strcmp(key, EET_TEST_KEY1) && walk->depth == 1)
+     walk->hash++;
+   if (!walk->depth && (name || !type || strcmp(type, "Eet_Test_Ex_Type")))
+     return EINA_FALSE;
 
-   eet_close(ef);
+   walk->depth++;
+   walk->structs++;
+   return EINA_TRUE;
+}
 
-   fail_if(unlink(file) != 0);
+static Eina_Bool
+_eet_test_walk_struct_end(const char *name __UNUSED__, void *user_data)
+{
+   Eet_Test_Walk *walk = user_data;
 
-   eet_shutdown();
+   walk->depth--;
+   return EINA_TRUE;
 }
-END_TEST
 
-START_TEST(eet_file_data_dump_test)
+static Eina_Bool
+_eet_test_walk_array_begin(Eina_Bool variable, const char *name, int count, void *user_data)
+{
+   Eet_Test_Walk *walk = user_data;
+
+   if (!variable && !strcmp(name, "sarray2") && count == 5 && walk->depth == 1)
+     walk->sarray2++;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eet_test_walk_simple(const char *name, int group_type, const char *key __UNUSED__, int type, Eet_Node_Data *data, void *user_data)
+{
+   Eet_Test_Walk *walk = user_data;
+
+   if (walk->depth != 1) return EINA_TRUE;
+
+   if (!strcmp(name, "str") && type == EET_T_STRING
+       && !strcmp(data->value.str, EET_TEST_STRING))
+     walk->str++;
+   if (!strcmp(name, "i") && type == EET_T_INT && data->value.i == EET_TEST_INT)
+     walk->i++;
+   if (!strcmp(name, "slist") && group_type == EET_G_LIST && type == EET_T_STRING
+       && !strcmp(data->value.str, "test"))
+     walk->slist++;
+
+   return --walk->stop != 0;
+}
+
+START_TEST(eet_test_data_walk)
 {
    Eet_Data_Descriptor *edd;
-   Eet_Test_Ex_Type *result;
    Eet_Data_Descriptor_Class eddc;
    Eet_Test_Ex_Type etbt;
+   Eet_Data_Walk cb;
+   Eet_Test_Walk walk;
    Eet_File *ef;
-   char *string1;
    char *file = strdup("/tmp/eet_suite_testXXXXXX");
-   int test;
+   void *transfert;
+   int size;
+   int i;
 
    eet_init();
 
    _eet_test_ex_set(&etbt, 0);
    etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
-   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
    etbt.hash = eina_hash_string_superfast_new(NULL);
    eina_hash_add(etbt.hash, EET_TEST_KEY1, _eet_test_ex_set(NULL, 2));
-   eina_hash_add(etbt.hash, EET_TEST_KEY2, _eet_test_ex_set(NULL, 2));
    etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
-   etbt.ilist = eina_list_prepend(etbt.ilist, &i42);
-   etbt.ihash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.ihash, EET_TEST_KEY1, &i7);
-   eina_hash_add(etbt.ihash, EET_TEST_KEY2, &i7);
    etbt.slist = eina_list_prepend(NULL, "test");
-   etbt.shash = eina_hash_string_superfast_new(NULL);
-   eina_hash_add(etbt.shash, EET_TEST_KEY1, "test");
    memset(&etbt.charray, 0, sizeof(etbt.charray));
    etbt.charray[0] = "test";
 
-   eet_eina_file_data_descriptor_class_set(&eddc, "Eet_Test_Ex_Type", sizeof(Eet_Test_Ex_Type));
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   memset(&cb, 0, sizeof (cb));
+   cb.struct_begin = _eet_test_walk_struct_begin;
+   cb.struct_end = _eet_test_walk_struct_end;
+   cb.array_begin = _eet_test_walk_array_begin;
+   cb.simple = _eet_test_walk_simple;
+
+   fail_if(!(file = tmpnam(file)));
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
+   eet_close(ef);
+
+   transfert = eet_data_descriptor_encode(edd, &etbt, &size);
+   fail_if(!transfert);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   /* Without then with a dictionary. */
+   for (i = 0; i < 2; ++i)
+     {
+	memset(&walk, 0, sizeof (walk));
+	if (i)
+	  fail_if(!eet_data_walk_read_cipher(ef, EET_TEST_FILE_KEY1, NULL, &cb, &walk));
+	else
+	  fail_if(!eet_data_walk_decode_cipher(transfert, NULL, size, &cb, &walk));
+
+	fail_if(walk.depth != 0);
+	/* the outer structure, one in the list, one in the hash, and the
+	 * basic ones in sarray1 and varray2 of the three of them */
+	fail_if(walk.structs < 3 + 3 * 20);
+	fail_if(walk.str != 1);
+	fail_if(walk.i != 1);
+	fail_if(walk.slist != 1);
+	fail_if(walk.hash != 1);
+	fail_if(walk.sarray2 != 1);
+     }
+
+   /* A callback stops the walk. */
+   memset(&walk, 0, sizeof (walk));
+   walk.stop = 2;
+   fail_if(eet_data_walk_decode_cipher(transfert, NULL, size, &cb, &walk));
+   fail_if(walk.depth != 1);
+
+   /* Truncated data is refused. */
+   memset(&walk, 0, sizeof (walk));
+   fail_if(eet_data_walk_decode_cipher(transfert, NULL, size / 2, &cb, &walk));
+
+   eet_close(ef);
+   free(transfert);
+
+   eet_data_descriptor_free(edd);
 
-   edd = eet_data_descriptor_file_new(&eddc);
-   fail_if(!edd);
+   fail_if(unlink(file) != 0);
 
-   _eet_build_ex_descriptor(edd);
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_file_checksum)
+{
+   const char *buffer = "Here is a string of data to save !";
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   char content[4096];
+   char big[1024];
+   const char *test;
+   Eet_File *ef;
+   char *found;
+   int size;
+   int fd;
+   int i;
+
+   eet_init();
+
+   memset(big, 'e', sizeof (big) - 1);
+   big[sizeof (big) - 1] = '\0';
 
    fail_if(!(file = tmpnam(file)));
 
-   /* Save the encoded data in a file. */
    ef = eet_open(file, EET_FILE_MODE_WRITE);
    fail_if(!ef);
+   fail_if(!eet_write(ef, "keys/raw", buffer, strlen(buffer) + 1, 0));
+   fail_if(!eet_write(ef, "keys/comp", big, sizeof (big), 1));
+   eet_close(ef);
 
-   fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, 0));
-
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   fail_if(eet_checksum_check(ef, "keys/raw") != EET_ERROR_NOT_CHECKSUMMED);
+   fail_if(eet_checksum_check(ef, "keys/none") != EET_ERROR_BAD_OBJECT);
    eet_close(ef);
 
-   /* Use dump/undump in the middle */
+   /* Add them to an existing file. */
    ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
    fail_if(!ef);
+   fail_if(eet_checksum_set(ef, EINA_TRUE) != EET_ERROR_NONE);
+   eet_close(ef);
+   eet_clearcache();
 
-   string1 = NULL;
-   fail_if(eet_data_dump(ef, EET_TEST_FILE_KEY1, append_string, &string1) != 1);
-   fail_if(eet_delete(ef, EET_TEST_FILE_KEY1) == 0);
-   fail_if(!eet_data_undump(ef, EET_TEST_FILE_KEY1, string1, strlen(string1), 1));
-
+   /* Rewriting the file keeps them. */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_write(ef, "keys/new", big, sizeof (big), 1));
    eet_close(ef);
+   eet_clearcache();
 
-   /* Test the correctness of the reinsertion. */
    ef = eet_open(file, EET_FILE_MODE_READ);
    fail_if(!ef);
+   fail_if(eet_checksum_check(ef, "keys/raw") != EET_ERROR_NONE);
+   fail_if(eet_checksum_check(ef, "keys/comp") != EET_ERROR_NONE);
+   fail_if(eet_checksum_check(ef, "keys/new") != EET_ERROR_NONE);
+   test = eet_read_direct(ef, "keys/raw", &size);
+   fail_if(!test);
+   fail_if(strcmp(test, buffer));
+   eet_close(ef);
+   eet_clearcache();
 
-   result = eet_data_read(ef, edd, EET_TEST_FILE_KEY1);
-   fail_if(!result);
+   /* Corrupt the uncompressed entry. */
+   fd = open(file, O_RDWR);
+   fail_if(fd < 0);
+   size = read(fd, content, sizeof (content));
+   fail_if(size <= 0);
 
-   eet_close(ef);
+   found = NULL;
+   for (i = 0; i + (int) strlen(buffer) <= size; i++)
+     if (!memcmp(content + i, buffer, strlen(buffer)))
+       {
+	  found = content + i;
+	  break;
+       }
+   fail_if(!found);
 
-   /* Test the resulting data. */
-   fail_if(_eet_test_ex_check(result, 0) != 0);
-   fail_if(_eet_test_ex_check(eina_list_data_get(result->list), 1) != 0);
-   fail_if(eina_list_data_get(result->ilist) == NULL);
-   fail_if(*((int*)eina_list_data_get(result->ilist)) != 42);
-   fail_if(eina_list_data_get(result->slist) == NULL);
-   fail_if(strcmp(eina_list_data_get(result->slist), "test") != 0);
-   fail_if(eina_hash_find(result->shash, EET_TEST_KEY1) == NULL);
-   fail_if(strcmp(eina_hash_find(result->shash, EET_TEST_KEY1), "test") != 0);
-   fail_if(strcmp(result->charray[0], "test") != 0);
+   fail_if(lseek(fd, found - content, SEEK_SET) != found - content);
+   fail_if(write(fd, "h", 1) != 1);
+   close(fd);
 
-   test = 0;
-   if (result->hash) eina_hash_foreach(result->hash, func, &test);
-   fail_if(test != 0);
-   if (result->ihash) eina_hash_foreach(result->ihash, func7, &test);
-   fail_if(test != 0);
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   fail_if(eet_checksum_check(ef, "keys/raw") != EET_ERROR_CHECKSUM_FAILED);
+   fail_if(eet_checksum_check(ef, "keys/comp") != EET_ERROR_NONE);
+   fail_if(eet_read_direct(ef, "keys/raw", &size));
+   fail_if(eet_read(ef, "keys/raw", &size));
+
+   test = eet_read(ef, "keys/comp", &size);
+   fail_if(!test);
+   fail_if(strcmp(test, big));
+   free((void *) test);
+
+   /* Without verification the damage goes through. */
+   eet_checksum_verify_set(EET_CHECKSUM_VERIFY_OFF);
+   fail_if(eet_checksum_verify_get() != EET_CHECKSUM_VERIFY_OFF);
+   test = eet_read_direct(ef, "keys/raw", &size);
+   fail_if(!test);
+   fail_if(!strcmp(test, buffer));
+   eet_checksum_verify_set(EET_CHECKSUM_VERIFY_FIRST_TOUCH);
+
+   eet_close(ef);
 
    fail_if(unlink(file) != 0);
 
@@ -1078,6 +3074,19 @@ START_TEST(eet_image)
    fail_if(data[0] != test_noalpha.color[0]);
    free(data);
 
+   result = eet_data_image_read_into(ef, EET_TEST_FILE_IMAGE "1", NULL, 0, &w, &h, &alpha, &compress, &quality, &lossy);
+   fail_if(result != (int) (test_noalpha.w * test_noalpha.h * 4));
+   fail_if(w != test_noalpha.w);
+   fail_if(h != test_noalpha.h);
+
+   data = malloc(result);
+   fail_if(data == NULL);
+   fail_if(eet_data_image_read_into(ef, EET_TEST_FILE_IMAGE "1", data, result, &w, &h, &alpha, &compress, &quality, &lossy) != result);
+   fail_if(compress != 5);
+   fail_if(lossy != 0);
+   fail_if(memcmp(data, test_noalpha.color, result) != 0);
+   free(data);
+
    data = eet_data_image_read(ef, EET_TEST_FILE_IMAGE "2", &w, &h, &alpha, &compress, &quality, &lossy);
    fail_if(data == NULL);
    fail_if(w != test_noalpha.w);
@@ -1286,6 +3295,109 @@ START_TEST(eet_identity_simple)
 }
 END_TEST
 
+START_TEST(eet_identity_cache)
+{
+   const char *buffer = "Here is a string of data to save !";
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   char *cache = strdup("/tmp/eet_suite_testXXXXXX");
+   struct stat st_cache;
+   struct utimbuf times;
+   struct stat st;
+   unsigned char digest[64];
+   const void *sha1;
+   Eet_File *ef;
+   Eet_Key *k;
+   int sha1_length;
+   int digest_length;
+   int fd;
+
+   eet_init();
+
+   fail_if(!(file = tmpnam(file)));
+   fail_if(!(cache = tmpnam(cache)));
+   fail_if(chdir("src/tests"));
+
+   /* Sign an eet file. */
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_write(ef, "keys/tests", buffer, strlen(buffer) + 1, 0));
+
+   k = eet_identity_open("cert.pem", "key.pem", NULL);
+   fail_if(!k);
+
+   fail_if(eet_identity_set(ef, k) != EET_ERROR_NONE);
+
+   eet_close(ef);
+   eet_identity_close(k);
+
+   /* The SHA1 of the file without any cache. */
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   sha1 = eet_identity_sha1(ef, &digest_length);
+   fail_if(!sha1);
+   fail_if(digest_length <= 0 || digest_length > (int) sizeof (digest));
+   memcpy(digest, sha1, digest_length);
+   eet_close(ef);
+   eet_clearcache();
+
+   /* The first open verify the file and remember it. */
+   fail_if(!eet_identity_cache_file_set(cache));
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   fail_if(!eet_identity_x509(ef, NULL));
+   eet_close(ef);
+   eet_clearcache();
+
+   fail_if(stat(cache, &st_cache) != 0);
+   fail_if(st_cache.st_size <= (int) sizeof (int));
+
+   /* A new process reuse the stored result. */
+   fail_if(!eet_identity_cache_set(EINA_FALSE));
+   fail_if(!eet_identity_cache_file_set(cache));
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   fail_if(!eet_identity_x509(ef, NULL));
+
+   /* Skipping the check doesn't change the SHA1. */
+   sha1 = eet_identity_sha1(ef, &sha1_length);
+   fail_if(!sha1);
+   fail_if(sha1_length != digest_length);
+   fail_if(memcmp(sha1, digest, digest_length) != 0);
+
+   eet_close(ef);
+   eet_clearcache();
+
+   fail_if(stat(cache, &st) != 0);
+   fail_if(st.st_size != st_cache.st_size);
+
+   /* Corrupt the file, even restoring its mtime doesn't hide it. */
+   fail_if(stat(file, &st) != 0);
+
+   fd = open(file, O_WRONLY);
+   fail_if(fd < 0);
+   fail_if(lseek(fd, 50, SEEK_SET) != 50);
+   fail_if(write(fd, "42", 2) != 2);
+   close(fd);
+
+   times.actime = st.st_atime;
+   times.modtime = st.st_mtime;
+   fail_if(utime(file, &times) != 0);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(ef);
+
+   fail_if(!eet_identity_cache_set(EINA_FALSE));
+
+   fail_if(unlink(file) != 0);
+   fail_if(unlink(cache) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
 START_TEST(eet_identity_open_simple)
 {
    Eet_Key *k = NULL;
@@ -1376,6 +3488,7 @@ START_TEST(eet_cipher_decipher_simple)
    Eet_File *ef;
    char *test;
    char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   char into[64];
    int size;
 
    eet_init();
@@ -1401,6 +3514,15 @@ START_TEST(eet_cipher_decipher_simple)
 
    fail_if(memcmp(test, buffer, strlen(buffer) + 1) != 0);
 
+   /* The clear size is what a caller buffer needs. */
+   size = strlen(buffer) + 1;
+   fail_if(eet_read_cipher_into(ef, "keys/tests", NULL, 0, key) != size);
+   fail_if(eet_read_cipher_into(ef, "keys/tests", into, size - 1, key) != size);
+   memset(into, 0, sizeof (into));
+   fail_if(eet_read_cipher_into(ef, "keys/tests", into, size, key) != size);
+   fail_if(memcmp(into, buffer, size) != 0);
+   fail_if(eet_read_cipher_into(ef, "keys/none", into, sizeof (into), key) != -1);
+
    eet_close(ef);
 
    /* Decrypt an eet file. */
@@ -1420,6 +3542,116 @@ START_TEST(eet_cipher_decipher_simple)
 }
 END_TEST
 
+START_TEST(eet_cipher_decipher_large)
+{
+   const char *key = "This is a crypto key";
+   unsigned int *buffer;
+   unsigned int i;
+   Eet_File *ef;
+   char *test;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   int length = 100000 * sizeof (unsigned int);
+   int size;
+
+   eet_init();
+
+   fail_if(!(file = tmpnam(file)));
+
+   /* Bigger than the decipher window, and compressible. */
+   buffer = malloc(length);
+   fail_if(!buffer);
+   for (i = 0; i < 100000; i++)
+     buffer[i] = (i * 7) % 1021;
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+
+   fail_if(!eet_write_cipher(ef, "keys/compressed", buffer, length, 1, key));
+   fail_if(!eet_write_cipher(ef, "keys/raw", buffer, length, 0, key));
+
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   test = eet_read_cipher(ef, "keys/compressed", &size, key);
+   fail_if(!test);
+   fail_if(size != length);
+   fail_if(memcmp(test, buffer, length) != 0);
+   free(test);
+
+   test = eet_read_cipher(ef, "keys/raw", &size, key);
+   fail_if(!test);
+   fail_if(size != length);
+   fail_if(memcmp(test, buffer, length) != 0);
+   free(test);
+
+   eet_close(ef);
+
+   fail_if(unlink(file) != 0);
+   free(buffer);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_cipher_decipher_keys)
+{
+   const char *buffer = "Here is a string of data to save !";
+   const char *key1 = "This is a crypto key";
+   const char *key2 = "This is another crypto key";
+   Eet_File *ef;
+   char *test;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   int size;
+   int i;
+
+   eet_init();
+
+   fail_if(!(file = tmpnam(file)));
+
+   /* The thread context switches key back and forth. */
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_write_cipher(ef, "keys/1", buffer, strlen(buffer) + 1, 0, key1));
+   fail_if(!eet_write_cipher(ef, "keys/2", buffer, strlen(buffer) + 1, 0, key2));
+   eet_close(ef);
+
+   for (i = 0; i < 2; i++)
+     {
+	ef = eet_open(file, EET_FILE_MODE_READ);
+	fail_if(!ef);
+
+	test = eet_read_cipher(ef, "keys/1", &size, key1);
+	fail_if(!test);
+	fail_if(size != (int) strlen(buffer) + 1);
+	fail_if(memcmp(test, buffer, size) != 0);
+	free(test);
+
+	test = eet_read_cipher(ef, "keys/2", &size, key2);
+	fail_if(!test);
+	fail_if(size != (int) strlen(buffer) + 1);
+	fail_if(memcmp(test, buffer, size) != 0);
+	free(test);
+
+	test = eet_read_cipher(ef, "keys/2", &size, key1);
+	if (test && size == (int) strlen(buffer) + 1)
+	  fail_if(memcmp(test, buffer, size) == 0);
+	free(test);
+
+	eet_close(ef);
+
+	/* The context is gone after a shutdown, and comes back. */
+	eet_shutdown();
+	eet_init();
+     }
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
 static Eina_Bool open_worker_stop;
 static void*
 open_close_worker(void* path)
@@ -1479,6 +3711,91 @@ START_TEST(eet_cache_concurrency)
 }
 END_TEST
 
+typedef struct _Eet_Test_Reader Eet_Test_Reader;
+struct _Eet_Test_Reader
+{
+   Eet_Data_Descriptor *edd;
+   Eet_File *ef;
+};
+
+static void*
+data_read_worker(void *data)
+{
+   Eet_Test_Reader *reader = data;
+   Eet_Test_Ex_Type *result;
+   int n;
+
+   for (n = 0; n < 500; ++n)
+     {
+	result = eet_data_read(reader->ef, reader->edd, EET_TEST_FILE_KEY1);
+	if (!result || _eet_test_ex_check(result, 0) != 0
+	    || _eet_test_ex_check(eina_list_data_get(result->list), 1) != 0)
+	  pthread_exit("eet_data_read() failed");
+     }
+
+   pthread_exit(NULL);
+}
+
+START_TEST(eet_data_descriptor_concurrency)
+{
+   Eet_Data_Descriptor *edd;
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Test_Ex_Type etbt;
+   Eet_Test_Reader readers[2];
+   pthread_t threads[2];
+   char *files[2];
+   void *thread_ret;
+   int i;
+
+   eet_init();
+
+   _eet_test_ex_set(&etbt, 0);
+   etbt.list = eina_list_prepend(etbt.list, _eet_test_ex_set(NULL, 1));
+   etbt.slist = eina_list_prepend(NULL, "test");
+
+   eet_test_setup_eddc(&eddc);
+   eddc.name = "Eet_Test_Ex_Type";
+   eddc.size = sizeof(Eet_Test_Ex_Type);
+
+   edd = eet_data_descriptor_file_new(&eddc);
+   fail_if(!edd);
+
+   _eet_build_ex_descriptor(edd);
+
+   /* One descriptor, two files with their own dictionary. */
+   for (i = 0; i < 2; ++i)
+     {
+	Eet_File *ef;
+
+	files[i] = strdup("/tmp/eet_suite_testXXXXXX");
+	fail_if(!(files[i] = tmpnam(files[i])));
+
+	ef = eet_open(files[i], EET_FILE_MODE_WRITE);
+	fail_if(!ef);
+	fail_if(!eet_data_write(ef, edd, EET_TEST_FILE_KEY1, &etbt, i));
+	eet_close(ef);
+
+	readers[i].edd = edd;
+	readers[i].ef = eet_open(files[i], EET_FILE_MODE_READ);
+	fail_if(!readers[i].ef);
+     }
+
+   for (i = 0; i < 2; ++i)
+     fail_if(pthread_create(&threads[i], NULL, data_read_worker, &readers[i]) != 0);
+
+   for (i = 0; i < 2; ++i)
+     {
+	fail_if(pthread_join(threads[i], &thread_ret) != 0);
+	fail_unless(thread_ret == NULL, (char const*)thread_ret);
+
+	eet_close(readers[i].ef);
+	fail_if(unlink(files[i]) != 0);
+     }
+
+   eet_shutdown();
+}
+END_TEST
+
 typedef struct _Eet_Connection_Data Eet_Connection_Data;
 struct _Eet_Connection_Data
 {
@@ -2195,7 +4512,21 @@ eet_suite(void)
    tc = tcase_create("Eet Data Encoding/Decoding");
    tcase_add_test(tc, eet_test_basic_data_type_encoding_decoding);
    tcase_add_test(tc, eet_test_data_type_encoding_decoding);
+   tcase_add_test(tc, eet_test_data_stream);
+   tcase_add_test(tc, eet_test_data_compact);
+   tcase_add_test(tc, eet_test_data_previous_version);
+   tcase_add_test(tc, eet_test_data_packed_array);
+   tcase_add_test(tc, eet_test_swap);
+   tcase_add_test(tc, eet_test_data_columnar);
+   tcase_add_test(tc, eet_test_data_float_ieee);
+   tcase_add_test(tc, eet_test_data_lazy);
+   tcase_add_test(tc, eet_test_data_block);
+   tcase_add_test(tc, eet_test_data_decode_error);
+   tcase_add_test(tc, eet_test_data_many_members);
    tcase_add_test(tc, eet_test_data_type_dump_undump);
+   tcase_add_test(tc, eet_test_data_text_dump_stream);
+   tcase_add_test(tc, eet_test_data_text_undump_parse);
+   tcase_add_test(tc, eet_test_data_json_dump_undump);
    tcase_add_test(tc, eet_fp);
    tcase_add_test(tc, eet_test_union);
    tcase_add_test(tc, eet_test_variant);
@@ -2204,8 +4535,13 @@ eet_suite(void)
    tc = tcase_create("Eet File");
    tcase_add_test(tc, eet_file_simple_write);
    tcase_add_test(tc, eet_file_data_test);
+   tcase_add_test(tc, eet_file_data_arena);
+   tcase_add_test(tc, eet_file_data_borrow);
+   tcase_add_test(tc, eet_file_data_order);
    tcase_add_test(tc, eet_file_data_dump_test);
+   tcase_add_test(tc, eet_test_data_walk);
    tcase_add_test(tc, eet_file_fp);
+   tcase_add_test(tc, eet_file_checksum);
    suite_add_tcase(s, tc);
 
    tc = tcase_create("Eet Image");
@@ -2216,6 +4552,7 @@ eet_suite(void)
 #ifdef HAVE_SIGNATURE
    tc = tcase_create("Eet Identity");
    tcase_add_test(tc, eet_identity_simple);
+   tcase_add_test(tc, eet_identity_cache);
    tcase_add_test(tc, eet_identity_open_simple);
    tcase_add_test(tc, eet_identity_open_pkcs8);
    tcase_add_test(tc, eet_identity_open_pkcs8_enc);
@@ -2225,11 +4562,14 @@ eet_suite(void)
 #ifdef HAVE_CIPHER
    tc = tcase_create("Eet Cipher");
    tcase_add_test(tc, eet_cipher_decipher_simple);
+   tcase_add_test(tc, eet_cipher_decipher_large);
+   tcase_add_test(tc, eet_cipher_decipher_keys);
    suite_add_tcase(s, tc);
 #endif
 
    tc = tcase_create("Eet Cache");
    tcase_add_test(tc, eet_cache_concurrency);
+   tcase_add_test(tc, eet_data_descriptor_concurrency);
    suite_add_tcase(s, tc);
 
    tc = tcase_create("Eet Connection");